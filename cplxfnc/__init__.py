@@ -1,3 +1,22 @@
 from .cplxfnc_cyth import py_zeta as zeta
 from .cplxfnc_cyth import py_gamma_inc as gamma_inc
-from .cplxfnc_cyth import py_u_asymp as u_asymp
\ No newline at end of file
+from .cplxfnc_cyth import py_u_asymp as u_asymp
+from .cplxfnc_cyth import py_zeta_jet_s as zeta_jet_s
+from .cplxfnc_cyth import py_zeta_jet_a as zeta_jet_a
+from .cplxfnc_cyth import py_gamma_inc_jet_s as gamma_inc_jet_s
+from .cplxfnc_cyth import py_gamma_inc_jet_z as gamma_inc_jet_z
+from .cplxfnc_cyth import py_zeta_sequence as zeta_sequence
+from .cplxfnc_cyth import py_gamma_inc_sequence as gamma_inc_sequence
+from .cplxfnc_cyth import py_gamma_inc_path as gamma_inc_path
+from .cplxfnc_cyth import py_u_asymp_path as u_asymp_path
+from .cplxfnc_cyth import py_zeta_dd as zeta_dd
+from .cplxfnc_cyth import py_gamma_inc_dd as gamma_inc_dd
+from .cplxfnc_cyth import py_u_asymp_dd as u_asymp_dd
+from .cplxfnc_cyth import py_zeta_estimate as zeta_estimate
+from .cplxfnc_cyth import py_gamma_inc_estimate as gamma_inc_estimate
+from .cplxfnc_cyth import py_u_asymp_estimate as u_asymp_estimate
+from .cplxfnc_cyth import zeta_ufunc, gamma_inc_ufunc, u_asymp_ufunc, masked
+from .cplxfnc_cyth import zeta_dd_ufunc, gamma_inc_dd_ufunc, u_asymp_dd_ufunc
+from .cplxfnc_cyth import zeta_atol_ufunc, gamma_inc_atol_ufunc, u_asymp_atol_ufunc
+from .cplxfnc_cyth import stats, reset_stats
+from .cplxfnc_cyth import enable_trace, disable_trace, trace_events
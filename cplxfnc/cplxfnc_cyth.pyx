@@ -1,18 +1,568 @@
 cimport cython
+cimport numpy as cnp
+from libc.stddef cimport ptrdiff_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+import numpy as np
+
+cnp.import_array()
+cnp.import_ufunc()
 
 cdef extern from "stdbool.h":
     ctypedef char bool
 
 cdef extern from "../cplxfnc_clib/cplxfnc.hpp" namespace "cplxfnc":
-    double complex zeta(double complex s, double complex a, double tol, unsigned int limit, bool verbose) except +
-    double complex gamma_inc(double complex s, double complex z, double tol, unsigned int limit, bool verbose) except +
-    double complex u_asymp(double complex a, double complex b, double complex z, double tol, unsigned int limit, bool verbose) except +
+    cppclass PrecisionPredictor:
+        pass
+    cppclass EscalationPolicy:
+        pass
+    cppclass ResultCache:
+        pass
+    cppclass FastPath:
+        pass
+    cppclass StopToken:
+        pass
+
+    double complex zeta(double complex s, double complex a, double tol, unsigned int limit, bool verbose,
+                        unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                        EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                        double atol=*) except +
+    double complex gamma_inc(double complex s, double complex z, double tol, unsigned int limit, bool verbose,
+                             unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                             EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                             double atol=*) except +
+    double complex u_asymp(double complex a, double complex b, double complex z, double tol, unsigned int limit, bool verbose,
+                           unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                           EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                           double atol=*) except +
+
+    size_t zeta_batch(size_t n, const double complex * s, ptrdiff_t s_stride,
+                      const double complex * a, ptrdiff_t a_stride,
+                      double complex * res, ptrdiff_t res_stride,
+                      int * status, ptrdiff_t status_stride,
+                      double tol, unsigned int limit, bool verbose, unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                      EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                      double atol=*) nogil
+    size_t gamma_inc_batch(size_t n, const double complex * s, ptrdiff_t s_stride,
+                           const double complex * z, ptrdiff_t z_stride,
+                           double complex * res, ptrdiff_t res_stride,
+                           int * status, ptrdiff_t status_stride,
+                           double tol, unsigned int limit, bool verbose, unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                           EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                           double atol=*) nogil
+    size_t u_asymp_batch(size_t n, const double complex * a, ptrdiff_t a_stride,
+                         const double complex * b, ptrdiff_t b_stride,
+                         const double complex * z, ptrdiff_t z_stride,
+                         double complex * res, ptrdiff_t res_stride,
+                         int * status, ptrdiff_t status_stride,
+                         double tol, unsigned int limit, bool verbose, unsigned int init_prec=*, PrecisionPredictor * predictor=*,
+                         EscalationPolicy * policy=*, ResultCache * cache=*, FastPath * fast=*, StopToken * stop=*,
+                         double atol=*) nogil
+
+    size_t zeta_dd_batch(size_t n, const double complex * s, ptrdiff_t s_stride,
+                         const double complex * a, ptrdiff_t a_stride,
+                         double complex * hi, ptrdiff_t hi_stride,
+                         double complex * lo, ptrdiff_t lo_stride,
+                         int * status, ptrdiff_t status_stride,
+                         double tol, unsigned int limit, bool verbose) nogil
+    size_t gamma_inc_dd_batch(size_t n, const double complex * s, ptrdiff_t s_stride,
+                              const double complex * z, ptrdiff_t z_stride,
+                              double complex * hi, ptrdiff_t hi_stride,
+                              double complex * lo, ptrdiff_t lo_stride,
+                              int * status, ptrdiff_t status_stride,
+                              double tol, unsigned int limit, bool verbose) nogil
+    size_t u_asymp_dd_batch(size_t n, const double complex * a, ptrdiff_t a_stride,
+                            const double complex * b, ptrdiff_t b_stride,
+                            const double complex * z, ptrdiff_t z_stride,
+                            double complex * hi, ptrdiff_t hi_stride,
+                            double complex * lo, ptrdiff_t lo_stride,
+                            int * status, ptrdiff_t status_stride,
+                            double tol, unsigned int limit, bool verbose) nogil
+
+    cppclass Settings:
+        Settings(double tol, unsigned int limit, bool verbose) except +
+    vector[double complex] zeta_jet_s(double complex s, double complex a, unsigned int n, const Settings & settings) except +
+    vector[double complex] zeta_jet_a(double complex s, double complex a, unsigned int n, const Settings & settings) except +
+    vector[double complex] gamma_inc_jet_s(double complex s, double complex z, unsigned int n, const Settings & settings) except +
+    vector[double complex] gamma_inc_jet_z(double complex s, double complex z, unsigned int n, const Settings & settings) except +
+    vector[double complex] zeta_sequence(double complex s, double complex a, size_t n, const Settings & settings) except +
+    vector[double complex] gamma_inc_sequence(double complex s, double complex z, size_t n, const Settings & settings) except +
+    vector[double complex] gamma_inc_path(double complex s, const vector[double complex] & z, const Settings & settings) except +
+    vector[double complex] u_asymp_path(double complex a, double complex b, const vector[double complex] & z, const Settings & settings) except +
+
+    struct CostEstimate:
+        int status
+        unsigned int prec
+        unsigned int attempts
+        double cost
+    CostEstimate zeta_estimate(double complex s, double complex a, const Settings & settings)
+    CostEstimate gamma_inc_estimate(double complex s, double complex z, const Settings & settings)
+    CostEstimate u_asymp_estimate(double complex a, double complex b, double complex z, const Settings & settings)
+
+    cppclass TraceEvent:
+        pass
+    cppclass TraceSink:
+        TraceSink(size_t capacity)
+        bint pop(TraceEvent * ev)
+        unsigned long dropped()
+    void set_trace_sink(TraceSink * sink)
+    string format_event(const TraceEvent & ev)
+
+cdef extern from "../cplxfnc_clib/cplxfnc.hpp":
+    enum:
+        ZETA_DEFAULT_INIT_PREC
+        GAMMA_INC_DEFAULT_INIT_PREC
+        U_ASYMP_DEFAULT_INIT_PREC
+        CPLXFNC_STATS_ZETA
+        CPLXFNC_STATS_GAMMA_INC
+        CPLXFNC_STATS_U_ASYMP
+        CPLXFNC_PREC_BINS
+        CPLXFNC_SPECIAL_KINDS
 
-def py_zeta(double complex s, double complex a, double tol=1e-16, unsigned int limit=5, bool verbose=False):
-    return zeta(s, a, tol, limit, verbose)
+    struct cplxfnc_stats:
+        unsigned long long calls
+        unsigned long long arb_evals
+        unsigned long long escalations
+        unsigned long long limit_failures
+        unsigned long long value_errors
+        unsigned long long arb_ns
+        unsigned long long prec_hist[CPLXFNC_PREC_BINS]
+        unsigned long long special[CPLXFNC_SPECIAL_KINDS]
 
-def py_gamma_inc(double complex s, double complex z, double tol=1e-16, unsigned int limit=5, bool verbose=False):
-    return gamma_inc(s, z, tol, limit, verbose)
+    int cplxfnc_stats_read(int function, cplxfnc_stats * stats)
+    void cplxfnc_stats_reset()
+
+def py_zeta(double complex s, double complex a, double tol=1e-16, unsigned int limit=5, bool verbose=False,
+            double atol=0):
+    return zeta(s, a, tol, limit, verbose, ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, atol)
+
+def py_gamma_inc(double complex s, double complex z, double tol=1e-16, unsigned int limit=5, bool verbose=False,
+                 double atol=0):
+    return gamma_inc(s, z, tol, limit, verbose, GAMMA_INC_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, atol)
     
-def py_u_asymp(double complex a, double complex b, double complex z, double tol=1e-16, unsigned int limit=5, bool verbose=False):
-    return u_asymp(a, b, z, tol, limit, verbose)    
+def py_u_asymp(double complex a, double complex b, double complex z, double tol=1e-16, unsigned int limit=5, bool verbose=False,
+               double atol=0):
+    return u_asymp(a, b, z, tol, limit, verbose, U_ASYMP_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, atol)
+
+_dd_errors = {-1: "LIMIT ERROR: {} reached the limit", -2: "VALUE ERROR: {} can not be evaluated for these arguments"}
+
+def _dd_result(name, int status, double complex hi, double complex lo):
+    if status:
+        raise RuntimeError(_dd_errors[status].format(name))
+    return hi, lo
+
+def py_zeta_dd(double complex s, double complex a, double tol=1e-32, unsigned int limit=5):
+    """zeta(s, a) as double-double, returns (hi, lo) with zeta = hi + lo per component"""
+    cdef double complex hi, lo
+    cdef int status
+    zeta_dd_batch(1, &s, 0, &a, 0, &hi, 0, &lo, 0, &status, 0, tol, limit, False)
+    return _dd_result("zeta_dd", status, hi, lo)
+
+def py_gamma_inc_dd(double complex s, double complex z, double tol=1e-32, unsigned int limit=5):
+    """gamma_inc(s, z) as double-double, returns (hi, lo) with gamma_inc = hi + lo per component"""
+    cdef double complex hi, lo
+    cdef int status
+    gamma_inc_dd_batch(1, &s, 0, &z, 0, &hi, 0, &lo, 0, &status, 0, tol, limit, False)
+    return _dd_result("gamma_inc_dd", status, hi, lo)
+
+def py_u_asymp_dd(double complex a, double complex b, double complex z, double tol=1e-32, unsigned int limit=5):
+    """u_asymp(a, b, z) as double-double, returns (hi, lo) with u_asymp = hi + lo per component"""
+    cdef double complex hi, lo
+    cdef int status
+    u_asymp_dd_batch(1, &a, 0, &b, 0, &z, 0, &hi, 0, &lo, 0, &status, 0, tol, limit, False)
+    return _dd_result("u_asymp_dd", status, hi, lo)
+
+
+# ##################################################
+# ##     derivatives
+# ##
+# ##     [f, df/dx, ..., d^n f/dx^n] where x is the argument in the name
+# ##################################################
+
+def py_zeta_jet_s(double complex s, double complex a, unsigned int n=1, double tol=1e-16, unsigned int limit=5):
+    return zeta_jet_s(s, a, n, Settings(tol, limit, False))
+
+def py_zeta_jet_a(double complex s, double complex a, unsigned int n=1, double tol=1e-16, unsigned int limit=5):
+    return zeta_jet_a(s, a, n, Settings(tol, limit, False))
+
+def py_gamma_inc_jet_s(double complex s, double complex z, unsigned int n=1, double tol=1e-16, unsigned int limit=5):
+    return gamma_inc_jet_s(s, z, n, Settings(tol, limit, False))
+
+def py_gamma_inc_jet_z(double complex s, double complex z, unsigned int n=1, double tol=1e-16, unsigned int limit=5):
+    return gamma_inc_jet_z(s, z, n, Settings(tol, limit, False))
+
+
+# ##################################################
+# ##     sequences
+# ##################################################
+
+def py_zeta_sequence(double complex s, double complex a, size_t n, double tol=1e-16, unsigned int limit=5):
+    """zeta(s, a+k) for k = 0 ... n-1 as numpy array, from few arb evaluations and the recurrence in a"""
+    return np.asarray(zeta_sequence(s, a, n, Settings(tol, limit, False)))
+
+def py_gamma_inc_sequence(double complex s, double complex z, size_t n, double tol=1e-16, unsigned int limit=5):
+    """gamma_inc(s+k, z) for k = 0 ... n-1 as numpy array, from few arb evaluations and the recurrence in s"""
+    return np.asarray(gamma_inc_sequence(s, z, n, Settings(tol, limit, False)))
+
+
+# ##################################################
+# ##     path continuation
+# ##################################################
+
+def py_gamma_inc_path(double complex s, z, double tol=1e-16, unsigned int limit=5):
+    """gamma_inc(s, z[k]) for nearby points z[k] (in order) as numpy array, by Taylor steps in z between few arb evaluations"""
+    return np.asarray(gamma_inc_path(s, np.asarray(z, dtype=np.complex128).ravel(), Settings(tol, limit, False)))
+
+def py_u_asymp_path(double complex a, double complex b, z, double tol=1e-16, unsigned int limit=5):
+    """u_asymp(a, b, z[k]) for nearby points z[k] (in order) as numpy array, by Taylor steps in z between few arb evaluations"""
+    return np.asarray(u_asymp_path(a, b, np.asarray(z, dtype=np.complex128).ravel(), Settings(tol, limit, False)))
+
+
+# ##################################################
+# ##     cost estimates
+# ##
+# ##     a cheap guess (no arb evaluation) of the final precision, the number of
+# ##     attempts and the cost relative to one attempt at the initial precision
+# ##################################################
+
+cdef _estimate(CostEstimate e):
+    return {'status': e.status, 'prec': e.prec, 'attempts': e.attempts, 'cost': e.cost}
+
+def py_zeta_estimate(double complex s, double complex a, double tol=1e-16, unsigned int limit=5):
+    """estimate for zeta(s, a), status -1 if the limit is expected to be reached and -2 for a value error"""
+    return _estimate(zeta_estimate(s, a, Settings(tol, limit, False)))
+
+def py_gamma_inc_estimate(double complex s, double complex z, double tol=1e-16, unsigned int limit=5):
+    """estimate for gamma_inc(s, z), status as for zeta_estimate"""
+    return _estimate(gamma_inc_estimate(s, z, Settings(tol, limit, False)))
+
+def py_u_asymp_estimate(double complex a, double complex b, double complex z, double tol=1e-16, unsigned int limit=5):
+    """estimate for u_asymp(a, b, z), status as for zeta_estimate"""
+    return _estimate(u_asymp_estimate(a, b, z, Settings(tol, limit, False)))
+
+# ##################################################
+# ##     instrumentation counters
+# ##################################################
+
+_stats_functions = {'zeta': CPLXFNC_STATS_ZETA, 'gamma_inc': CPLXFNC_STATS_GAMMA_INC, 'u_asymp': CPLXFNC_STATS_U_ASYMP}
+
+def stats(function):
+    """
+    the counters of function ('zeta', 'gamma_inc' or 'u_asymp') summed over all threads since
+    the last reset_stats(): calls, arb evaluations, escalations, limit failures, value errors,
+    the time spent in arb (arb_ns) and the histogram of the final precision, where prec_hist[k]
+    counts the successful evaluations with final precision in (2^(k-1), 2^k], and the calls
+    answered by a closed form: special[k] for zeta(s, 1) and zeta(n, a) with integer n and
+    (half-)integer a (k = 0, 1), for gamma_inc(s, 0), gamma_inc(1, z) and gamma_inc(n, z)
+    with integer n (k = 0, 1, 2)
+    """
+    cdef cplxfnc_stats st
+    if cplxfnc_stats_read(_stats_functions[function], &st) != 0:
+        raise ValueError("unknown function {}".format(function))
+    return {'calls': st.calls, 'arb_evals': st.arb_evals, 'escalations': st.escalations,
+            'limit_failures': st.limit_failures, 'value_errors': st.value_errors,
+            'arb_ns': st.arb_ns, 'prec_hist': [st.prec_hist[k] for k in range(CPLXFNC_PREC_BINS)],
+            'special': [st.special[k] for k in range(CPLXFNC_SPECIAL_KINDS)]}
+
+def reset_stats():
+    """reset the counters of all functions"""
+    cplxfnc_stats_reset()
+
+
+# ##################################################
+# ##     diagnostics
+# ##
+# ##     the library does no I/O, limit failures, value errors and (verbose=True)
+# ##     the arb attempts are recorded in a ring buffer once enable_trace was called
+# ##################################################
+
+# the sinks are never freed, ufuncs running without the GIL in other threads
+# may still push into a sink after it was disabled or replaced, a larger
+# capacity adds a new sink (the sizes double, so at most twice the largest)
+cdef TraceSink * _sink = NULL
+cdef size_t _sink_capacity = 0
+cdef unsigned long _dropped_base = 0
+_trace_enabled = False
+
+cdef void _clear_sink():
+    cdef TraceEvent ev
+    global _dropped_base
+    while _sink.pop(&ev):
+        pass
+    _dropped_base = _sink.dropped()
+
+def enable_trace(size_t capacity=4096):
+    """record the diagnostics of all functions in a ring buffer holding (at least) capacity events"""
+    global _sink, _sink_capacity, _trace_enabled
+    set_trace_sink(NULL)
+    if _sink == NULL or capacity > _sink_capacity:
+        _sink = new TraceSink(capacity)
+        _sink_capacity = capacity
+    _clear_sink()
+    set_trace_sink(_sink)
+    _trace_enabled = True
+
+def disable_trace():
+    """stop recording, buffered events are discarded"""
+    global _trace_enabled
+    set_trace_sink(NULL)
+    _trace_enabled = False
+    if _sink != NULL:
+        _clear_sink()
+
+def trace_events():
+    """
+    remove the recorded events from the buffer and return them as list of strings,
+    together with the number of events dropped since enable_trace because the buffer was full
+    """
+    cdef TraceEvent ev
+    events = []
+    if not _trace_enabled:
+        return events, 0
+    while _sink.pop(&ev):
+        events.append(format_event(ev).decode())
+    return events, _sink.dropped() - _dropped_base
+
+
+# ##################################################
+# ##     numpy ufuncs
+# ##
+# ##     the inner loops hand whole (strided) chunks to the batch functions
+# ##     of the c++ library, numpy runs them with the GIL released
+# ##     (the loops are declared with const dims/steps as numpy >= 2 does and
+# ##     cast to PyUFuncGenericFunction)
+# ##################################################
+
+cdef inline unsigned int _limit(long limit) noexcept nogil:
+    return <unsigned int> limit if limit > 0 else 0
+
+cdef void _zeta_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, a, tol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0:
+        zeta_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                   <double complex *> args[4], steps[4], <int *> args[5], steps[5],
+                   (<double *> args[2])[0], _limit((<long *> args[3])[0]), False)
+        return
+    for i in range(n):
+        zeta_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                   <double complex *> (args[4] + i*steps[4]), 0, <int *> (args[5] + i*steps[5]), 0,
+                   (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[3] + i*steps[3]))[0]), False)
+
+cdef void _gamma_inc_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, z, tol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0:
+        gamma_inc_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                        <double complex *> args[4], steps[4], <int *> args[5], steps[5],
+                        (<double *> args[2])[0], _limit((<long *> args[3])[0]), False)
+        return
+    for i in range(n):
+        gamma_inc_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                        <double complex *> (args[4] + i*steps[4]), 0, <int *> (args[5] + i*steps[5]), 0,
+                        (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[3] + i*steps[3]))[0]), False)
+
+cdef void _u_asymp_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: a, b, z, tol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[3] == 0 and steps[4] == 0:
+        u_asymp_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                      <double complex *> args[2], steps[2], <double complex *> args[5], steps[5],
+                      <int *> args[6], steps[6],
+                      (<double *> args[3])[0], _limit((<long *> args[4])[0]), False)
+        return
+    for i in range(n):
+        u_asymp_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                      <double complex *> (args[2] + i*steps[2]), 0, <double complex *> (args[5] + i*steps[5]), 0,
+                      <int *> (args[6] + i*steps[6]), 0,
+                      (<double *> (args[3] + i*steps[3]))[0], _limit((<long *> (args[4] + i*steps[4]))[0]), False)
+
+cdef void _zeta_dd_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, a, tol, limit -> hi, lo, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0:
+        zeta_dd_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                      <double complex *> args[4], steps[4], <double complex *> args[5], steps[5],
+                      <int *> args[6], steps[6],
+                      (<double *> args[2])[0], _limit((<long *> args[3])[0]), False)
+        return
+    for i in range(n):
+        zeta_dd_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                      <double complex *> (args[4] + i*steps[4]), 0, <double complex *> (args[5] + i*steps[5]), 0,
+                      <int *> (args[6] + i*steps[6]), 0,
+                      (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[3] + i*steps[3]))[0]), False)
+
+cdef void _gamma_inc_dd_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, z, tol, limit -> hi, lo, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0:
+        gamma_inc_dd_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                           <double complex *> args[4], steps[4], <double complex *> args[5], steps[5],
+                           <int *> args[6], steps[6],
+                           (<double *> args[2])[0], _limit((<long *> args[3])[0]), False)
+        return
+    for i in range(n):
+        gamma_inc_dd_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                           <double complex *> (args[4] + i*steps[4]), 0, <double complex *> (args[5] + i*steps[5]), 0,
+                           <int *> (args[6] + i*steps[6]), 0,
+                           (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[3] + i*steps[3]))[0]), False)
+
+cdef void _u_asymp_dd_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: a, b, z, tol, limit -> hi, lo, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[3] == 0 and steps[4] == 0:
+        u_asymp_dd_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                         <double complex *> args[2], steps[2], <double complex *> args[5], steps[5],
+                         <double complex *> args[6], steps[6], <int *> args[7], steps[7],
+                         (<double *> args[3])[0], _limit((<long *> args[4])[0]), False)
+        return
+    for i in range(n):
+        u_asymp_dd_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                         <double complex *> (args[2] + i*steps[2]), 0, <double complex *> (args[5] + i*steps[5]), 0,
+                         <double complex *> (args[6] + i*steps[6]), 0, <int *> (args[7] + i*steps[7]), 0,
+                         (<double *> (args[3] + i*steps[3]))[0], _limit((<long *> (args[4] + i*steps[4]))[0]), False)
+
+cdef void _zeta_atol_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, a, tol, atol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0 and steps[4] == 0:
+        zeta_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                   <double complex *> args[5], steps[5], <int *> args[6], steps[6],
+                   (<double *> args[2])[0], _limit((<long *> args[4])[0]), False,
+                   ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> args[3])[0])
+        return
+    for i in range(n):
+        zeta_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                   <double complex *> (args[5] + i*steps[5]), 0, <int *> (args[6] + i*steps[6]), 0,
+                   (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[4] + i*steps[4]))[0]), False,
+                   ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> (args[3] + i*steps[3]))[0])
+
+cdef void _gamma_inc_atol_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: s, z, tol, atol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[2] == 0 and steps[3] == 0 and steps[4] == 0:
+        gamma_inc_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                        <double complex *> args[5], steps[5], <int *> args[6], steps[6],
+                        (<double *> args[2])[0], _limit((<long *> args[4])[0]), False,
+                        GAMMA_INC_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> args[3])[0])
+        return
+    for i in range(n):
+        gamma_inc_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                        <double complex *> (args[5] + i*steps[5]), 0, <int *> (args[6] + i*steps[6]), 0,
+                        (<double *> (args[2] + i*steps[2]))[0], _limit((<long *> (args[4] + i*steps[4]))[0]), False,
+                        GAMMA_INC_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> (args[3] + i*steps[3]))[0])
+
+cdef void _u_asymp_atol_loop(char ** args, const cnp.npy_intp * dims, const cnp.npy_intp * steps, void * data) noexcept nogil:
+    # args: a, b, z, tol, atol, limit -> res, status
+    cdef cnp.npy_intp i, n = dims[0]
+    if steps[3] == 0 and steps[4] == 0 and steps[5] == 0:
+        u_asymp_batch(n, <double complex *> args[0], steps[0], <double complex *> args[1], steps[1],
+                      <double complex *> args[2], steps[2], <double complex *> args[6], steps[6],
+                      <int *> args[7], steps[7],
+                      (<double *> args[3])[0], _limit((<long *> args[5])[0]), False,
+                      U_ASYMP_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> args[4])[0])
+        return
+    for i in range(n):
+        u_asymp_batch(1, <double complex *> (args[0] + i*steps[0]), 0, <double complex *> (args[1] + i*steps[1]), 0,
+                      <double complex *> (args[2] + i*steps[2]), 0, <double complex *> (args[6] + i*steps[6]), 0,
+                      <int *> (args[7] + i*steps[7]), 0,
+                      (<double *> (args[3] + i*steps[3]))[0], _limit((<long *> (args[5] + i*steps[5]))[0]), False,
+                      U_ASYMP_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, (<double *> (args[4] + i*steps[4]))[0])
+
+cdef cnp.PyUFuncGenericFunction _zeta_loops[1]
+cdef cnp.PyUFuncGenericFunction _gamma_inc_loops[1]
+cdef cnp.PyUFuncGenericFunction _u_asymp_loops[1]
+cdef void * _ufunc_data[1]
+cdef char _zeta_types[6]
+cdef char _u_asymp_types[7]
+cdef cnp.PyUFuncGenericFunction _zeta_dd_loops[1]
+cdef cnp.PyUFuncGenericFunction _gamma_inc_dd_loops[1]
+cdef cnp.PyUFuncGenericFunction _u_asymp_dd_loops[1]
+cdef char _zeta_dd_types[7]
+cdef char _u_asymp_dd_types[8]
+cdef cnp.PyUFuncGenericFunction _zeta_atol_loops[1]
+cdef cnp.PyUFuncGenericFunction _gamma_inc_atol_loops[1]
+cdef cnp.PyUFuncGenericFunction _u_asymp_atol_loops[1]
+cdef char _zeta_atol_types[7]
+cdef char _u_asymp_atol_types[8]
+
+_zeta_loops[0] = <cnp.PyUFuncGenericFunction> _zeta_loop
+_gamma_inc_loops[0] = <cnp.PyUFuncGenericFunction> _gamma_inc_loop
+_u_asymp_loops[0] = <cnp.PyUFuncGenericFunction> _u_asymp_loop
+_zeta_dd_loops[0] = <cnp.PyUFuncGenericFunction> _zeta_dd_loop
+_gamma_inc_dd_loops[0] = <cnp.PyUFuncGenericFunction> _gamma_inc_dd_loop
+_u_asymp_dd_loops[0] = <cnp.PyUFuncGenericFunction> _u_asymp_dd_loop
+_zeta_atol_loops[0] = <cnp.PyUFuncGenericFunction> _zeta_atol_loop
+_gamma_inc_atol_loops[0] = <cnp.PyUFuncGenericFunction> _gamma_inc_atol_loop
+_u_asymp_atol_loops[0] = <cnp.PyUFuncGenericFunction> _u_asymp_atol_loop
+_ufunc_data[0] = NULL
+_zeta_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG, cnp.NPY_CDOUBLE, cnp.NPY_INT]
+_u_asymp_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG,
+                     cnp.NPY_CDOUBLE, cnp.NPY_INT]
+_zeta_dd_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG,
+                     cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_INT]
+_u_asymp_dd_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG,
+                        cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_INT]
+_zeta_atol_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG,
+                       cnp.NPY_CDOUBLE, cnp.NPY_INT]
+_u_asymp_atol_types[:] = [cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_CDOUBLE, cnp.NPY_DOUBLE, cnp.NPY_DOUBLE, cnp.NPY_LONG,
+                          cnp.NPY_CDOUBLE, cnp.NPY_INT]
+
+zeta_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _zeta_loops, _ufunc_data, _zeta_types, 1, 4, 2, cnp.PyUFunc_None, "zeta_ufunc",
+    "zeta_ufunc(s, a, tol, limit) -> (res, status)\n\n"
+    "Hurwitz zeta function, status is 0 on success, -1 if the limit was reached.", 0)
+
+gamma_inc_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _gamma_inc_loops, _ufunc_data, _zeta_types, 1, 4, 2, cnp.PyUFunc_None, "gamma_inc_ufunc",
+    "gamma_inc_ufunc(s, z, tol, limit) -> (res, status)\n\n"
+    "upper incomplete gamma function, status is 0 on success, -1 if the limit was reached\n"
+    "and -2 if Re(s) < 0 and z = 0.", 0)
+
+u_asymp_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _u_asymp_loops, _ufunc_data, _u_asymp_types, 1, 5, 2, cnp.PyUFunc_None, "u_asymp_ufunc",
+    "u_asymp_ufunc(a, b, z, tol, limit) -> (res, status)\n\n"
+    "asymptotic series for U(a, b, z), status is 0 on success, -1 if the limit was reached\n"
+    "and -2 if z is too small for the given tol.", 0)
+
+zeta_dd_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _zeta_dd_loops, _ufunc_data, _zeta_dd_types, 1, 4, 3, cnp.PyUFunc_None, "zeta_dd_ufunc",
+    "zeta_dd_ufunc(s, a, tol, limit) -> (hi, lo, status)\n\n"
+    "Hurwitz zeta function as double-double hi + lo (per component), use tol=1e-32 for\n"
+    "the full accuracy. status as for zeta_ufunc.", 0)
+
+gamma_inc_dd_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _gamma_inc_dd_loops, _ufunc_data, _zeta_dd_types, 1, 4, 3, cnp.PyUFunc_None, "gamma_inc_dd_ufunc",
+    "gamma_inc_dd_ufunc(s, z, tol, limit) -> (hi, lo, status)\n\n"
+    "upper incomplete gamma function as double-double hi + lo (per component), use tol=1e-32\n"
+    "for the full accuracy. status as for gamma_inc_ufunc.", 0)
+
+u_asymp_dd_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _u_asymp_dd_loops, _ufunc_data, _u_asymp_dd_types, 1, 5, 3, cnp.PyUFunc_None, "u_asymp_dd_ufunc",
+    "u_asymp_dd_ufunc(a, b, z, tol, limit) -> (hi, lo, status)\n\n"
+    "asymptotic series for U(a, b, z) as double-double hi + lo (per component), use tol=1e-32\n"
+    "for the full accuracy. status as for u_asymp_ufunc.", 0)
+
+
+zeta_atol_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _zeta_atol_loops, _ufunc_data, _zeta_atol_types, 1, 5, 2, cnp.PyUFunc_None, "zeta_atol_ufunc",
+    "zeta_atol_ufunc(s, a, tol, atol, limit) -> (res, status)\n\n"
+    "Hurwitz zeta function accepting a relative error tol or an absolute error atol, status is\n"
+    "0 if tol was met, 1 if only atol was met and negative as for zeta_ufunc on failure.", 0)
+
+gamma_inc_atol_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _gamma_inc_atol_loops, _ufunc_data, _zeta_atol_types, 1, 5, 2, cnp.PyUFunc_None, "gamma_inc_atol_ufunc",
+    "gamma_inc_atol_ufunc(s, z, tol, atol, limit) -> (res, status)\n\n"
+    "upper incomplete gamma function accepting a relative error tol or an absolute error atol,\n"
+    "status is 0 if tol was met, 1 if only atol was met and negative as for gamma_inc_ufunc on failure.", 0)
+
+u_asymp_atol_ufunc = cnp.PyUFunc_FromFuncAndData(
+    _u_asymp_atol_loops, _ufunc_data, _u_asymp_atol_types, 1, 6, 2, cnp.PyUFunc_None, "u_asymp_atol_ufunc",
+    "u_asymp_atol_ufunc(a, b, z, tol, atol, limit) -> (res, status)\n\n"
+    "asymptotic series for U(a, b, z) accepting a relative error tol or an absolute error atol,\n"
+    "status is 0 if tol was met, 1 if only atol was met and negative as for u_asymp_ufunc on failure.", 0)
+
+def masked(res, status):
+    """combine the (res, status) output of the ufuncs to a masked array, failed points are masked"""
+    return np.ma.masked_array(res, mask=(np.asarray(status) < 0))
@@ -23,6 +23,7 @@
  */
 
 #include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
 
 #include "acb.h"
 #include "arb.h"
@@ -34,9 +35,10 @@ static_assert(__FLINT_VERSION == 2, "requires flint version 2");
 
 #include <complex>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
-#include <iostream>
-#include <iomanip>
+#include <sstream>
 #include <string>
 
 extern "C" {
@@ -45,6 +47,144 @@ extern "C" {
 
 namespace cplxfnc {
 
+namespace detail {
+
+Config::Config(double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+               PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache,
+               FastPath * fast, StopToken * stop, double atol)
+    : tol(tol), err_bits_ref(slong(log2(tol))), limit(limit), verbose(verbose), init_prec(init_prec),
+      predictor(predictor), policy(policy), cache(cache), fast(fast), stop(stop), trace(NULL), atol(atol)
+{}
+
+Config::Config(const Settings & settings, unsigned int default_init_prec)
+    : Config(settings.tol, settings.limit, settings.verbose,
+             settings.init_prec ? settings.init_prec : default_init_prec,
+             settings.predictor, settings.policy, settings.cache, settings.fast, settings.stop, settings.atol)
+{
+    trace = settings.trace;
+}
+
+unsigned int Config::start_prec(std::complex<double> x) const
+{
+    if (predictor != NULL) {
+        unsigned int prec = predictor->predict(x);
+        if (prec > init_prec) return prec;
+    }
+    return init_prec;
+}
+
+void Config::record(std::complex<double> x, unsigned int prec) const
+{
+    if (predictor != NULL) {
+        predictor->record(x, prec);
+    }
+}
+
+unsigned int Config::next_prec(unsigned int prec, slong err_bits) const
+{
+    if (policy != NULL) {
+        return policy->next_prec(prec, err_bits, err_bits_ref);
+    }
+    return 2*prec;
+}
+
+int Config::accept(const acb_t x, slong err_bits) const
+{
+    if (err_bits <= err_bits_ref) return 0;
+    if (atol > 0) {
+        mag_t r;
+        mag_init(r);
+        mag_hypot(r, arb_radref(acb_realref(x)), arb_radref(acb_imagref(x)));
+        const bool ok = mag_get_d(r) <= atol;
+        mag_clear(r);
+        if (ok) return ATOL_MET;
+    }
+    return -1;
+}
+
+int Config::accept(const arb_t x, slong err_bits) const
+{
+    if (err_bits <= err_bits_ref) return 0;
+    if ((atol > 0) && (mag_get_d(arb_radref(x)) <= atol)) return ATOL_MET;
+    return -1;
+}
+
+bool Config::stop_requested(unsigned int prec, unsigned int next_prec, std::uint64_t last_ns) const
+{
+    if (stop == NULL) return false;
+    const double r = double(next_prec) / prec;
+    const std::chrono::nanoseconds expected(std::uint64_t(r * r * last_ns));
+    return stop->stop_requested(std::chrono::steady_clock::now() + expected);
+}
+
+void Config::count(unsigned int attempts, bool success) const
+{
+    if (policy != NULL) {
+        policy->count(attempts, success);
+    }
+}
+
+void Config::emit(int kind, const char * function, const std::complex<double> * args, unsigned int n_args,
+                  unsigned int prec, slong err_bits, unsigned int attempt) const
+{
+    TraceSink * sink = (trace != NULL) ? trace : trace_sink();
+    if (sink == NULL) return;
+    TraceEvent ev;
+    ev.function = function;
+    ev.kind = kind;
+    for (unsigned int i = 0; i < n_args; i++) ev.args[i] = args[i];
+    ev.n_args = n_args;
+    ev.prec = prec;
+    ev.err_bits = err_bits;
+    ev.err_bits_ref = err_bits_ref;
+    ev.attempt = attempt;
+    sink->push(ev);
+}
+
+ZetaWorkspace::ZetaWorkspace() : prec(0), attempts(0), err_bits(WORD_MAX), shortcut(false) { acb_init(z); acb_init(s); acb_init(a); }
+ZetaWorkspace::~ZetaWorkspace() { acb_clear(z); acb_clear(s); acb_clear(a); }
+
+GammaIncWorkspace::GammaIncWorkspace() : prec(0), attempts(0), err_bits(WORD_MAX), shortcut(false) { acb_init(res); acb_init(s); acb_init(z); }
+GammaIncWorkspace::~GammaIncWorkspace() { acb_clear(res); acb_clear(s); acb_clear(z); }
+
+UAsympWorkspace::UAsympWorkspace() : prec(0), attempts(0), err_bits(WORD_MAX), shortcut(false) { acb_init(res); acb_init(a); acb_init(b); acb_init(z); }
+UAsympWorkspace::~UAsympWorkspace() { acb_clear(res); acb_clear(a); acb_clear(b); acb_clear(z); }
+
+} /* namespace detail */
+
+Settings::Settings(double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                   PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache,
+                   FastPath * fast, StopToken * stop, double atol)
+    : tol(tol), limit(limit), verbose(verbose), init_prec(init_prec),
+      predictor(predictor), policy(policy), cache(cache), fast(fast), stop(stop), trace(NULL), atol(atol)
+{}
+
+StopToken::StopToken() : is_cancelled(false), deadline(std::numeric_limits<long long>::max()) {}
+
+StopToken::StopToken(std::chrono::steady_clock::duration timeout)
+    : is_cancelled(false), deadline((std::chrono::steady_clock::now() + timeout).time_since_epoch().count())
+{}
+
+void StopToken::cancel() { is_cancelled.store(true, std::memory_order_relaxed); }
+
+void StopToken::set_deadline(std::chrono::steady_clock::time_point deadline)
+{
+    this->deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void StopToken::reset()
+{
+    is_cancelled.store(false, std::memory_order_relaxed);
+    deadline.store(std::numeric_limits<long long>::max(), std::memory_order_relaxed);
+}
+
+bool StopToken::cancelled() const { return is_cancelled.load(std::memory_order_relaxed); }
+
+bool StopToken::stop_requested(std::chrono::steady_clock::time_point t) const
+{
+    return cancelled() || (t.time_since_epoch().count() > deadline.load(std::memory_order_relaxed));
+}
+
 // ##################################################
 // ##     Hurwitz Zeta function
 // ##################################################
@@ -54,63 +194,161 @@ std::complex<double> zeta(std::complex<double> s, std::complex<double> a)
     return zeta(s, a, 1e-16, 5, false);
 }
 
-std::complex<double> zeta(std::complex<double> s, std::complex<double> a, double tol, unsigned int limit, bool verbose, unsigned int init_prec)
+namespace {
+
+// res, or the exception for the return code status
+std::complex<double> zeta_result(int status, std::complex<double> res, std::complex<double> s, std::complex<double> a)
 {
-    std::complex<double> res;
-    int status = zeta(s, a, &res, tol, limit, verbose, init_prec);
-    if (status) {
+    if (status < 0) {
         std::ostringstream oss;
-        oss << "LIMIT ERROR: zeta s=" << s << " and a=" << a;
+        if (status == STOPPED) {
+            oss << "STOPPED: zeta s=" << s << " and a=" << a << " (deadline or cancellation)";
+        } else {
+            oss << "LIMIT ERROR: zeta s=" << s << " and a=" << a;
+        }
         throw std::runtime_error(oss.str());
-    } else {
-        return res;
     }
+    return res;
+}
+
+} /* namespace */
+
+std::complex<double> zeta(std::complex<double> s, std::complex<double> a, double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+         PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol)
+{
+    std::complex<double> res;
+    int status = zeta(s, a, &res, tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+    return zeta_result(status, res, s, a);
+}
+
+// the workspace lives on the stack, no evaluator is allocated
+int zeta(std::complex<double> s, std::complex<double> a, std::complex<double> * res, double * rel_err,
+         const Settings & settings)
+{
+    detail::ZetaWorkspace ws;
+    const int status = detail::zeta(ws, s, a, res, detail::Config(settings, ZETA_DEFAULT_INIT_PREC));
+    if (rel_err != NULL) *rel_err = detail::rel_error(status, ws.shortcut, ws.err_bits, settings.tol);
+    return status;
 }
 
 int zeta(std::complex<double> s, std::complex<double> a, std::complex<double> * res, double tol,
-         unsigned int limit, bool verbose, unsigned int init_prec)
+         unsigned int limit, bool verbose, unsigned int init_prec,
+         PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol)
 {
-    acb_t _z, _s, _a;
-    acb_init(_z); acb_init(_s); acb_init(_a);
-    acb_set_d_d(_s, s.real(), s.imag());
-    acb_set_d_d(_a, a.real(), a.imag());
+    return zeta(s, a, res, NULL, Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+ZetaEvaluator::ZetaEvaluator(const Settings & settings) : impl(new Impl(settings)) {}
+ZetaEvaluator::~ZetaEvaluator() { delete impl; }
+
+const Settings & ZetaEvaluator::settings() const { return impl->settings; }
+unsigned int ZetaEvaluator::last_prec() const { return impl->ws.prec; }
+unsigned int ZetaEvaluator::last_attempts() const { return impl->ws.attempts; }
+double ZetaEvaluator::last_rel_error() const
+{
+    return detail::rel_error(impl->ws.shortcut, impl->ws.err_bits, impl->settings.tol);
+}
+
+void ZetaEvaluator::set_settings(const Settings & settings)
+{
+    impl->settings = settings;
+    impl->cfg = detail::Config(settings, ZETA_DEFAULT_INIT_PREC);
+}
+
+std::complex<double> ZetaEvaluator::operator()(std::complex<double> s, std::complex<double> a)
+{
+    std::complex<double> res;
+    int status = (*this)(s, a, &res);
+    return zeta_result(status, res, s, a);
+}
+
+int ZetaEvaluator::operator()(std::complex<double> s, std::complex<double> a, std::complex<double> * res)
+{
+    return detail::zeta(impl->ws, s, a, res, impl->cfg);
+}
+
+int detail::zeta(ZetaWorkspace & ws, std::complex<double> s, std::complex<double> a,
+                 std::complex<double> * res, const Config & cfg, bool fast_tried)
+{
+    ws.prec = ws.attempts = 0;
+    ws.err_bits = WORD_MAX;
+    ws.shortcut = false;
+    FunctionStats & stats = thread_stats().fn[STATS_ZETA];
+    stats.add(FunctionStats::CALLS);
+    const std::complex<double> args[2] = {s, a};
+    if ((cfg.cache != NULL) && cfg.cache->lookup(CACHE_ZETA, args, 2, cfg.tol, res)) {
+        ws.shortcut = true;
+        return 0;
+    }
+    if (cfg.fast != NULL) {
+        bool ok = false;
+        if (!fast_tried) zeta_fast(1, &s, &a, cfg.err_bits_ref, res, &ok);
+        cfg.fast->count(ok);
+        if (ok) {
+            ws.shortcut = true;
+            return 0;
+        }
+    }
+
+    acb_set_d_d(ws.s, s.real(), s.imag());
+    acb_set_d_d(ws.a, a.real(), a.imag());
+
+    const int special = zeta_special(s, a);
+    if (special != SPECIAL_NONE) stats.add(FunctionStats::SPECIAL + special);
 
-    unsigned int prec = init_prec;
+    unsigned int prec = cfg.start_prec(a);
     unsigned int c = 1;
     double zeta_re, zeta_im;
-    slong err_bits, err_bits_ref;
-    err_bits_ref = slong(log2(tol));
+    slong err_bits;
 
     while (1) {
-        acb_hurwitz_zeta(_z, _s, _a, prec);
-
-        err_bits =  acb_rel_error_bits(_z);
-        if (verbose) {
-            std::cerr << std::setprecision(1) << std::fixed <<
-            "zeta(s, a) with s=" << s << " and a=" << a << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
-        }        
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (special != SPECIAL_NONE) {
+            zeta_special_eval(ws.z, special, s, ws.s, a, prec);
+        } else {
+            acb_hurwitz_zeta(ws.z, ws.s, ws.a, prec);
+        }
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+        ws.prec = prec;
+        ws.attempts = c;
+
+        err_bits =  acb_rel_error_bits(ws.z);
+        ws.err_bits = err_bits;
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, "zeta", args, 2, prec, err_bits, c);
         
-        if (err_bits <= err_bits_ref) {
-            zeta_re = arf_get_d(arb_midref(acb_realref(_z)), ARF_RND_NEAR);
-            zeta_im = arf_get_d(arb_midref(acb_imagref(_z)), ARF_RND_NEAR);
-            acb_clear(_z); acb_clear(_s); acb_clear(_a);
+        const int accepted = cfg.accept(ws.z, err_bits);
+        if (accepted >= 0) {
+            zeta_re = arf_get_d(arb_midref(acb_realref(ws.z)), ARF_RND_NEAR);
+            zeta_im = arf_get_d(arb_midref(acb_imagref(ws.z)), ARF_RND_NEAR);
             *res = std::complex<double>(zeta_re, zeta_im);
-            return 0;
+            if (accepted == 0) {
+                if (cfg.cache != NULL) cfg.cache->insert(CACHE_ZETA, args, 2, cfg.tol, *res);
+                cfg.record(a, prec);
+            }
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return accepted;
         }
-        prec *= 2;
-        c += 1;
-        if (c > limit) {
-            std::cerr << "\nERROR: limit (" << limit << ") reached\n" <<
-            std::setprecision(1) << std::fixed <<
-            "zeta(s, a) with s=" << s << " and a=" << a << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
+        if (c >= cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c, false);
+            cfg.emit(TRACE_LIMIT, "zeta", args, 2, prec, err_bits, c);
             return -1;
         }
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            zeta_re = arf_get_d(arb_midref(acb_realref(ws.z)), ARF_RND_NEAR);
+            zeta_im = arf_get_d(arb_midref(acb_imagref(ws.z)), ARF_RND_NEAR);
+            *res = std::complex<double>(zeta_re, zeta_im);
+            cfg.count(c, false);
+            cfg.emit(TRACE_STOPPED, "zeta", args, 2, prec, err_bits, c);
+            return STOPPED;
+        }
+        prec = next_prec;
+        c += 1;
+        stats.add(FunctionStats::ESCALATIONS);
     }
 }
 
@@ -123,12 +361,12 @@ std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z)
     return gamma_inc(s, z, 1e-16, 5, false);
 }
 
-std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z, double tol,
-                               unsigned int limit, bool verbose, unsigned int init_prec)
+namespace {
+
+// res, or the exception for the return code status
+std::complex<double> gamma_inc_result(int status, std::complex<double> res, std::complex<double> s, std::complex<double> z)
 {
-    std::complex<double> res;
-    int status = gamma_inc(s, z, &res, tol, limit, verbose, init_prec);
-    if (status) {
+    if (status < 0) {
         std::ostringstream oss;
         if (status == -1) {
             oss << "LIMIT ERROR: gamma_inc s=" << s << " and z=" << z;
@@ -136,66 +374,163 @@ std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z, d
         } else if (status == -2) {
             oss << "VALUE ERROR: gamma_inc, if Re(s) < 0 then z must not be zero!";
             throw std::runtime_error(oss.str());
+        } else if (status == STOPPED) {
+            oss << "STOPPED: gamma_inc s=" << s << " and z=" << z << " (deadline or cancellation)";
+            throw std::runtime_error(oss.str());
         } else {
             oss << "gamma_inc unknown error: error code: " << status;
             throw std::runtime_error(oss.str());
         }
-    } else {
-        return res;        
     }
+    return res;
+}
+
+} /* namespace */
+
+std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z, double tol,
+                               unsigned int limit, bool verbose, unsigned int init_prec,
+                               PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache,
+                               FastPath * fast, StopToken * stop, double atol)
+{
+    std::complex<double> res;
+    int status = gamma_inc(s, z, &res, tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+    return gamma_inc_result(status, res, s, z);
+}
+
+// the workspace lives on the stack, no evaluator is allocated
+int gamma_inc(std::complex<double> s, std::complex<double> z, std::complex<double> * res, double * rel_err,
+              const Settings & settings)
+{
+    detail::GammaIncWorkspace ws;
+    const int status = detail::gamma_inc(ws, s, z, res, detail::Config(settings, GAMMA_INC_DEFAULT_INIT_PREC));
+    if (rel_err != NULL) *rel_err = detail::rel_error(status, ws.shortcut, ws.err_bits, settings.tol);
+    return status;
 }
 
 int gamma_inc(std::complex<double> s, std::complex<double> z, std::complex<double> * res, double tol,
-         unsigned int limit, bool verbose, unsigned int init_prec)
+         unsigned int limit, bool verbose, unsigned int init_prec,
+         PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol)
+{
+    return gamma_inc(s, z, res, NULL, Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+GammaIncEvaluator::GammaIncEvaluator(const Settings & settings) : impl(new Impl(settings)) {}
+GammaIncEvaluator::~GammaIncEvaluator() { delete impl; }
+
+const Settings & GammaIncEvaluator::settings() const { return impl->settings; }
+unsigned int GammaIncEvaluator::last_prec() const { return impl->ws.prec; }
+unsigned int GammaIncEvaluator::last_attempts() const { return impl->ws.attempts; }
+double GammaIncEvaluator::last_rel_error() const
+{
+    return detail::rel_error(impl->ws.shortcut, impl->ws.err_bits, impl->settings.tol);
+}
+
+void GammaIncEvaluator::set_settings(const Settings & settings)
+{
+    impl->settings = settings;
+    impl->cfg = detail::Config(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+}
+
+std::complex<double> GammaIncEvaluator::operator()(std::complex<double> s, std::complex<double> z)
+{
+    std::complex<double> res;
+    int status = (*this)(s, z, &res);
+    return gamma_inc_result(status, res, s, z);
+}
+
+int GammaIncEvaluator::operator()(std::complex<double> s, std::complex<double> z, std::complex<double> * res)
+{
+    return detail::gamma_inc(impl->ws, s, z, res, impl->cfg);
+}
+
+int detail::gamma_inc(GammaIncWorkspace & ws, std::complex<double> s, std::complex<double> z,
+                      std::complex<double> * res, const Config & cfg, bool fast_tried)
 {
+    ws.prec = ws.attempts = 0;
+    ws.err_bits = WORD_MAX;
+    ws.shortcut = false;
+    FunctionStats & stats = thread_stats().fn[STATS_GAMMA_INC];
+    stats.add(FunctionStats::CALLS);
     if ((s.real() < 0) && (z.real() == 0) && (z.imag() == 0)){
-        if (verbose) {
-            std::cerr << "ERROR: inc gamma value error!\n" <<
-            "if Re(s) < 0 then z must not be zero!\n";
-        }
+        const std::complex<double> args[2] = {s, z};
+        cfg.emit(TRACE_VALUE_ERROR, "gamma_inc", args, 2, 0, 0, 0);
+        stats.add(FunctionStats::VALUE_ERRORS);
         return -2;
     }
-    acb_t _z, _s, _res;
-    acb_init(_z); acb_init(_s); acb_init(_res);
-    acb_set_d_d(_s, s.real(), s.imag());
-    acb_set_d_d(_z, z.real(), z.imag());
+    const std::complex<double> args[2] = {s, z};
+    if ((cfg.cache != NULL) && cfg.cache->lookup(CACHE_GAMMA_INC, args, 2, cfg.tol, res)) {
+        ws.shortcut = true;
+        return 0;
+    }
+    if (cfg.fast != NULL) {
+        bool ok = false;
+        if (!fast_tried) gamma_inc_fast(1, &s, &z, cfg.err_bits_ref, res, &ok);
+        cfg.fast->count(ok);
+        if (ok) {
+            ws.shortcut = true;
+            return 0;
+        }
+    }
+
+    acb_set_d_d(ws.s, s.real(), s.imag());
+    acb_set_d_d(ws.z, z.real(), z.imag());
 
-    unsigned int prec = init_prec;
+    const int special = gamma_inc_special(s, z);
+    if (special != SPECIAL_NONE) stats.add(FunctionStats::SPECIAL + special);
+
+    unsigned int prec = cfg.start_prec(z);
     unsigned int c = 1;
     double res_re, res_im;
-    slong err_bits, err_bits_ref;
-    err_bits_ref = slong(log2(tol));
+    slong err_bits;
 
     while (1) {
-        acb_hypgeom_gamma_upper(_res, _s, _z, 0, prec);   //
-        
-        err_bits =  acb_rel_error_bits(_res);
-        if (verbose) {
-            std::cout << std::setprecision(1) << std::fixed <<
-            "gamma(s, z) with s=" << s << " and z=" << z << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (special != SPECIAL_NONE) {
+            gamma_inc_special_eval(ws.res, special, s, ws.s, ws.z, prec);
+        } else {
+            acb_hypgeom_gamma_upper(ws.res, ws.s, ws.z, 0, prec);
         }
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+        ws.prec = prec;
+        ws.attempts = c;
         
-        if (err_bits <= err_bits_ref) {
-            res_re     = arf_get_d(arb_midref(acb_realref(_res)), ARF_RND_NEAR);
-            res_im     = arf_get_d(arb_midref(acb_imagref(_res)), ARF_RND_NEAR);
-            acb_clear(_res); acb_clear(_s); acb_clear(_z);
+        err_bits =  acb_rel_error_bits(ws.res);
+        ws.err_bits = err_bits;
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, "gamma_inc", args, 2, prec, err_bits, c);
+        
+        const int accepted = cfg.accept(ws.res, err_bits);
+        if (accepted >= 0) {
+            res_re     = arf_get_d(arb_midref(acb_realref(ws.res)), ARF_RND_NEAR);
+            res_im     = arf_get_d(arb_midref(acb_imagref(ws.res)), ARF_RND_NEAR);
             *res = std::complex<double>(res_re, res_im);
-            return 0;
+            if (accepted == 0) {
+                if (cfg.cache != NULL) cfg.cache->insert(CACHE_GAMMA_INC, args, 2, cfg.tol, *res);
+                cfg.record(z, prec);
+            }
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return accepted;
         }
         c += 1;
-        if (c > limit) {
-            std::cerr << "\nERROR: limit (" << limit << ") reached\n" <<
-            std::setprecision(1) << std::fixed <<
-            "gamma(s, z) with s=" << s << " and z=" << z << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
+        if (c > cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c - 1, false);
+            cfg.emit(TRACE_LIMIT, "gamma_inc", args, 2, prec, err_bits, c - 1);
             return -1;
         }
-        prec *= 2;
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            res_re     = arf_get_d(arb_midref(acb_realref(ws.res)), ARF_RND_NEAR);
+            res_im     = arf_get_d(arb_midref(acb_imagref(ws.res)), ARF_RND_NEAR);
+            *res = std::complex<double>(res_re, res_im);
+            cfg.count(c - 1, false);
+            cfg.emit(TRACE_STOPPED, "gamma_inc", args, 2, prec, err_bits, c - 1);
+            return STOPPED;
+        }
+        stats.add(FunctionStats::ESCALATIONS);
+        prec = next_prec;
 
     }
 }
@@ -206,69 +541,109 @@ int gamma_inc(std::complex<double> s, std::complex<double> z, std::complex<doubl
 // ##################################################
 
 
+// the workspace lives on the stack, no evaluator is allocated
+int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, std::complex<double> * res,
+            double * rel_err, const Settings & settings)
+{
+    detail::UAsympWorkspace ws;
+    const int status = detail::u_asymp(ws, a, b, z, res, detail::Config(settings, U_ASYMP_DEFAULT_INIT_PREC));
+    if (rel_err != NULL) *rel_err = detail::rel_error(status, ws.shortcut, ws.err_bits, settings.tol);
+    return status;
+}
+
 int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, std::complex<double> * res, double tol,
-            unsigned int limit, bool verbose, unsigned int init_prec)
+            unsigned int limit, bool verbose, unsigned int init_prec,
+            PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol)
+{
+    return u_asymp(a, b, z, res, NULL, Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+int detail::u_asymp(UAsympWorkspace & ws, std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                    std::complex<double> * res, const Config & cfg)
 {
-    acb_t _a, _b, _z, _res;
-    acb_init(_a); acb_init(_b); acb_init(_z); acb_init(_res);
-    acb_set_d_d(_a, a.real(), a.imag());
-    acb_set_d_d(_b, b.real(), b.imag());
-    acb_set_d_d(_z, z.real(), z.imag());
+    ws.prec = ws.attempts = 0;
+    ws.err_bits = WORD_MAX;
+    ws.shortcut = false;
+    FunctionStats & stats = thread_stats().fn[STATS_U_ASYMP];
+    stats.add(FunctionStats::CALLS);
+    const std::complex<double> args[3] = {a, b, z};
+    if ((cfg.cache != NULL) && cfg.cache->lookup(CACHE_U_ASYMP, args, 3, cfg.tol, res)) {
+        ws.shortcut = true;
+        return 0;
+    }
+
+    acb_set_d_d(ws.a, a.real(), a.imag());
+    acb_set_d_d(ws.b, b.real(), b.imag());
+    acb_set_d_d(ws.z, z.real(), z.imag());
     
-    unsigned int prec = init_prec;
+    unsigned int prec = cfg.start_prec(z);
     unsigned int c = 1;
     double res_re, res_im;
-    slong err_bits, err_bits_ref;
-    err_bits_ref = slong(log2(tol));
+    slong err_bits;
+    const slong err_bits_ref = cfg.err_bits_ref;
     
-    if (not acb_hypgeom_u_use_asymp(_z, -err_bits_ref)) {
-        std::cerr << "ERROR: u_asymp can not be evaluated for the given tolerence, this is a property of u_asymp!\n" <<
-        "z:" << z << " tol:" << tol << " err_bits_ref:" << err_bits_ref << "\n" <<
-        "acb_hypgeom_u_use_asymp(z, -err_bits_ref) failed\n"
-        "increase z or decrease tol!\n";
+    if (not acb_hypgeom_u_use_asymp(ws.z, -err_bits_ref)) {
+        // acb_hypgeom_u_use_asymp(z, -err_bits_ref) failed, increase z or decrease tol
+        cfg.emit(TRACE_VALUE_ERROR, "u_asymp", args, 3, 0, 0, 0);
+        stats.add(FunctionStats::VALUE_ERRORS);
         return -2;
     }
     
     while (1) {
-        acb_hypgeom_u_asymp(_res, _a, _b, _z, -1, prec);   // n=-1 -> choose n automatically 
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        acb_hypgeom_u_asymp(ws.res, ws.a, ws.b, ws.z, -1, prec);   // n=-1 -> choose n automatically 
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+        ws.prec = prec;
+        ws.attempts = c;
         
-        err_bits =  acb_rel_error_bits(_res);
-        if (verbose) {
-            std::cout << std::setprecision(1) << std::fixed <<
-            "u_asymp(a, b, z) with a=" << a << " and b=" << b << " and z=" << z << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
-        }
+        err_bits =  acb_rel_error_bits(ws.res);
+        ws.err_bits = err_bits;
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, "u_asymp", args, 3, prec, err_bits, c);
         
-        if (err_bits <= err_bits_ref) {
-            res_re     = arf_get_d(arb_midref(acb_realref(_res)), ARF_RND_NEAR);
-            res_im     = arf_get_d(arb_midref(acb_imagref(_res)), ARF_RND_NEAR);
-            acb_clear(_res); acb_clear(_a); acb_clear(_b); acb_clear(_z);
+        const int accepted = cfg.accept(ws.res, err_bits);
+        if (accepted >= 0) {
+            res_re     = arf_get_d(arb_midref(acb_realref(ws.res)), ARF_RND_NEAR);
+            res_im     = arf_get_d(arb_midref(acb_imagref(ws.res)), ARF_RND_NEAR);
             *res = std::complex<double>(res_re, res_im);
-            return 0;
+            if (accepted == 0) {
+                if (cfg.cache != NULL) cfg.cache->insert(CACHE_U_ASYMP, args, 3, cfg.tol, *res);
+                cfg.record(z, prec);
+            }
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return accepted;
         }
         c += 1;
-        if (c > limit) {
-            std::cerr << "\nERROR: limit (" << limit << ") reached\n" <<
-            std::setprecision(1) << std::fixed <<
-            "u_asymp(a, b, z) with a=" << a << " and b=" << b << " and z=" << z << std::endl <<
-            "internal prec: " << prec << std::endl <<
-            "tol (bits)     : " << err_bits_ref << std::endl <<
-            "rel_err (bits) : " << err_bits << std::endl;
+        if (c > cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c - 1, false);
+            cfg.emit(TRACE_LIMIT, "u_asymp", args, 3, prec, err_bits, c - 1);
             return -1;
         }
-        prec *= 2;
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            res_re     = arf_get_d(arb_midref(acb_realref(ws.res)), ARF_RND_NEAR);
+            res_im     = arf_get_d(arb_midref(acb_imagref(ws.res)), ARF_RND_NEAR);
+            *res = std::complex<double>(res_re, res_im);
+            cfg.count(c - 1, false);
+            cfg.emit(TRACE_STOPPED, "u_asymp", args, 3, prec, err_bits, c - 1);
+            return STOPPED;
+        }
+        stats.add(FunctionStats::ESCALATIONS);
+        prec = next_prec;
 
     }
 }
 
-std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, double tol,
-                             unsigned int limit, bool verbose, unsigned int init_prec)
+namespace {
+
+// res, or the exception for the return code status
+std::complex<double> u_asymp_result(int status, std::complex<double> res,
+                                    std::complex<double> a, std::complex<double> b, std::complex<double> z)
 {
-    std::complex<double> res;
-    int status = u_asymp(a, b, z, &res, tol, limit, verbose, init_prec);
-    if (status) {
+    if (status < 0) {
         std::ostringstream oss;
         if (status == -1) {
             oss << "LIMIT ERROR: u_asymp(a, b, z) with a=" << a << " and b=" << b << " and z=" << z;
@@ -276,13 +651,57 @@ std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std
         } else if (status == -2) {
             oss << "VALUE ERROR: u_asymp can not be evaluated for the given (z, tolerence). This is a property of u_asymp! Increase z or decrease tol!";
             throw std::runtime_error(oss.str());
+        } else if (status == STOPPED) {
+            oss << "STOPPED: u_asymp(a, b, z) with a=" << a << " and b=" << b << " and z=" << z << " (deadline or cancellation)";
+            throw std::runtime_error(oss.str());
         } else {
             oss << "u_asymp unknown error: error code: " << status;
             throw std::runtime_error(oss.str());
         }
-    } else {
-        return res;
     }
+    return res;
+}
+
+} /* namespace */
+
+std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, double tol,
+                             unsigned int limit, bool verbose, unsigned int init_prec,
+                             PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache,
+                             FastPath * fast, StopToken * stop, double atol)
+{
+    std::complex<double> res;
+    int status = u_asymp(a, b, z, &res, tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+    return u_asymp_result(status, res, a, b, z);
+}
+
+UAsympEvaluator::UAsympEvaluator(const Settings & settings) : impl(new Impl(settings)) {}
+UAsympEvaluator::~UAsympEvaluator() { delete impl; }
+
+const Settings & UAsympEvaluator::settings() const { return impl->settings; }
+unsigned int UAsympEvaluator::last_prec() const { return impl->ws.prec; }
+unsigned int UAsympEvaluator::last_attempts() const { return impl->ws.attempts; }
+double UAsympEvaluator::last_rel_error() const
+{
+    return detail::rel_error(impl->ws.shortcut, impl->ws.err_bits, impl->settings.tol);
+}
+
+void UAsympEvaluator::set_settings(const Settings & settings)
+{
+    impl->settings = settings;
+    impl->cfg = detail::Config(settings, U_ASYMP_DEFAULT_INIT_PREC);
+}
+
+std::complex<double> UAsympEvaluator::operator()(std::complex<double> a, std::complex<double> b, std::complex<double> z)
+{
+    std::complex<double> res;
+    int status = (*this)(a, b, z, &res);
+    return u_asymp_result(status, res, a, b, z);
+}
+
+int UAsympEvaluator::operator()(std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                                std::complex<double> * res)
+{
+    return detail::u_asymp(impl->ws, a, b, z, res, impl->cfg);
 }
 
 std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z)
@@ -25,7 +25,15 @@
 #ifndef CPLXFNC_H
 #define CPLXFNC_H
 
+#include <atomic>
+#include <chrono>
 #include <complex>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
 
 #define ZETA_DEFAULT_INIT_PREC 56
 #define GAMMA_INC_DEFAULT_INIT_PREC 75
@@ -33,33 +41,1245 @@
 
 extern "C" {
   void libcplxfnc_is_present(void);
+
+  // ##################################################
+  // ##     instrumentation counters
+  // ##
+  // ##     Always on, kept per thread without locks. cplxfnc_stats_read sums the
+  // ##     counters of all threads (also finished ones) since the last reset.
+  // ##     prec_hist[k] counts the successful evaluations with final precision in
+  // ##     (2^(k-1), 2^k], the last bin collects everything above. arb_ns is the
+  // ##     time spent inside acb_hurwitz_zeta, acb_hypgeom_gamma_upper and
+  // ##     acb_hypgeom_u_asymp, respectively (or the special-value kernel).
+  // ##     special[k] counts the calls answered by the closed form k of the
+  // ##     function (CPLXFNC_SPECIAL_*), see cplxfnc_special.cpp.
+  // ##################################################
+
+  #define CPLXFNC_STATS_ZETA 0
+  #define CPLXFNC_STATS_GAMMA_INC 1
+  #define CPLXFNC_STATS_U_ASYMP 2
+  #define CPLXFNC_PREC_BINS 24
+
+  #define CPLXFNC_SPECIAL_KINDS 3
+  #define CPLXFNC_SPECIAL_ZETA_RIEMANN 0        // zeta(s, 1)
+  #define CPLXFNC_SPECIAL_ZETA_RATIONAL 1       // zeta(n, a), integer n >= 2, a = m or m + 1/2
+  #define CPLXFNC_SPECIAL_GAMMA 0               // gamma_inc(s, 0) = Gamma(s), Re(s) > 0
+  #define CPLXFNC_SPECIAL_EXP 1                 // gamma_inc(1, z) = exp(-z)
+  #define CPLXFNC_SPECIAL_FINITE_SUM 2          // gamma_inc(n, z), integer n >= 2
+
+  struct cplxfnc_stats {
+    unsigned long long calls;
+    unsigned long long arb_evals;
+    unsigned long long escalations;
+    unsigned long long limit_failures;
+    unsigned long long value_errors;
+    unsigned long long arb_ns;
+    unsigned long long prec_hist[CPLXFNC_PREC_BINS];
+    unsigned long long special[CPLXFNC_SPECIAL_KINDS];
+  };
+
+  // returns 0, or -2 for an unknown function
+  int cplxfnc_stats_read(int function, struct cplxfnc_stats * stats);
+  void cplxfnc_stats_reset(void);
 }
 
 namespace cplxfnc {
 
+// ##################################################
+// ##     adaptive initial precision
+// ##
+// ##     Records the precision at which the evaluations finally succeeded, bucketed
+// ##     by the modulus (log2) and the phase of the main argument (a for zeta, z for
+// ##     gamma_inc and u_asymp). A function called with a predictor starts at the
+// ##     precision that was sufficient for the fraction 'quantile' of the recorded
+// ##     evaluations in the bucket of its argument. As long as a bucket holds less
+// ##     than min_samples records init_prec is used.
+// ##     The predicted precision never drops below the precision the recorded
+// ##     evaluations started with. Use one predictor per function, it may be shared
+// ##     between threads.
+// ##################################################
+
+class PrecisionPredictor {
+public:
+    explicit PrecisionPredictor(double quantile=0.9, unsigned int min_samples=8);
+    ~PrecisionPredictor();
+
+    // the predicted initial precision for the argument x, 0 if unknown
+    unsigned int predict(std::complex<double> x) const;
+    // record that an evaluation with argument x succeeded at precision prec
+    void record(std::complex<double> x, unsigned int prec);
+    void reset();
+
+private:
+    PrecisionPredictor(const PrecisionPredictor &) = delete;
+    PrecisionPredictor & operator=(const PrecisionPredictor &) = delete;
+
+    struct Table;
+    Table * table;
+    double quantile;
+    unsigned int min_samples;
+};
+
+// ##################################################
+// ##     precision escalation
+// ##
+// ##     If an attempt misses the tolerance the policy chooses the precision of
+// ##     the next attempt from the precision and the relative error (in bits, as
+// ##     returned by acb_rel_error_bits) just measured. Without a policy the
+// ##     precision is doubled. Each policy counts the calls, the attempts (arb
+// ##     evaluations) and the calls which reached the limit it was used for.
+// ##################################################
+
+class EscalationPolicy {
+public:
+    EscalationPolicy();
+    virtual ~EscalationPolicy();
+
+    // err_bits > err_bits_ref, the returned precision must be larger than prec
+    virtual unsigned int next_prec(unsigned int prec, long err_bits, long err_bits_ref) const = 0;
+
+    unsigned long calls() const;
+    unsigned long attempts() const;
+    unsigned long failures() const;
+    void reset_stats();
+    // called by the functions once per evaluation
+    void count(unsigned int attempts, bool success);
+
+private:
+    EscalationPolicy(const EscalationPolicy &) = delete;
+    EscalationPolicy & operator=(const EscalationPolicy &) = delete;
+
+    std::atomic<unsigned long> n_calls;
+    std::atomic<unsigned long> n_attempts;
+    std::atomic<unsigned long> n_failures;
+};
+
+// prec -> 2*prec, the default
+class DoublingPolicy : public EscalationPolicy {
+public:
+    unsigned int next_prec(unsigned int prec, long err_bits, long err_bits_ref) const;
+};
+
+// prec -> prec + (err_bits - err_bits_ref) + guard_bits, i.e. add the bits that were
+// missing. If less than min_bits bits were correct the deficit is not reliable and
+// the precision is doubled instead.
+class DeficitPolicy : public EscalationPolicy {
+public:
+    explicit DeficitPolicy(unsigned int guard_bits=10, unsigned int min_bits=8);
+    unsigned int next_prec(unsigned int prec, long err_bits, long err_bits_ref) const;
+
+private:
+    unsigned int guard_bits;
+    unsigned int min_bits;
+};
+
+// ##################################################
+// ##     result cache
+// ##
+// ##     Successful results keyed on the exact bit patterns of the arguments and
+// ##     tol. The entries are spread over n_shards independently locked shards,
+// ##     each holding at most capacity/n_shards entries and evicting the least
+// ##     recently used one. A cache may be shared between functions and threads.
+// ##################################################
+
+enum CacheFunction { CACHE_ZETA = 1, CACHE_GAMMA_INC = 2, CACHE_U_ASYMP = 3 };
+
+class ResultCache {
+public:
+    explicit ResultCache(std::size_t capacity=65536, unsigned int n_shards=16);
+    ~ResultCache();
+
+    // args points to the n_args (<= 3) arguments of function fn
+    bool lookup(CacheFunction fn, const std::complex<double> * args, unsigned int n_args, double tol,
+                std::complex<double> * res);
+    void insert(CacheFunction fn, const std::complex<double> * args, unsigned int n_args, double tol,
+                std::complex<double> res);
+
+    unsigned long hits() const;
+    unsigned long misses() const;
+    std::size_t size() const;
+    void clear();
+    void reset_stats();
+
+private:
+    ResultCache(const ResultCache &) = delete;
+    ResultCache & operator=(const ResultCache &) = delete;
+
+    struct Shard;
+    Shard * shards;
+    unsigned int n_shards;
+};
+
+// ##################################################
+// ##     double precision fast path
+// ##
+// ##     Before the arb escalation loop zeta (for real a > 0) and gamma_inc (for
+// ##     Re(z) > 0, asymptotic series) try a double precision kernel which bounds
+// ##     its truncation error and all its rounding errors (its elementary functions
+// ##     come with proven error bounds, libm is not used). If the bound meets tol
+// ##     the double result is returned, otherwise arb takes over. The batch
+// ##     functions run the kernel on FAST_LANES points at once, the lane loops are
+// ##     vectorised by the compiler.
+// ##     The worst case rounding error bound is some hundred ulp, so the fast path
+// ##     rarely answers for tol below 1e-13, it pays off for tol of about 1e-12
+// ##     and larger.
+// ##     The counters tell which tier answered, cache hits count for neither.
+// ##     A fast path may be shared between functions and threads.
+// ##################################################
+
+class FastPath {
+public:
+    FastPath();
+
+    unsigned long fast() const;     // answered by the double precision kernel
+    unsigned long arb() const;      // passed on to arb (successful or not)
+    void reset_stats();
+    void count(bool fast);
+
+private:
+    FastPath(const FastPath &) = delete;
+    FastPath & operator=(const FastPath &) = delete;
+
+    std::atomic<unsigned long> n_fast;
+    std::atomic<unsigned long> n_arb;
+};
+
+// ##################################################
+// ##     diagnostics
+// ##
+// ##     The functions do no I/O. Instead the limit failures, the value errors
+// ##     and, with verbose=true, every arb attempt are pushed as TraceEvent into
+// ##     the TraceSink of the settings or, if there is none, into the sink set
+// ##     by set_trace_sink. Without any sink (the default) nothing is recorded.
+// ##     push never blocks or allocates, if the ring buffer is full the event is
+// ##     dropped and counted. The events are consumed by drain (one consumer at
+// ##     a time) or by a background thread started with start. format_event
+// ##     gives the text the functions used to print.
+// ##################################################
+
+enum TraceKind {TRACE_ATTEMPT=1, TRACE_LIMIT=2, TRACE_VALUE_ERROR=3, TRACE_STOPPED=4};
+
+struct TraceEvent {
+    const char * function;          // "zeta", "gamma_inc" or "u_asymp"
+    int kind;                       // TraceKind
+    std::complex<double> args[3];
+    unsigned int n_args;
+    unsigned int prec;              // precision of the attempt (0 if arb was not called)
+    long err_bits;                  // relative error of the attempt (bits)
+    long err_bits_ref;              // log2(tol)
+    unsigned int attempt;
+};
+
+class TraceSink {
+public:
+    // the capacity is rounded up to a power of two
+    explicit TraceSink(std::size_t capacity=4096);
+    ~TraceSink();
+    TraceSink(const TraceSink &) = delete;
+    TraceSink & operator=(const TraceSink &) = delete;
+
+    // thread safe, returns false if the event was dropped
+    bool push(const TraceEvent & ev) noexcept;
+    // consumer side, returns false if the buffer is empty
+    bool pop(TraceEvent * ev);
+    // calls callback for every buffered event, returns their number
+    std::size_t drain(const std::function<void(const TraceEvent &)> & callback);
+    unsigned long dropped() const;
+
+    // drain every interval_ms milliseconds in a background thread, stop drains
+    // the remaining events and joins the thread (also done by the destructor)
+    void start(const std::function<void(const TraceEvent &)> & callback, unsigned int interval_ms=10);
+    void stop();
+
+private:
+    struct Impl;
+    Impl * impl;
+};
+
+// the sink used if the settings have none (NULL to disable)
+void set_trace_sink(TraceSink * sink);
+TraceSink * trace_sink();
+
+std::string format_event(const TraceEvent & ev);
+
+// ##################################################
+// ##     deadlines and cancellation
+// ##
+// ##     A StopToken is checked between the escalation steps: if it was cancelled,
+// ##     or if the next attempt would end after the deadline (its duration is
+// ##     extrapolated from the last attempt, quadratic in the precision), the
+// ##     evaluation returns -3 (STOPPED). The result is then the midpoint of the
+// ##     last attempt, its relative error bound is 2^err_bits of the TRACE_STOPPED
+// ##     event, last_rel_error() of the evaluators and the rel_err output of the
+// ##     scalar, batch, parallel and async functions. The first attempt always
+// ##     runs, a single arb call is not interrupted. The batch functions check the
+// ##     token before each point, points not started get -3 and NaN.
+// ##     A token may be shared between threads and calls.
+// ##################################################
+
+// the return code of an evaluation stopped by a StopToken
+const int STOPPED = -3;
+
+class StopToken {
+public:
+    // no deadline
+    StopToken();
+    // the deadline is now + timeout
+    explicit StopToken(std::chrono::steady_clock::duration timeout);
+
+    void cancel();
+    void set_deadline(std::chrono::steady_clock::time_point deadline);
+    // no deadline and not cancelled
+    void reset();
+
+    bool cancelled() const;
+    // cancelled, or the deadline is before t
+    bool stop_requested(std::chrono::steady_clock::time_point t=std::chrono::steady_clock::now()) const;
+
+private:
+    StopToken(const StopToken &) = delete;
+    StopToken & operator=(const StopToken &) = delete;
+
+    std::atomic<bool> is_cancelled;
+    std::atomic<long long> deadline;    // steady_clock ticks
+};
+
+// ##################################################
+// ##     absolute tolerance
+// ##
+// ##     Near a zero of the function the relative error does not shrink with
+// ##     the precision, and a purely relative tol runs into the limit. With
+// ##     atol > 0 an attempt is also accepted if the absolute error bound is
+// ##     at most atol. The return code says which criterion was met: 0 for tol
+// ##     and ATOL_MET if only atol was met, so a failure is a negative code.
+// ##     A result accepted by atol is not put into the cache and not recorded
+// ##     by the predictor. The sequences and the path evaluators use tol only.
+// ##################################################
+
+// the return code of an evaluation that met atol but not tol
+const int ATOL_MET = 1;
+
+// ##################################################
+// ##     settings
+// ##
+// ##     The options of an evaluation bundled for the evaluator classes below.
+// ##     init_prec=0 selects the default initial precision of the function. The
+// ##     pointers are optional (NULL) and must outlive the evaluators using them.
+// ##################################################
+
+struct Settings {
+    explicit Settings(double tol=1e-16, unsigned int limit=5, bool verbose=false, unsigned int init_prec=0,
+                      PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+                      ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
+
+    double tol;
+    unsigned int limit;
+    bool verbose;
+    unsigned int init_prec;
+    PrecisionPredictor * predictor;
+    EscalationPolicy * policy;
+    ResultCache * cache;
+    FastPath * fast;
+    StopToken * stop;
+    TraceSink * trace;          // NULL: the sink set by set_trace_sink
+    double atol;                // absolute tolerance, 0: tol only
+};
+
 std::complex<double> zeta(std::complex<double> s, std::complex<double> a);
 std::complex<double> zeta(std::complex<double> s, std::complex<double> a, double tol, 
         unsigned int limit, bool verbose,
-        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC);
+        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
 int zeta(std::complex<double> s, std::complex<double> a, std::complex<double> *res, double tol,
         unsigned int limit, bool verbose, 
-        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC);
+        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
+// rel_err gets the relative error bound of res (see batch evaluation), may be NULL
+int zeta(std::complex<double> s, std::complex<double> a, std::complex<double> * res, double * rel_err,
+        const Settings & settings=Settings());
 
 std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z);
 std::complex<double> gamma_inc(std::complex<double> s, std::complex<double> z, double tol,
         unsigned int limit, bool verbose,
-        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC);
+        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
 int gamma_inc(std::complex<double> s, std::complex<double> z, std::complex<double> * res, double tol,
         unsigned int limit, bool verbose, 
-        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC);
+        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
+int gamma_inc(std::complex<double> s, std::complex<double> z, std::complex<double> * res, double * rel_err,
+        const Settings & settings=Settings());
 
 std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z);              
 std::complex<double> u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, double tol,
         unsigned int limit, bool verbose, 
-        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC);
+        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
 int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, std::complex<double> * res, double tol,
         unsigned int limit, bool verbose, 
-        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC);
+        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
+int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, std::complex<double> * res,
+        double * rel_err, const Settings & settings=Settings());
+
+// ##################################################
+// ##     cost estimates
+// ##
+// ##     A cheap guess of what an evaluation with the given settings will need,
+// ##     without calling arb's kernels: the final working precision, the number
+// ##     of attempts and the relative cost, the sum over the attempts of
+// ##     (prec / default init_prec)^2, i.e. 1 is a single attempt at the default
+// ##     initial precision of the function. The value errors of the functions
+// ##     (including acb_hypgeom_u_use_asymp for u_asymp) are detected exactly,
+// ##     status -1 marks requests expected to reach the limit. The precision
+// ##     needed is taken from settings.predictor if it has data for the argument,
+// ##     else from a coarse model of the bits lost to cancellation; the attempts
+// ##     follow settings.policy (or the doubling). Use the estimates to sort and
+// ##     bin batches or to reject hopeless requests, not as error bounds.
+// ##################################################
+
+struct CostEstimate {
+    int status;                 // 0, -1: limit expected to be reached, -2: value error
+    unsigned int prec;          // final working precision
+    unsigned int attempts;      // arb evaluations
+    double cost;                // relative to one attempt at the default init_prec
+};
+
+CostEstimate zeta_estimate(std::complex<double> s, std::complex<double> a, const Settings & settings=Settings());
+CostEstimate gamma_inc_estimate(std::complex<double> s, std::complex<double> z, const Settings & settings=Settings());
+CostEstimate u_asymp_estimate(std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                              const Settings & settings=Settings());
+
+// ##################################################
+// ##     typed results
+// ##
+// ##     zeta<T>, gamma_inc<T> and u_asymp<T> return the result as T, one of
+// ##     std::complex<float>, std::complex<double>, std::complex<long double>
+// ##     and ComplexDD (real and imaginary part as double-double). The relative
+// ##     tolerance 2^-bits and the initial precision (the default of the function,
+// ##     which is set for 53 bits, shifted by bits - 53) are compile time
+// ##     constants of ResultType<T>, so a float result starts at about half the
+// ##     precision of a double result and stops escalating once 24 bits are
+// ##     correct. The result is rounded from the midpoint of the final arb ball,
+// ##     long double and ComplexDD keep the bits beyond double. The arguments are
+// ##     doubles, limit is 5 and the return codes are those of the double
+// ##     functions. Other types T do not link.
+// ##################################################
+
+// the unevaluated sum hi + lo of two doubles with |lo| <= ulp(hi) / 2
+struct DoubleDouble {
+    double hi, lo;
+};
+
+struct ComplexDD {
+    DoubleDouble real, imag;
+};
+
+namespace detail {
+// 2^-n as constant expression
+constexpr double exp2_neg(unsigned int n) { return n == 0 ? 1. : 0.5 * exp2_neg(n - 1); }
+}
+
+template <unsigned int Bits>
+struct ResultBits {
+    static constexpr unsigned int bits = Bits;
+    static constexpr double tol = detail::exp2_neg(Bits);
+    static constexpr unsigned int init_prec(unsigned int default_init_prec) {
+        return default_init_prec + Bits - 53;
+    }
+};
+
+template <class T> struct ResultType;
+template <> struct ResultType<std::complex<float> > : ResultBits<std::numeric_limits<float>::digits> {};
+template <> struct ResultType<std::complex<double> > : ResultBits<std::numeric_limits<double>::digits> {};
+template <> struct ResultType<std::complex<long double> > : ResultBits<std::numeric_limits<long double>::digits> {};
+template <> struct ResultType<ComplexDD> : ResultBits<2 * std::numeric_limits<double>::digits> {};
+
+template <class T> T zeta(std::complex<double> s, std::complex<double> a);
+template <class T> int zeta(std::complex<double> s, std::complex<double> a, T * res);
+
+template <class T> T gamma_inc(std::complex<double> s, std::complex<double> z);
+template <class T> int gamma_inc(std::complex<double> s, std::complex<double> z, T * res);
+
+template <class T> T u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z);
+template <class T> int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, T * res);
+
+// ##################################################
+// ##     persistent evaluators
+// ##
+// ##     Own the arb temporaries and the settings (log2(tol) is derived once), so
+// ##     that repeated calls pay for the arb evaluation only. Once the temporaries
+// ##     have grown to the working precision an evaluator allocates nothing per
+// ##     call (arb itself may still use scratch space). The free functions above
+// ##     and the batch functions below share the loops of the evaluators on a
+// ##     workspace of their own, without allocating an evaluator.
+// ##     An evaluator is not thread safe, keep one per thread.
+// ##################################################
+
+class ZetaEvaluator {
+public:
+    explicit ZetaEvaluator(const Settings & settings=Settings());
+    ~ZetaEvaluator();
+
+    const Settings & settings() const;
+    void set_settings(const Settings & settings);
+    // the final precision and the number of arb evaluations of the last call,
+    // 0 if it was answered by the cache or the fast path (or was a value error)
+    unsigned int last_prec() const;
+    unsigned int last_attempts() const;
+    // the relative error bound of the last evaluation as for rel_err of the batch functions
+    // (tol from the cache or the fast path), but also for a failed one (infinity if unknown)
+    double last_rel_error() const;
+
+    // throws std::runtime_error if the evaluation fails
+    std::complex<double> operator()(std::complex<double> s, std::complex<double> a);
+    // returns the status as zeta does
+    int operator()(std::complex<double> s, std::complex<double> a, std::complex<double> * res);
+
+    // strides in bytes, semantics as for zeta_batch
+    std::size_t batch(std::size_t n,
+                      const std::complex<double> * s, std::ptrdiff_t s_stride,
+                      const std::complex<double> * a, std::ptrdiff_t a_stride,
+                      std::complex<double> * res, std::ptrdiff_t res_stride,
+                      int * status, std::ptrdiff_t status_stride,
+                      double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double)) noexcept;
+    std::size_t batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+                      std::complex<double> * res, int * status) noexcept;
+
+private:
+    ZetaEvaluator(const ZetaEvaluator &) = delete;
+    ZetaEvaluator & operator=(const ZetaEvaluator &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+class GammaIncEvaluator {
+public:
+    explicit GammaIncEvaluator(const Settings & settings=Settings());
+    ~GammaIncEvaluator();
+
+    const Settings & settings() const;
+    void set_settings(const Settings & settings);
+    // the final precision and the number of arb evaluations of the last call,
+    // 0 if it was answered by the cache or the fast path (or was a value error)
+    unsigned int last_prec() const;
+    unsigned int last_attempts() const;
+    // the relative error bound of the last evaluation as for rel_err of the batch functions
+    // (tol from the cache or the fast path), but also for a failed one (infinity if unknown)
+    double last_rel_error() const;
+
+    // throws std::runtime_error if the evaluation fails
+    std::complex<double> operator()(std::complex<double> s, std::complex<double> z);
+    // returns the status as gamma_inc does
+    int operator()(std::complex<double> s, std::complex<double> z, std::complex<double> * res);
+
+    // strides in bytes, semantics as for gamma_inc_batch
+    std::size_t batch(std::size_t n,
+                      const std::complex<double> * s, std::ptrdiff_t s_stride,
+                      const std::complex<double> * z, std::ptrdiff_t z_stride,
+                      std::complex<double> * res, std::ptrdiff_t res_stride,
+                      int * status, std::ptrdiff_t status_stride,
+                      double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double)) noexcept;
+    std::size_t batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                      std::complex<double> * res, int * status) noexcept;
+
+private:
+    GammaIncEvaluator(const GammaIncEvaluator &) = delete;
+    GammaIncEvaluator & operator=(const GammaIncEvaluator &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+class UAsympEvaluator {
+public:
+    explicit UAsympEvaluator(const Settings & settings=Settings());
+    ~UAsympEvaluator();
+
+    const Settings & settings() const;
+    void set_settings(const Settings & settings);
+    // the final precision and the number of arb evaluations of the last call,
+    // 0 if it was answered by the cache or the fast path (or was a value error)
+    unsigned int last_prec() const;
+    unsigned int last_attempts() const;
+    // the relative error bound of the last evaluation as for rel_err of the batch functions
+    // (tol from the cache or the fast path), but also for a failed one (infinity if unknown)
+    double last_rel_error() const;
+
+    // throws std::runtime_error if the evaluation fails
+    std::complex<double> operator()(std::complex<double> a, std::complex<double> b, std::complex<double> z);
+    // returns the status as u_asymp does
+    int operator()(std::complex<double> a, std::complex<double> b, std::complex<double> z, std::complex<double> * res);
+
+    // strides in bytes, semantics as for u_asymp_batch
+    std::size_t batch(std::size_t n,
+                      const std::complex<double> * a, std::ptrdiff_t a_stride,
+                      const std::complex<double> * b, std::ptrdiff_t b_stride,
+                      const std::complex<double> * z, std::ptrdiff_t z_stride,
+                      std::complex<double> * res, std::ptrdiff_t res_stride,
+                      int * status, std::ptrdiff_t status_stride,
+                      double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double)) noexcept;
+    std::size_t batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+                      const std::complex<double> * z, std::complex<double> * res, int * status) noexcept;
+
+private:
+    UAsympEvaluator(const UAsympEvaluator &) = delete;
+    UAsympEvaluator & operator=(const UAsympEvaluator &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+// ##################################################
+// ##     Hurwitz zeta function for fixed s
+// ##
+// ##     Evaluates zeta(s, a) by Euler-Maclaurin summation (as arb does) with the
+// ##     s dependent coefficients B_2j / (2j)! * s (s+1) ... (s+2j-2) of the tail
+// ##     precomputed. The coefficients are kept for every precision the escalation
+// ##     reached, so later calls and escalation steps reuse them. The number of
+// ##     terms and the rigorous bound of the remainder are chosen by arb.
+// ##     With n_eval > 0 (the number of evaluations expected) real a in (0, 16]
+// ##     use arb's grid of Taylor polynomials of zeta(s, a) on (0, 1]
+// ##     (acb_dirichlet_hurwitz_precomp, set up once per precision reached with
+// ##     the grid size arb chooses for n_eval evaluations, the set up evaluates
+// ##     zeta at the grid points) and at most 15 powers to shift a, instead of
+// ##     the power sum of about prec terms. Pays off for many real a, e.g. when
+// ##     tabulating zeta(s, a).
+// ##     The settings (but the cache and the fast path) and the return codes have
+// ##     the same meaning as for zeta, the evaluations count in the instrumentation
+// ##     counters of zeta. An object is not thread safe, use one per thread.
+// ##################################################
+
+class HurwitzZeta {
+public:
+    explicit HurwitzZeta(std::complex<double> s, const Settings & settings=Settings(), std::size_t n_eval=0);
+    HurwitzZeta(std::complex<double> s, double tol, unsigned int limit=5,
+                bool verbose=false, unsigned int init_prec=ZETA_DEFAULT_INIT_PREC);
+    ~HurwitzZeta();
+
+    std::complex<double> s() const;
+
+    std::complex<double> operator()(std::complex<double> a);
+    int operator()(std::complex<double> a, std::complex<double> * res);
+
+    // strides in bytes, semantics as for zeta_batch
+    std::size_t batch(std::size_t n, const std::complex<double> * a, std::ptrdiff_t a_stride,
+                      std::complex<double> * res, std::ptrdiff_t res_stride,
+                      int * status, std::ptrdiff_t status_stride) noexcept;
+    std::size_t batch(std::size_t n, const std::complex<double> * a, std::complex<double> * res,
+                      int * status) noexcept;
+
+private:
+    HurwitzZeta(const HurwitzZeta &) = delete;
+    HurwitzZeta & operator=(const HurwitzZeta &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+// ##################################################
+// ##     derivatives
+// ##
+// ##     res[k] = d^k/dx^k f for k = 0 ... n (res holds n+1 values), where x is
+// ##     the argument in the name, from one arb power series per attempt:
+// ##       zeta_jet_s       acb_poly_zeta_series (series in s)
+// ##       zeta_jet_a       (-1)^k (s)_k zeta(s+k, a), n+1 Hurwitz zeta values
+// ##       gamma_inc_jet_s  Gamma(s+x, z) = e^-z U(1-s-x, 1-s-x, z) by
+// ##                        acb_hypgeom_u_1f1_series, Gamma(s+x) for z=0
+// ##       gamma_inc_jet_z  acb_hypgeom_gamma_upper_series (series in z)
+// ##     With the Taylor coefficients c_k = res[k]/k!, every c_k has to meet tol
+// ##     relative to max_j |c_j| (a vanishing derivative needs no small relative
+// ##     error), or every res[k] has to meet atol (ATOL_MET). The series of U
+// ##     cancels about |z|/ln(2) bits, gamma_inc_jet_s starts with that many
+// ##     extra bits, so its cost grows with |z| (meant for |z| up to a few
+// ##     hundred, beyond 45000 the limit is likely reached). The precision
+// ##     escalation (tol, atol, limit, verbose, init_prec, policy and trace of
+// ##     the settings) and the return codes are those of zeta and gamma_inc, the
+// ##     predictor, the cache and the fast path are not used. Value errors (-2): zeta_jet_a for s = 0, -1, ...
+// ##     with 1-s <= n (where (s)_k zeta(s+k, a) is 0 * infinity), gamma_inc_jet_s
+// ##     for Re(s) < 0 and z=0, gamma_inc_jet_z for z=0 and n > 0.
+// ##################################################
+
+int zeta_jet_s(std::complex<double> s, std::complex<double> a, unsigned int n, std::complex<double> * res,
+               const Settings & settings=Settings());
+int zeta_jet_a(std::complex<double> s, std::complex<double> a, unsigned int n, std::complex<double> * res,
+               const Settings & settings=Settings());
+int gamma_inc_jet_s(std::complex<double> s, std::complex<double> z, unsigned int n, std::complex<double> * res,
+                    const Settings & settings=Settings());
+int gamma_inc_jet_z(std::complex<double> s, std::complex<double> z, unsigned int n, std::complex<double> * res,
+                    const Settings & settings=Settings());
+
+// throw std::runtime_error if the evaluation fails
+std::vector<std::complex<double> > zeta_jet_s(std::complex<double> s, std::complex<double> a, unsigned int n,
+                                              const Settings & settings=Settings());
+std::vector<std::complex<double> > zeta_jet_a(std::complex<double> s, std::complex<double> a, unsigned int n,
+                                              const Settings & settings=Settings());
+std::vector<std::complex<double> > gamma_inc_jet_s(std::complex<double> s, std::complex<double> z, unsigned int n,
+                                                   const Settings & settings=Settings());
+std::vector<std::complex<double> > gamma_inc_jet_z(std::complex<double> s, std::complex<double> z, unsigned int n,
+                                                   const Settings & settings=Settings());
+
+// ##################################################
+// ##     sequences
+// ##
+// ##     res[k] = gamma_inc(s+k, z) or res[k] = zeta(s, a+k) for k = 0 ... n-1
+// ##     from few arb evaluations (anchors) and the recurrences
+// ##     Gamma(s+1, z) = s Gamma(s, z) + z^s e^-z and zeta(s, a+1) = zeta(s, a) - a^-s,
+// ##     evaluated with arb balls so the error growth is tracked. The anchors
+// ##     are computed with some guard bits, starting at the lower end of the
+// ##     range the recurrence runs forward as long as the values meet tol, then
+// ##     from an anchor at the upper end backward. The recurrence is stable in
+// ##     one of the directions, so the remaining gap is usually empty, otherwise
+// ##     it is treated the same way (re-anchoring).
+// ##     The settings and the return codes are those of gamma_inc and zeta (the
+// ##     cache and the fast path are not used, gamma_inc_sequence returns a value
+// ##     error for Re(s) < 0 and z=0). Values not computed because an anchor failed
+// ##     are set to NaN. The number of anchors is stored in anchors (if not NULL),
+// ##     the anchors count as calls in the instrumentation counters.
+// ##################################################
+
+int zeta_sequence(std::complex<double> s, std::complex<double> a, std::size_t n, std::complex<double> * res,
+                  const Settings & settings=Settings(), std::size_t * anchors=NULL);
+int gamma_inc_sequence(std::complex<double> s, std::complex<double> z, std::size_t n, std::complex<double> * res,
+                       const Settings & settings=Settings(), std::size_t * anchors=NULL);
+// throw std::runtime_error if the evaluation fails
+std::vector<std::complex<double> > zeta_sequence(std::complex<double> s, std::complex<double> a, std::size_t n,
+                                                 const Settings & settings=Settings());
+std::vector<std::complex<double> > gamma_inc_sequence(std::complex<double> s, std::complex<double> z, std::size_t n,
+                                                      const Settings & settings=Settings());
+
+// ##################################################
+// ##     path continuation
+// ##
+// ##     gamma_inc(s, z) and u_asymp(a, b, z) at many nearby points z (e.g. along
+// ##     the path z(t) of an ODE integration) for fixed s or a, b. The object
+// ##     keeps the Taylor expansion of order n in z at the last anchor z0, the
+// ##     coefficients come from one arb evaluation at z0 (two for u_asymp) and
+// ##     the linear ODE the function satisfies in z (dGamma(s, z)/dz = -z^(s-1) e^-z
+// ##     and Kummer's equation). A point is the Taylor polynomial evaluated with
+// ##     arb balls plus a rigorous bound of the remainder. Only if that misses
+// ##     tol, or z is too far from z0 (the expansion stops at the branch cut
+// ##     (-infinity, 0]), the point is evaluated by arb and becomes the next anchor.
+// ##     The anchors use guard bits as the sequences do, so the steps have room
+// ##     for the rounding. If arb cannot reach them, the point gets the value and
+// ##     status of a plain evaluation with tol and is not expanded. The best order depends on the step size, the default
+// ##     suits small steps, order 2 is the minimum.
+// ##     tol, limit, verbose, init_prec, predictor, policy, stop and trace are
+// ##     used by the anchors, the cache, the fast path and atol are not. The
+// ##     return codes are those of gamma_inc and u_asymp, a point of u_asymp_path
+// ##     gets the value error wherever u_asymp does. anchors() and steps() count
+// ##     the points evaluated each way, the anchors count as calls in the
+// ##     instrumentation counters.
+// ##     gamma_inc_path and u_asymp_path evaluate the points z[0] ... z[n-1] in
+// ##     order with one object, failed points get NaN (after a stop all remaining
+// ##     ones), the first failure code is returned. An object is not thread safe,
+// ##     use one per thread.
+// ##################################################
+
+const unsigned int PATH_DEFAULT_ORDER = 16;
+
+class GammaIncPath {
+public:
+    explicit GammaIncPath(std::complex<double> s, const Settings & settings=Settings(),
+                          unsigned int order=PATH_DEFAULT_ORDER);
+    ~GammaIncPath();
+
+    std::complex<double> s() const;
+    std::size_t anchors() const;
+    std::size_t steps() const;
+
+    // throws std::runtime_error if the evaluation fails
+    std::complex<double> operator()(std::complex<double> z);
+    // returns the status as gamma_inc does
+    int operator()(std::complex<double> z, std::complex<double> * res);
+
+private:
+    GammaIncPath(const GammaIncPath &) = delete;
+    GammaIncPath & operator=(const GammaIncPath &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+class UAsympPath {
+public:
+    UAsympPath(std::complex<double> a, std::complex<double> b, const Settings & settings=Settings(),
+               unsigned int order=PATH_DEFAULT_ORDER);
+    ~UAsympPath();
+
+    std::complex<double> a() const;
+    std::complex<double> b() const;
+    std::size_t anchors() const;
+    std::size_t steps() const;
+
+    // throws std::runtime_error if the evaluation fails
+    std::complex<double> operator()(std::complex<double> z);
+    // returns the status as u_asymp does
+    int operator()(std::complex<double> z, std::complex<double> * res);
+
+private:
+    UAsympPath(const UAsympPath &) = delete;
+    UAsympPath & operator=(const UAsympPath &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+int gamma_inc_path(std::complex<double> s, std::size_t n, const std::complex<double> * z, std::complex<double> * res,
+                   const Settings & settings=Settings(), std::size_t * anchors=NULL);
+int u_asymp_path(std::complex<double> a, std::complex<double> b, std::size_t n, const std::complex<double> * z,
+                 std::complex<double> * res, const Settings & settings=Settings(), std::size_t * anchors=NULL);
+// throw std::runtime_error if the evaluation fails
+std::vector<std::complex<double> > gamma_inc_path(std::complex<double> s, const std::vector<std::complex<double> > & z,
+                                                  const Settings & settings=Settings());
+std::vector<std::complex<double> > u_asymp_path(std::complex<double> a, std::complex<double> b,
+                                                const std::vector<std::complex<double> > & z,
+                                                const Settings & settings=Settings());
+
+// ##################################################
+// ##     batch evaluation
+// ##
+// ##     Evaluate n points with one set of arb temporaries kept alive for the
+// ##     whole batch. The i-th argument is read from ((char *) x + i * x_stride),
+// ##     i.e. strides are given in bytes (as numpy does), a stride of 0 broadcasts
+// ##     a single value. The return code of each point (0: success, ATOL_MET:
+// ##     success by atol, -1: limit reached, -2: value error) is written to
+// ##     status, which may be NULL.
+// ##     The result of a failed point is set to NaN (a point stopped by the
+// ##     StopToken after its first attempt keeps the estimate).
+// ##     The overloads taking Settings (and the batch functions of the evaluators)
+// ##     also write the relative error bound of each result to rel_err (strided
+// ##     as status, may be NULL): 2^err_bits of the final arb attempt (for a
+// ##     stopped point the bound of its estimate, 0 for an exact result), tol for
+// ##     a result from the cache or the fast path and infinity for a failed
+// ##     point or a ball with a zero midpoint (possible with atol). The scalar
+// ##     overloads taking rel_err do the same for one point.
+// ##     The batch functions never throw, they return the number of failed points.
+// ##################################################
+
+std::size_t zeta_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err, std::ptrdiff_t rel_err_stride,
+        const Settings & settings=Settings()) noexcept;
+std::size_t zeta_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+std::size_t zeta_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+        std::complex<double> * res, int * status,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+std::size_t gamma_inc_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err, std::ptrdiff_t rel_err_stride,
+        const Settings & settings=Settings()) noexcept;
+std::size_t gamma_inc_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+std::size_t gamma_inc_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+        std::complex<double> * res, int * status,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+std::size_t u_asymp_batch(std::size_t n,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        const std::complex<double> * b, std::ptrdiff_t b_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err, std::ptrdiff_t rel_err_stride,
+        const Settings & settings=Settings()) noexcept;
+std::size_t u_asymp_batch(std::size_t n,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        const std::complex<double> * b, std::ptrdiff_t b_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+std::size_t u_asymp_batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+        const std::complex<double> * z, std::complex<double> * res, int * status,
+        double tol=1e-16, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+// ##################################################
+// ##     double-double batch evaluation
+// ##
+// ##     As the batch functions above, but the result of point i is the
+// ##     unevaluated sum hi[i] + lo[i], the parts of the midpoint of the final arb
+// ##     ball rounded to double one after the other (per component, as for
+// ##     ComplexDD). The default tol 2^-106 asks for the full double-double
+// ##     accuracy, any tol works and a larger one stops earlier. A failed point
+// ##     gets NaN in hi and lo. There is no cache and no fast path, both hold
+// ##     doubles only.
+// ##################################################
+
+std::size_t zeta_dd_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        std::complex<double> * hi, std::ptrdiff_t hi_stride,
+        std::complex<double> * lo, std::ptrdiff_t lo_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=ResultType<ComplexDD>::tol, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=ResultType<ComplexDD>::init_prec(ZETA_DEFAULT_INIT_PREC),
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL) noexcept;
+
+std::size_t gamma_inc_dd_batch(std::size_t n,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * hi, std::ptrdiff_t hi_stride,
+        std::complex<double> * lo, std::ptrdiff_t lo_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=ResultType<ComplexDD>::tol, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=ResultType<ComplexDD>::init_prec(GAMMA_INC_DEFAULT_INIT_PREC),
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL) noexcept;
+
+std::size_t u_asymp_dd_batch(std::size_t n,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        const std::complex<double> * b, std::ptrdiff_t b_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * hi, std::ptrdiff_t hi_stride,
+        std::complex<double> * lo, std::ptrdiff_t lo_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double tol=ResultType<ComplexDD>::tol, unsigned int limit=5, bool verbose=false,
+        unsigned int init_prec=ResultType<ComplexDD>::init_prec(U_ASYMP_DEFAULT_INIT_PREC),
+        PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL) noexcept;
+
+// ##################################################
+// ##     real arguments
+// ##
+// ##     zeta_real(s, a) for a > 0 and gamma_inc_real(s, z) for z > 0 (or z = 0
+// ##     and s >= 0), where the result is real, evaluated with arb's real
+// ##     kernels arb_hurwitz_zeta and arb_hypgeom_gamma_upper instead of the
+// ##     complex ones. Outside this domain the return code is -2 (value error).
+// ##     Otherwise the settings, the escalation and the return codes are those
+// ##     of zeta and gamma_inc. The cache is shared with the complex functions,
+// ##     the fast path and the counters count as zeta and gamma_inc. The batch
+// ##     functions take strides in bytes, as the complex batch functions.
+// ##################################################
+
+int zeta_real(double s, double a, double * res, const Settings & settings=Settings());
+int gamma_inc_real(double s, double z, double * res, const Settings & settings=Settings());
+// throw std::runtime_error if the evaluation fails
+double zeta_real(double s, double a, const Settings & settings=Settings());
+double gamma_inc_real(double s, double z, const Settings & settings=Settings());
+
+std::size_t zeta_real_batch(std::size_t n,
+        const double * s, std::ptrdiff_t s_stride,
+        const double * a, std::ptrdiff_t a_stride,
+        double * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        const Settings & settings=Settings()) noexcept;
+std::size_t gamma_inc_real_batch(std::size_t n,
+        const double * s, std::ptrdiff_t s_stride,
+        const double * z, std::ptrdiff_t z_stride,
+        double * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        const Settings & settings=Settings()) noexcept;
+
+// ##################################################
+// ##     parallel batch evaluation
+// ##
+// ##     A pool of worker threads, each with its own arb temporaries. The points
+// ##     of a batch are split into chunks of chunk_size points, every thread starts
+// ##     on its share of the chunks and steals half of the remaining chunks of
+// ##     another thread once its own are done. This keeps all threads busy even
+// ##     if the cost per point varies by orders of magnitude (the precision
+// ##     escalation may double the precision up to limit times).
+// ##     The batch functions have the same semantics (and rel_err overloads) as
+// ##     the serial ones, one batch is processed at a time.
+// ##################################################
+
+class ParallelEvaluator {
+public:
+    // n_threads=0 uses one thread per hardware thread
+    explicit ParallelEvaluator(unsigned int n_threads=0, std::size_t chunk_size=4);
+    ~ParallelEvaluator();
+
+    unsigned int num_threads() const;
+
+    std::size_t zeta_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err, std::ptrdiff_t rel_err_stride,
+            const Settings & settings=Settings()) noexcept;
+    std::size_t zeta_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+    std::size_t zeta_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+            std::complex<double> * res, int * status,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=ZETA_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+    std::size_t gamma_inc_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err, std::ptrdiff_t rel_err_stride,
+            const Settings & settings=Settings()) noexcept;
+    std::size_t gamma_inc_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+    std::size_t gamma_inc_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+            std::complex<double> * res, int * status,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=GAMMA_INC_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+    std::size_t u_asymp_batch(std::size_t n,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            const std::complex<double> * b, std::ptrdiff_t b_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err, std::ptrdiff_t rel_err_stride,
+            const Settings & settings=Settings()) noexcept;
+    std::size_t u_asymp_batch(std::size_t n,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            const std::complex<double> * b, std::ptrdiff_t b_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+    std::size_t u_asymp_batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+            const std::complex<double> * z, std::complex<double> * res, int * status,
+            double tol=1e-16, unsigned int limit=5, bool verbose=false,
+            unsigned int init_prec=U_ASYMP_DEFAULT_INIT_PREC,
+            PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+        ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0) noexcept;
+
+private:
+    ParallelEvaluator(const ParallelEvaluator &) = delete;
+    ParallelEvaluator & operator=(const ParallelEvaluator &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+// ##################################################
+// ##     asynchronous evaluation
+// ##
+// ##     A pool of worker threads fed by a bounded queue, all evaluations use
+// ##     the settings given to the constructor. The submit functions return at
+// ##     once, either a std::future or, for the overloads taking done and user,
+// ##     nothing; done(user, ...) is then called from a worker thread when the
+// ##     point or batch is finished, it should return quickly and must not
+// ##     call wait or destroy the evaluator. The future of a single point throws
+// ##     std::runtime_error as the throwing functions do, the future of a batch
+// ##     gives the number of failed points (results, return codes and rel_err
+// ##     as for the batch functions, the arrays must stay valid until the batch
+// ##     is done). The rel_err of a point callback is written before done is
+// ##     called, so a stopped point (-3) comes with the bound of its estimate.
+// ##     A worker takes consecutive submissions of the same function from the
+// ##     queue until it holds group_size points and evaluates them as one batch,
+// ##     so small submissions share the arb temporaries (and the fast path lanes)
+// ##     and large batches are split into chunks of group_size points.
+// ##     Submitting blocks while the queue holds more than capacity points, a
+// ##     larger batch waits for the empty queue. A submission from a worker
+// ##     thread (a callback) never blocks, it is queued beyond capacity since
+// ##     the workers would otherwise wait for themselves. The destructor finishes the
+// ##     submitted work. An evaluator may be shared between threads.
+// ##################################################
+
+class AsyncEvaluator {
+public:
+    typedef void (*PointCallback)(void * user, std::complex<double> res, int status);
+    typedef void (*BatchCallback)(void * user, std::size_t n_fail);
+
+    // n_threads=0 uses one thread per hardware thread
+    explicit AsyncEvaluator(const Settings & settings=Settings(), unsigned int n_threads=0,
+                            std::size_t capacity=4096, std::size_t group_size=32);
+    ~AsyncEvaluator();
+
+    unsigned int num_threads() const;
+    const Settings & settings() const;
+    // the points submitted and not yet finished
+    std::size_t pending() const;
+    // block until all submitted points are finished
+    void wait();
+
+    std::future<std::complex<double> > zeta(std::complex<double> s, std::complex<double> a);
+    void zeta(std::complex<double> s, std::complex<double> a, PointCallback done, void * user,
+              double * rel_err=NULL);
+    std::future<std::size_t> zeta_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+    void zeta_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            BatchCallback done, void * user,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+
+    std::future<std::complex<double> > gamma_inc(std::complex<double> s, std::complex<double> z);
+    void gamma_inc(std::complex<double> s, std::complex<double> z, PointCallback done, void * user,
+                   double * rel_err=NULL);
+    std::future<std::size_t> gamma_inc_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+    void gamma_inc_batch(std::size_t n,
+            const std::complex<double> * s, std::ptrdiff_t s_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            BatchCallback done, void * user,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+
+    std::future<std::complex<double> > u_asymp(std::complex<double> a, std::complex<double> b,
+                                               std::complex<double> z);
+    void u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                 PointCallback done, void * user, double * rel_err=NULL);
+    std::future<std::size_t> u_asymp_batch(std::size_t n,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            const std::complex<double> * b, std::ptrdiff_t b_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+    void u_asymp_batch(std::size_t n,
+            const std::complex<double> * a, std::ptrdiff_t a_stride,
+            const std::complex<double> * b, std::ptrdiff_t b_stride,
+            const std::complex<double> * z, std::ptrdiff_t z_stride,
+            std::complex<double> * res, std::ptrdiff_t res_stride,
+            int * status, std::ptrdiff_t status_stride,
+            BatchCallback done, void * user,
+            double * rel_err=NULL, std::ptrdiff_t rel_err_stride=sizeof(double));
+
+private:
+    AsyncEvaluator(const AsyncEvaluator &) = delete;
+    AsyncEvaluator & operator=(const AsyncEvaluator &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
+
+// ##################################################
+// ##     interpolation tables
+// ##
+// ##     Piecewise Chebyshev interpolants of w -> zeta(s, w) or w -> gamma_inc(s, w)
+// ##     for fixed s over the rectangle lower <= w <= upper (real and imaginary
+// ##     part). The rectangle is split into nx*ny cells, on each cell the values at
+// ##     the (degree+1)^2 Chebyshev nodes are computed with arb (using settings,
+// ##     but not atol) and interpolated by a tensor product of Chebyshev polynomials. The
+// ##     function must be analytic on the rectangle, so it must not meet the
+// ##     branch cut (-inf, 0] of gamma_inc (unless s = 1, 2, ...) or of zeta
+// ##     (for integer s only the poles a = 0, -1, ...), and s = 1 is rejected
+// ##     for zeta. The interpolant is then compared with arb at the (degree+2)^2
+// ##     Chebyshev extrema of every cell (these include the cell boundary, where
+// ##     the interpolation error peaks), the construction fails if a deviation
+// ##     exceeds settings.tol plus the rounding error of the lookup, max_err is
+// ##     the largest relative deviation found. This verifies the table a
+// ##     posteriori, it is not a rigorous bound between the check points.
+// ##     A lookup checks the bounds and sums (degree+1)^2 terms, no arb involved.
+// ##     save writes a flat file (header and coefficients, native byte order)
+// ##     which the path constructor maps into memory without copying, so many
+// ##     processes share one table. Lookups are thread safe.
+// ##################################################
+
+enum TableFunction {TABLE_ZETA=1, TABLE_GAMMA_INC=2};
+
+#define CPLXFNC_TABLE_MAX_DEGREE 32
+
+class InterpolationTable {
+public:
+    // throws std::runtime_error for invalid arguments, a singularity in the rectangle,
+    // if an arb evaluation fails or if the verification does not meet settings.tol
+    InterpolationTable(TableFunction function, std::complex<double> s,
+                       std::complex<double> lower, std::complex<double> upper,
+                       unsigned int nx, unsigned int ny, unsigned int degree=12,
+                       const Settings & settings=Settings());
+    // maps a table written by save, throws std::runtime_error if the file is not a valid table
+    explicit InterpolationTable(const std::string & path);
+    ~InterpolationTable();
+
+    TableFunction function() const;
+    std::complex<double> s() const;
+    std::complex<double> lower() const;
+    std::complex<double> upper() const;
+    unsigned int nx() const;
+    unsigned int ny() const;
+    unsigned int degree() const;
+    // the largest relative error found by the verification
+    double max_err() const;
+    // true if the coefficients are mapped from a file
+    bool mapped() const;
+
+    // returns -2 if w is outside the rectangle (res is not set)
+    int operator()(std::complex<double> w, std::complex<double> * res) const noexcept;
+    // throws std::runtime_error if w is outside the rectangle
+    std::complex<double> operator()(std::complex<double> w) const;
+
+    // throws std::runtime_error if the file can not be written
+    void save(const std::string & path) const;
+
+private:
+    InterpolationTable(const InterpolationTable &) = delete;
+    InterpolationTable & operator=(const InterpolationTable &) = delete;
+
+    struct Impl;
+    Impl * impl;
+};
 
 }
 
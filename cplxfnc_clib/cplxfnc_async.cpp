@@ -0,0 +1,541 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "flint/flint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cplxfnc {
+
+namespace {
+
+enum AsyncFunction { ASYNC_ZETA, ASYNC_GAMMA_INC, ASYNC_U_ASYMP };
+
+// one submission, a single point keeps its arguments and result in the request
+struct Request {
+    Request(int function, std::size_t n)
+        : function(function), n(n), res(NULL), res_stride(0), status(NULL), status_stride(0),
+          rel_err(NULL), rel_err_stride(0), remaining(n), n_fail(0), point_done(NULL), batch_done(NULL),
+          user(NULL), single(false) {}
+
+    // the message of the throwing functions for a failed single point
+    std::string error_message() const;
+    // called by the worker which finished the last point
+    void finish();
+
+    int function;
+    std::size_t n;
+    const std::complex<double> * x[3];
+    std::ptrdiff_t x_stride[3];
+    std::complex<double> * res;
+    std::ptrdiff_t res_stride;
+    int * status;
+    std::ptrdiff_t status_stride;
+    double * rel_err;                       // may be NULL
+    std::ptrdiff_t rel_err_stride;
+
+    std::complex<double> args[3];
+    std::complex<double> value;
+    int value_status;
+
+    std::atomic<std::size_t> remaining;
+    std::atomic<std::size_t> n_fail;
+
+    // a future (promise) or a callback, depending on the submit function
+    std::promise<std::complex<double> > point_promise;
+    std::promise<std::size_t> batch_promise;
+    AsyncEvaluator::PointCallback point_done;
+    AsyncEvaluator::BatchCallback batch_done;
+    void * user;
+    bool single;
+};
+
+std::string Request::error_message() const
+{
+    std::ostringstream oss;
+    if (value_status == STOPPED) {
+        oss << "STOPPED: evaluation stopped by the deadline or cancellation of the settings";
+    } else if (value_status == -1) {
+        if (function == ASYNC_ZETA) {
+            oss << "LIMIT ERROR: zeta s=" << args[0] << " and a=" << args[1];
+        } else if (function == ASYNC_GAMMA_INC) {
+            oss << "LIMIT ERROR: gamma_inc s=" << args[0] << " and z=" << args[1];
+        } else {
+            oss << "LIMIT ERROR: u_asymp(a, b, z) with a=" << args[0] << " and b=" << args[1] << " and z=" << args[2];
+        }
+    } else if (function == ASYNC_GAMMA_INC) {
+        oss << "VALUE ERROR: gamma_inc, if Re(s) < 0 then z must not be zero!";
+    } else {
+        oss << "VALUE ERROR: u_asymp can not be evaluated for the given (z, tolerence). This is a property of u_asymp! Increase z or decrease tol!";
+    }
+    return oss.str();
+}
+
+void Request::finish()
+{
+    if (single) {
+        if (point_done != NULL) {
+            point_done(user, value, value_status);
+        } else if (value_status < 0) {
+            point_promise.set_exception(std::make_exception_ptr(std::runtime_error(error_message())));
+        } else {
+            point_promise.set_value(value);
+        }
+    } else {
+        if (batch_done != NULL) {
+            batch_done(user, n_fail);
+        } else {
+            batch_promise.set_value(n_fail);
+        }
+    }
+}
+
+// the points [begin, end) of a request
+struct Item {
+    std::shared_ptr<Request> req;
+    std::size_t begin;
+    std::size_t end;
+};
+
+// true on the worker threads of every AsyncEvaluator, their submissions
+// (from callbacks) must not wait for the queue the workers drain
+thread_local bool worker_thread = false;
+
+}
+
+struct AsyncEvaluator::Impl {
+    Impl(const Settings & settings, unsigned int n_threads, std::size_t capacity, std::size_t group_size);
+    ~Impl();
+
+    // queue the request in chunks of group_size points, blocks while the queue is full
+    // (unless called from a worker thread)
+    void submit(const std::shared_ptr<Request> & req);
+    std::shared_ptr<Request> single(int function, const std::complex<double> * args, unsigned int n_args);
+    void work();
+
+    Settings settings;
+    detail::Config cfg_zeta;
+    detail::Config cfg_gamma_inc;
+    detail::Config cfg_u_asymp;
+    std::size_t capacity;
+    std::size_t group_size;
+    std::vector<std::thread> threads;
+
+    mutable std::mutex m;                   // guards the members below
+    std::condition_variable cv_work;
+    std::condition_variable cv_space;
+    std::condition_variable cv_idle;
+    std::deque<Item> queue;
+    std::size_t queued;                     // points in the queue
+    std::size_t pending;                    // points submitted and not yet finished
+    bool shutdown;
+};
+
+AsyncEvaluator::Impl::Impl(const Settings & settings, unsigned int n_threads, std::size_t capacity,
+                           std::size_t group_size)
+    : settings(settings), cfg_zeta(settings, ZETA_DEFAULT_INIT_PREC),
+      cfg_gamma_inc(settings, GAMMA_INC_DEFAULT_INIT_PREC), cfg_u_asymp(settings, U_ASYMP_DEFAULT_INIT_PREC),
+      capacity(std::max<std::size_t>(capacity, 1)), group_size(std::max<std::size_t>(group_size, 1)),
+      queued(0), pending(0), shutdown(false)
+{
+    threads.reserve(n_threads);
+    for (unsigned int i = 0; i < n_threads; i++) {
+        threads.push_back(std::thread(&Impl::work, this));
+    }
+}
+
+AsyncEvaluator::Impl::~Impl()
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        shutdown = true;
+    }
+    cv_work.notify_all();
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+void AsyncEvaluator::Impl::submit(const std::shared_ptr<Request> & req)
+{
+    const std::size_t n = req->n;
+    if (n == 0) {
+        req->finish();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m);
+        if (!worker_thread) {
+            cv_space.wait(lock, [this, n]{ return (queued == 0) || (queued + n <= capacity); });
+        }
+        for (std::size_t begin = 0; begin < n; begin += group_size) {
+            Item item = {req, begin, std::min(begin + group_size, n)};
+            queue.push_back(item);
+        }
+        queued += n;
+        pending += n;
+    }
+    if (n > group_size) cv_work.notify_all();
+    else cv_work.notify_one();
+}
+
+std::shared_ptr<Request> AsyncEvaluator::Impl::single(int function, const std::complex<double> * args,
+                                                      unsigned int n_args)
+{
+    std::shared_ptr<Request> req(new Request(function, 1));
+    req->single = true;
+    for (unsigned int k = 0; k < n_args; k++) {
+        req->args[k] = args[k];
+        req->x[k] = &req->args[k];
+        req->x_stride[k] = 0;
+    }
+    req->res = &req->value;
+    req->status = &req->value_status;
+    return req;
+}
+
+void AsyncEvaluator::Impl::work()
+{
+    worker_thread = true;
+    {
+        detail::ZetaWorkspace zeta_ws;
+        detail::GammaIncWorkspace gamma_inc_ws;
+        detail::UAsympWorkspace u_asymp_ws;
+        // the points of the group gathered into contiguous arrays
+        std::vector<std::complex<double> > x0(group_size), x1(group_size), x2(group_size), res(group_size);
+        std::vector<int> status(group_size);
+        std::vector<double> rel_err(group_size);
+        std::vector<Item> items;
+        const std::ptrdiff_t c = sizeof(std::complex<double>);
+
+        while (1) {
+            std::size_t n = 0;
+            items.clear();
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv_work.wait(lock, [this]{ return shutdown || !queue.empty(); });
+                if (queue.empty()) break;
+                // consecutive items of the same function, at most group_size points
+                const int function = queue.front().req->function;
+                while (!queue.empty() && (queue.front().req->function == function) &&
+                       (n + queue.front().end - queue.front().begin <= group_size)) {
+                    items.push_back(queue.front());
+                    n += queue.front().end - queue.front().begin;
+                    queue.pop_front();
+                }
+                queued -= n;
+            }
+            cv_space.notify_all();
+
+            const int function = items[0].req->function;
+            std::size_t j = 0;
+            for (std::size_t k = 0; k < items.size(); k++) {
+                const Request & req = *items[k].req;
+                for (std::size_t i = items[k].begin; i < items[k].end; i++, j++) {
+                    x0[j] = detail::at(req.x[0], req.x_stride[0], i);
+                    x1[j] = detail::at(req.x[1], req.x_stride[1], i);
+                    if (function == ASYNC_U_ASYMP) x2[j] = detail::at(req.x[2], req.x_stride[2], i);
+                }
+            }
+
+            if (function == ASYNC_ZETA) {
+                detail::zeta_batch(zeta_ws, cfg_zeta, 0, n, x0.data(), c, x1.data(), c,
+                                   res.data(), c, status.data(), sizeof(int), rel_err.data(), sizeof(double));
+            } else if (function == ASYNC_GAMMA_INC) {
+                detail::gamma_inc_batch(gamma_inc_ws, cfg_gamma_inc, 0, n, x0.data(), c, x1.data(), c,
+                                        res.data(), c, status.data(), sizeof(int), rel_err.data(), sizeof(double));
+            } else {
+                detail::u_asymp_batch(u_asymp_ws, cfg_u_asymp, 0, n, x0.data(), c, x1.data(), c, x2.data(), c,
+                                      res.data(), c, status.data(), sizeof(int), rel_err.data(), sizeof(double));
+            }
+
+            j = 0;
+            for (std::size_t k = 0; k < items.size(); k++) {
+                Request & req = *items[k].req;
+                std::size_t fails = 0;
+                for (std::size_t i = items[k].begin; i < items[k].end; i++, j++) {
+                    detail::at(req.res, req.res_stride, i) = res[j];
+                    if (req.status != NULL) detail::at(req.status, req.status_stride, i) = status[j];
+                    if (req.rel_err != NULL) detail::at(req.rel_err, req.rel_err_stride, i) = rel_err[j];
+                    if (status[j] < 0) fails++;
+                }
+                req.n_fail += fails;
+                const std::size_t n_item = items[k].end - items[k].begin;
+                if (req.remaining.fetch_sub(n_item) == n_item) req.finish();
+            }
+            items.clear();
+
+            std::lock_guard<std::mutex> lock(m);
+            pending -= n;
+            if (pending == 0) cv_idle.notify_all();
+        }
+    }
+    // free the thread local caches of flint and arb before the thread ends
+    flint_cleanup();
+}
+
+AsyncEvaluator::AsyncEvaluator(const Settings & settings, unsigned int n_threads, std::size_t capacity,
+                               std::size_t group_size)
+{
+    if (n_threads == 0) {
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    impl = new Impl(settings, n_threads, capacity, group_size);
+}
+
+AsyncEvaluator::~AsyncEvaluator()
+{
+    delete impl;
+}
+
+unsigned int AsyncEvaluator::num_threads() const
+{
+    return impl->threads.size();
+}
+
+const Settings & AsyncEvaluator::settings() const
+{
+    return impl->settings;
+}
+
+std::size_t AsyncEvaluator::pending() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->pending;
+}
+
+void AsyncEvaluator::wait()
+{
+    std::unique_lock<std::mutex> lock(impl->m);
+    impl->cv_idle.wait(lock, [this]{ return impl->pending == 0; });
+}
+
+namespace {
+
+std::shared_ptr<Request> batch(int function, std::size_t n,
+                               const std::complex<double> * x0, std::ptrdiff_t x0_stride,
+                               const std::complex<double> * x1, std::ptrdiff_t x1_stride,
+                               const std::complex<double> * x2, std::ptrdiff_t x2_stride,
+                               std::complex<double> * res, std::ptrdiff_t res_stride,
+                               int * status, std::ptrdiff_t status_stride,
+                               double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req(new Request(function, n));
+    req->x[0] = x0;
+    req->x_stride[0] = x0_stride;
+    req->x[1] = x1;
+    req->x_stride[1] = x1_stride;
+    req->x[2] = x2;
+    req->x_stride[2] = x2_stride;
+    req->res = res;
+    req->res_stride = res_stride;
+    req->status = status;
+    req->status_stride = status_stride;
+    req->rel_err = rel_err;
+    req->rel_err_stride = rel_err_stride;
+    return req;
+}
+
+}
+
+// ##################################################
+// ##     Hurwitz Zeta function
+// ##################################################
+
+std::future<std::complex<double> > AsyncEvaluator::zeta(std::complex<double> s, std::complex<double> a)
+{
+    const std::complex<double> args[2] = {s, a};
+    std::shared_ptr<Request> req = impl->single(ASYNC_ZETA, args, 2);
+    std::future<std::complex<double> > f = req->point_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::zeta(std::complex<double> s, std::complex<double> a, PointCallback done, void * user,
+                          double * rel_err)
+{
+    const std::complex<double> args[2] = {s, a};
+    std::shared_ptr<Request> req = impl->single(ASYNC_ZETA, args, 2);
+    req->rel_err = rel_err;
+    req->point_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+std::future<std::size_t> AsyncEvaluator::zeta_batch(std::size_t n,
+                                                    const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                                    const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                                    std::complex<double> * res, std::ptrdiff_t res_stride,
+                                                    int * status, std::ptrdiff_t status_stride,
+                                                    double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_ZETA, n, s, s_stride, a, a_stride, NULL, 0,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    std::future<std::size_t> f = req->batch_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::zeta_batch(std::size_t n,
+                                const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                std::complex<double> * res, std::ptrdiff_t res_stride,
+                                int * status, std::ptrdiff_t status_stride,
+                                BatchCallback done, void * user,
+                                double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_ZETA, n, s, s_stride, a, a_stride, NULL, 0,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    req->batch_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+// ##################################################
+// ##     incomplete upper gamma function
+// ##################################################
+
+std::future<std::complex<double> > AsyncEvaluator::gamma_inc(std::complex<double> s, std::complex<double> z)
+{
+    const std::complex<double> args[2] = {s, z};
+    std::shared_ptr<Request> req = impl->single(ASYNC_GAMMA_INC, args, 2);
+    std::future<std::complex<double> > f = req->point_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::gamma_inc(std::complex<double> s, std::complex<double> z, PointCallback done, void * user,
+                               double * rel_err)
+{
+    const std::complex<double> args[2] = {s, z};
+    std::shared_ptr<Request> req = impl->single(ASYNC_GAMMA_INC, args, 2);
+    req->rel_err = rel_err;
+    req->point_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+std::future<std::size_t> AsyncEvaluator::gamma_inc_batch(std::size_t n,
+                                                         const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                                         const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                                         std::complex<double> * res, std::ptrdiff_t res_stride,
+                                                         int * status, std::ptrdiff_t status_stride,
+                                                         double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_GAMMA_INC, n, s, s_stride, z, z_stride, NULL, 0,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    std::future<std::size_t> f = req->batch_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::gamma_inc_batch(std::size_t n,
+                                     const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                     const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                     std::complex<double> * res, std::ptrdiff_t res_stride,
+                                     int * status, std::ptrdiff_t status_stride,
+                                     BatchCallback done, void * user,
+                                     double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_GAMMA_INC, n, s, s_stride, z, z_stride, NULL, 0,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    req->batch_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+// ##################################################
+// ##     Asymptotic series for the confluent hypergeometric function
+// ##################################################
+
+std::future<std::complex<double> > AsyncEvaluator::u_asymp(std::complex<double> a, std::complex<double> b,
+                                                           std::complex<double> z)
+{
+    const std::complex<double> args[3] = {a, b, z};
+    std::shared_ptr<Request> req = impl->single(ASYNC_U_ASYMP, args, 3);
+    std::future<std::complex<double> > f = req->point_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                             PointCallback done, void * user, double * rel_err)
+{
+    const std::complex<double> args[3] = {a, b, z};
+    std::shared_ptr<Request> req = impl->single(ASYNC_U_ASYMP, args, 3);
+    req->rel_err = rel_err;
+    req->point_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+std::future<std::size_t> AsyncEvaluator::u_asymp_batch(std::size_t n,
+                                                       const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                                       const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                                       const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                                       std::complex<double> * res, std::ptrdiff_t res_stride,
+                                                       int * status, std::ptrdiff_t status_stride,
+                                                       double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_U_ASYMP, n, a, a_stride, b, b_stride, z, z_stride,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    std::future<std::size_t> f = req->batch_promise.get_future();
+    impl->submit(req);
+    return f;
+}
+
+void AsyncEvaluator::u_asymp_batch(std::size_t n,
+                                   const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                   const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                   const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                   std::complex<double> * res, std::ptrdiff_t res_stride,
+                                   int * status, std::ptrdiff_t status_stride,
+                                   BatchCallback done, void * user,
+                                   double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::shared_ptr<Request> req = batch(ASYNC_U_ASYMP, n, a, a_stride, b, b_stride, z, z_stride,
+                                         res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    req->batch_done = done;
+    req->user = user;
+    impl->submit(req);
+}
+
+} /* namespace cplxfnc */
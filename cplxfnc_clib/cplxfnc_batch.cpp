@@ -0,0 +1,343 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     the batch loops
+// ##################################################
+
+std::size_t detail::zeta_batch(ZetaWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+                               const std::complex<double> * s, std::ptrdiff_t s_stride,
+                               const std::complex<double> * a, std::ptrdiff_t a_stride,
+                               std::complex<double> * res, std::ptrdiff_t res_stride,
+                               int * status, std::ptrdiff_t status_stride,
+                               double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::size_t n_fail = 0;
+    if (cfg.fast != NULL) {
+        FunctionStats & stats = thread_stats().fn[STATS_ZETA];
+        // the fast path on blocks of FAST_LANES points, the rejected ones go to arb
+        std::complex<double> s_blk[FAST_LANES], a_blk[FAST_LANES], res_blk[FAST_LANES];
+        bool ok[FAST_LANES];
+        for (std::size_t i0 = begin; i0 < end; i0 += FAST_LANES) {
+            const std::size_t m = std::min(FAST_LANES, end - i0);
+            for (std::size_t l = 0; l < m; l++) {
+                s_blk[l] = at(s, s_stride, i0 + l);
+                a_blk[l] = at(a, a_stride, i0 + l);
+            }
+            zeta_fast(m, s_blk, a_blk, cfg.err_bits_ref, res_blk, ok);
+            for (std::size_t l = 0; l < m; l++) {
+                int st = 0;
+                bool shortcut = true;
+                if (ok[l]) {
+                    at(res, res_stride, i0 + l) = res_blk[l];
+                    cfg.fast->count(true);
+                    stats.add(FunctionStats::CALLS);
+                } else if (stop_point(cfg, res, res_stride, status, status_stride, i0 + l, rel_err, rel_err_stride)) {
+                    n_fail++;
+                    continue;
+                } else {
+                    st = zeta(ws, s_blk[l], a_blk[l], &at(res, res_stride, i0 + l), cfg, true);
+                    shortcut = ws.shortcut;
+                }
+                set_status(res, res_stride, status, status_stride, i0 + l, st);
+                set_rel_error(rel_err, rel_err_stride, i0 + l, st, shortcut, ws.err_bits, cfg.tol);
+                if (st < 0) n_fail++;
+            }
+        }
+        return n_fail;
+    }
+    for (std::size_t i = begin; i < end; i++) {
+        if (stop_point(cfg, res, res_stride, status, status_stride, i, rel_err, rel_err_stride)) {
+            n_fail++;
+            continue;
+        }
+        int st = zeta(ws, at(s, s_stride, i), at(a, a_stride, i), &at(res, res_stride, i), cfg);
+        set_status(res, res_stride, status, status_stride, i, st);
+        set_rel_error(rel_err, rel_err_stride, i, st, ws.shortcut, ws.err_bits, cfg.tol);
+        if (st < 0) n_fail++;
+    }
+    return n_fail;
+}
+
+std::size_t detail::gamma_inc_batch(GammaIncWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+                                    const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                    const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                    std::complex<double> * res, std::ptrdiff_t res_stride,
+                                    int * status, std::ptrdiff_t status_stride,
+                               double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::size_t n_fail = 0;
+    if (cfg.fast != NULL) {
+        FunctionStats & stats = thread_stats().fn[STATS_GAMMA_INC];
+        // the fast path on blocks of FAST_LANES points, the rejected ones go to arb
+        std::complex<double> s_blk[FAST_LANES], z_blk[FAST_LANES], res_blk[FAST_LANES];
+        bool ok[FAST_LANES];
+        for (std::size_t i0 = begin; i0 < end; i0 += FAST_LANES) {
+            const std::size_t m = std::min(FAST_LANES, end - i0);
+            for (std::size_t l = 0; l < m; l++) {
+                s_blk[l] = at(s, s_stride, i0 + l);
+                z_blk[l] = at(z, z_stride, i0 + l);
+            }
+            gamma_inc_fast(m, s_blk, z_blk, cfg.err_bits_ref, res_blk, ok);
+            for (std::size_t l = 0; l < m; l++) {
+                int st = 0;
+                bool shortcut = true;
+                if (ok[l]) {
+                    at(res, res_stride, i0 + l) = res_blk[l];
+                    cfg.fast->count(true);
+                    stats.add(FunctionStats::CALLS);
+                } else if (stop_point(cfg, res, res_stride, status, status_stride, i0 + l, rel_err, rel_err_stride)) {
+                    n_fail++;
+                    continue;
+                } else {
+                    st = gamma_inc(ws, s_blk[l], z_blk[l], &at(res, res_stride, i0 + l), cfg, true);
+                    shortcut = ws.shortcut;
+                }
+                set_status(res, res_stride, status, status_stride, i0 + l, st);
+                set_rel_error(rel_err, rel_err_stride, i0 + l, st, shortcut, ws.err_bits, cfg.tol);
+                if (st < 0) n_fail++;
+            }
+        }
+        return n_fail;
+    }
+    for (std::size_t i = begin; i < end; i++) {
+        if (stop_point(cfg, res, res_stride, status, status_stride, i, rel_err, rel_err_stride)) {
+            n_fail++;
+            continue;
+        }
+        int st = gamma_inc(ws, at(s, s_stride, i), at(z, z_stride, i), &at(res, res_stride, i), cfg);
+        set_status(res, res_stride, status, status_stride, i, st);
+        set_rel_error(rel_err, rel_err_stride, i, st, ws.shortcut, ws.err_bits, cfg.tol);
+        if (st < 0) n_fail++;
+    }
+    return n_fail;
+}
+
+std::size_t detail::u_asymp_batch(UAsympWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+                                  const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                  const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                  const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                  std::complex<double> * res, std::ptrdiff_t res_stride,
+                                  int * status, std::ptrdiff_t status_stride,
+                               double * rel_err, std::ptrdiff_t rel_err_stride)
+{
+    std::size_t n_fail = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        if (stop_point(cfg, res, res_stride, status, status_stride, i, rel_err, rel_err_stride)) {
+            n_fail++;
+            continue;
+        }
+        int st = u_asymp(ws, at(a, a_stride, i), at(b, b_stride, i), at(z, z_stride, i),
+                         &at(res, res_stride, i), cfg);
+        set_status(res, res_stride, status, status_stride, i, st);
+        set_rel_error(rel_err, rel_err_stride, i, st, ws.shortcut, ws.err_bits, cfg.tol);
+        if (st < 0) n_fail++;
+    }
+    return n_fail;
+}
+
+// ##################################################
+// ##     Hurwitz Zeta function
+// ##################################################
+
+std::size_t zeta_batch(std::size_t n,
+                       const std::complex<double> * s, std::ptrdiff_t s_stride,
+                       const std::complex<double> * a, std::ptrdiff_t a_stride,
+                       std::complex<double> * res, std::ptrdiff_t res_stride,
+                       int * status, std::ptrdiff_t status_stride,
+                       double * rel_err, std::ptrdiff_t rel_err_stride,
+                       const Settings & settings) noexcept
+{
+    // the workspace lives on the stack, no evaluator is allocated
+    detail::ZetaWorkspace ws;
+    return detail::zeta_batch(ws, detail::Config(settings, ZETA_DEFAULT_INIT_PREC), 0, n,
+            s, s_stride, a, a_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t zeta_batch(std::size_t n,
+                       const std::complex<double> * s, std::ptrdiff_t s_stride,
+                       const std::complex<double> * a, std::ptrdiff_t a_stride,
+                       std::complex<double> * res, std::ptrdiff_t res_stride,
+                       int * status, std::ptrdiff_t status_stride,
+                       double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                       PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return zeta_batch(n, s, s_stride, a, a_stride, res, res_stride, status, status_stride, NULL, 0,
+            Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t zeta_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+                       std::complex<double> * res, int * status,
+                       double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                       PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return zeta_batch(n, s, c, a, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+std::size_t ZetaEvaluator::batch(std::size_t n,
+                                 const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                 const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                 std::complex<double> * res, std::ptrdiff_t res_stride,
+                                 int * status, std::ptrdiff_t status_stride,
+                                 double * rel_err, std::ptrdiff_t rel_err_stride) noexcept
+{
+    return detail::zeta_batch(impl->ws, impl->cfg, 0, n,
+            s, s_stride, a, a_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t ZetaEvaluator::batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+                                 std::complex<double> * res, int * status) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return batch(n, s, c, a, c, res, c, status, sizeof(int));
+}
+
+// ##################################################
+// ##     incomplete upper gamma function
+// ##################################################
+
+std::size_t gamma_inc_batch(std::size_t n,
+                            const std::complex<double> * s, std::ptrdiff_t s_stride,
+                            const std::complex<double> * z, std::ptrdiff_t z_stride,
+                            std::complex<double> * res, std::ptrdiff_t res_stride,
+                            int * status, std::ptrdiff_t status_stride,
+                            double * rel_err, std::ptrdiff_t rel_err_stride,
+                            const Settings & settings) noexcept
+{
+    // the workspace lives on the stack, no evaluator is allocated
+    detail::GammaIncWorkspace ws;
+    return detail::gamma_inc_batch(ws, detail::Config(settings, GAMMA_INC_DEFAULT_INIT_PREC), 0, n,
+            s, s_stride, z, z_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t gamma_inc_batch(std::size_t n,
+                            const std::complex<double> * s, std::ptrdiff_t s_stride,
+                            const std::complex<double> * z, std::ptrdiff_t z_stride,
+                            std::complex<double> * res, std::ptrdiff_t res_stride,
+                            int * status, std::ptrdiff_t status_stride,
+                            double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                            PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return gamma_inc_batch(n, s, s_stride, z, z_stride, res, res_stride, status, status_stride, NULL, 0,
+            Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t gamma_inc_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                            std::complex<double> * res, int * status,
+                            double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                            PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return gamma_inc_batch(n, s, c, z, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+std::size_t GammaIncEvaluator::batch(std::size_t n,
+                                     const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                     const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                     std::complex<double> * res, std::ptrdiff_t res_stride,
+                                     int * status, std::ptrdiff_t status_stride,
+                                     double * rel_err, std::ptrdiff_t rel_err_stride) noexcept
+{
+    return detail::gamma_inc_batch(impl->ws, impl->cfg, 0, n,
+            s, s_stride, z, z_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t GammaIncEvaluator::batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                                     std::complex<double> * res, int * status) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return batch(n, s, c, z, c, res, c, status, sizeof(int));
+}
+
+// ##################################################
+// ##     Asymptotic series for the confluent hypergeometric function
+// ##################################################
+
+std::size_t u_asymp_batch(std::size_t n,
+                          const std::complex<double> * a, std::ptrdiff_t a_stride,
+                          const std::complex<double> * b, std::ptrdiff_t b_stride,
+                          const std::complex<double> * z, std::ptrdiff_t z_stride,
+                          std::complex<double> * res, std::ptrdiff_t res_stride,
+                          int * status, std::ptrdiff_t status_stride,
+                          double * rel_err, std::ptrdiff_t rel_err_stride,
+                          const Settings & settings) noexcept
+{
+    // the workspace lives on the stack, no evaluator is allocated
+    detail::UAsympWorkspace ws;
+    return detail::u_asymp_batch(ws, detail::Config(settings, U_ASYMP_DEFAULT_INIT_PREC), 0, n,
+            a, a_stride, b, b_stride, z, z_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t u_asymp_batch(std::size_t n,
+                          const std::complex<double> * a, std::ptrdiff_t a_stride,
+                          const std::complex<double> * b, std::ptrdiff_t b_stride,
+                          const std::complex<double> * z, std::ptrdiff_t z_stride,
+                          std::complex<double> * res, std::ptrdiff_t res_stride,
+                          int * status, std::ptrdiff_t status_stride,
+                          double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                          PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return u_asymp_batch(n, a, a_stride, b, b_stride, z, z_stride, res, res_stride, status, status_stride, NULL, 0,
+            Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t u_asymp_batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+                          const std::complex<double> * z, std::complex<double> * res, int * status,
+                          double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                          PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return u_asymp_batch(n, a, c, b, c, z, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+std::size_t UAsympEvaluator::batch(std::size_t n,
+                                   const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                   const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                   const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                   std::complex<double> * res, std::ptrdiff_t res_stride,
+                                   int * status, std::ptrdiff_t status_stride,
+                                   double * rel_err, std::ptrdiff_t rel_err_stride) noexcept
+{
+    return detail::u_asymp_batch(impl->ws, impl->cfg, 0, n,
+            a, a_stride, b, b_stride, z, z_stride, res, res_stride, status, status_stride, rel_err, rel_err_stride);
+}
+
+std::size_t UAsympEvaluator::batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+                                   const std::complex<double> * z, std::complex<double> * res, int * status) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return batch(n, a, c, b, c, z, c, res, c, status, sizeof(int));
+}
+
+} /* namespace cplxfnc */
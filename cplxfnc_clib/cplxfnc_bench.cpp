@@ -0,0 +1,726 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+/*
+ *  benchmarks for the cplxfnc library
+ *
+ *  scaling of the parallel evaluator with the number of threads for a batch of
+ *  Hurwitz zeta arguments whose cost differs by orders of magnitude, compared
+ *  to a static split of the batch (one chunk per thread, nothing to steal)
+ *
+ *  arb evaluations per call and time of the escalation policies
+ *
+ *  HurwitzZeta (precomputed data for fixed s) against zeta for many a
+ *
+ *  zeta and gamma_inc with and without the double precision fast path
+ *
+ *  with --json: throughput, latency (p50, p99) and the distribution of the final
+ *  precision and of the number of arb evaluations per call of zeta, gamma_inc and
+ *  u_asymp over named argument regions, written to stdout as JSON
+ */
+
+#include "cplxfnc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+double time_zeta_batch(cplxfnc::ParallelEvaluator & pe,
+                       const std::vector<std::complex<double> > & s,
+                       const std::vector<std::complex<double> > & a,
+                       std::vector<std::complex<double> > & res,
+                       std::vector<int> & status)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    pe.zeta_batch(s.size(), s.data(), a.data(), res.data(), status.data());
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int bench_parallel_scaling(std::size_t n, unsigned int max_threads)
+{
+    std::cout << "\nparallel scaling, zeta(s, a) with mixed cost, n=" << n << "\n";
+
+    // Im(a) spans 1 ... 1e24, the cost per point varies accordingly
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), a(n), res(n);
+    std::vector<int> status(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = 1.2 + 0.5*u(gen)*I;
+        a[i] = 1. + std::pow(10., 24*u(gen))*I;
+    }
+
+    double t_serial = 0;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "time [s]" << std::setw(14) << "calls/s"
+              << std::setw(12) << "speedup" << std::setw(18) << "static speedup\n";
+    for (unsigned int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        cplxfnc::ParallelEvaluator pe(n_threads);
+        time_zeta_batch(pe, s, a, res, status);    // warm up
+        double t = time_zeta_batch(pe, s, a, res, status);
+        if (n_threads == 1) t_serial = t;
+
+        cplxfnc::ParallelEvaluator pe_static(n_threads, (n + n_threads - 1) / n_threads);
+        double t_static = time_zeta_batch(pe_static, s, a, res, status);
+
+        std::cout << std::setw(8) << n_threads << std::setw(14) << std::setprecision(4) << t
+                  << std::setw(14) << std::setprecision(0) << std::fixed << n / t << std::defaultfloat
+                  << std::setw(12) << std::setprecision(3) << t_serial / t
+                  << std::setw(17) << t_serial / t_static << "\n";
+    }
+    return 0;
+}
+
+int bench_escalation_policies(std::size_t n)
+{
+    std::cout << "\nescalation policies, gamma_inc(s, z) for large |z|, init_prec=12, n=" << n << "\n";
+
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), z(n), res(n);
+    std::vector<int> status(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = -1. + 2*u(gen) + u(gen)*I;
+        z[i] = std::pow(10., 2 + 6*u(gen)) * std::exp(I*(u(gen) - 0.5));
+    }
+
+    cplxfnc::DoublingPolicy doubling;
+    cplxfnc::DeficitPolicy deficit;
+    cplxfnc::EscalationPolicy * policies[2] = {&doubling, &deficit};
+    const char * names[2] = {"doubling", "deficit"};
+
+    std::cout << std::setw(10) << "policy" << std::setw(14) << "time [s]" << std::setw(14) << "calls/s"
+              << std::setw(18) << "attempts/call" << std::setw(10) << "failures\n";
+    for (unsigned int i = 0; i < 2; i++) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res.data(), status.data(), 1e-16, 10, false, 12,
+                                 NULL, policies[i]);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        double t = std::chrono::duration<double>(t1 - t0).count();
+        std::cout << std::setw(10) << names[i] << std::setw(14) << std::setprecision(4) << t
+                  << std::setw(14) << std::setprecision(0) << std::fixed << n / t << std::defaultfloat
+                  << std::setw(18) << std::setprecision(3) << double(policies[i]->attempts()) / policies[i]->calls()
+                  << std::setw(9) << policies[i]->failures() << "\n";
+    }
+    return 0;
+}
+
+int bench_hurwitz_zeta(std::size_t n)
+{
+    std::cout << "\nHurwitzZeta against zeta, fixed s, n=" << n << "\n";
+
+    const std::complex<double> I(0, 1);
+    const std::complex<double> s = 1.2 + I;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > a(n), res(n), res_check(n);
+    std::vector<int> status(n);
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] = 10*u(gen) + 100*(u(gen) - 0.5)*I;
+    }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    cplxfnc::zeta_batch(n, &s, 0, a.data(), sizeof(std::complex<double>), res_check.data(),
+                        sizeof(std::complex<double>), status.data(), sizeof(int));
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    cplxfnc::HurwitzZeta hz(s);
+    hz.batch(n, a.data(), res.data(), status.data());
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double t_zeta = std::chrono::duration<double>(t1 - t0).count();
+    double t_hz = std::chrono::duration<double>(t2 - t1).count();
+    double d_max = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        d_max = std::max(d_max, std::abs(res[i] - res_check[i]) / std::abs(res_check[i]));
+    }
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "calls/s\n";
+    std::cout << std::setw(14) << "zeta" << std::setw(14) << std::setprecision(4) << t_zeta
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_zeta << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "HurwitzZeta" << std::setw(14) << std::setprecision(4) << t_hz
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_hz << std::defaultfloat << "\n";
+    std::cout << "speedup " << std::setprecision(3) << t_zeta / t_hz
+              << ", max rel. difference " << d_max << "\n";
+
+    // real a, on the grid of Taylor polynomials (set up included)
+    for (std::size_t i = 0; i < n; i++) a[i] = 10*u(gen);
+    t0 = std::chrono::steady_clock::now();
+    cplxfnc::zeta_batch(n, &s, 0, a.data(), sizeof(std::complex<double>), res_check.data(),
+                        sizeof(std::complex<double>), status.data(), sizeof(int));
+    t1 = std::chrono::steady_clock::now();
+    cplxfnc::HurwitzZeta hz_grid(s, cplxfnc::Settings(), n);
+    hz_grid.batch(n, a.data(), res.data(), status.data());
+    t2 = std::chrono::steady_clock::now();
+    t_zeta = std::chrono::duration<double>(t1 - t0).count();
+    t_hz = std::chrono::duration<double>(t2 - t1).count();
+    d_max = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        d_max = std::max(d_max, std::abs(res[i] - res_check[i]) / std::abs(res_check[i]));
+    }
+    std::cout << "real a in (0, 10], grid: speedup " << t_zeta / t_hz << ", max rel. difference " << d_max << "\n";
+    return 0;
+}
+
+int bench_fast_path(std::size_t n, double tol)
+{
+    std::cout << "\ndouble precision fast path, tol=" << tol << ", n=" << n << "\n";
+
+    // real a > 0 for zeta and Re(z) > 0, |z| >= 20 for gamma_inc, mostly in the domain of the kernels
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), a(n), sg(n), z(n), res(n), res_check(n);
+    std::vector<int> status(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = 0.5 + 3*u(gen) + 20*(u(gen) - 0.5)*I;
+        a[i] = 0.1 + 5*u(gen);
+        sg[i] = -2. + 4*u(gen) + 4*(u(gen) - 0.5)*I;
+        z[i] = (20. + 80*u(gen)) * std::exp(I*1.4*(u(gen) - 0.5));
+    }
+
+    std::cout << std::setw(10) << "function" << std::setw(14) << "arb [s]" << std::setw(14) << "fast [s]"
+              << std::setw(10) << "speedup" << std::setw(12) << "fast tier" << std::setw(18) << "max rel. diff\n";
+    for (int f = 0; f < 2; f++) {
+        const std::vector<std::complex<double> > & x = f ? sg : s;
+        const std::vector<std::complex<double> > & y = f ? z : a;
+        cplxfnc::FastPath fast;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (f) cplxfnc::gamma_inc_batch(n, x.data(), y.data(), res_check.data(), status.data(), tol, 5);
+        else   cplxfnc::zeta_batch(n, x.data(), y.data(), res_check.data(), status.data(), tol, 5);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        if (f) cplxfnc::gamma_inc_batch(n, x.data(), y.data(), res.data(), status.data(), tol, 5, false,
+                                        GAMMA_INC_DEFAULT_INIT_PREC, NULL, NULL, NULL, &fast);
+        else   cplxfnc::zeta_batch(n, x.data(), y.data(), res.data(), status.data(), tol, 5, false,
+                                   ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, &fast);
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+        double t_arb = std::chrono::duration<double>(t1 - t0).count();
+        double t_fast = std::chrono::duration<double>(t2 - t1).count();
+        double d_max = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            d_max = std::max(d_max, std::abs(res[i] - res_check[i]) / std::abs(res_check[i]));
+        }
+        std::cout << std::setw(10) << (f ? "gamma_inc" : "zeta") << std::setw(14) << std::setprecision(4) << t_arb
+                  << std::setw(14) << t_fast << std::setw(10) << std::setprecision(3) << t_arb / t_fast
+                  << std::setw(11) << std::setprecision(3) << 100. * fast.fast() / n << "%"
+                  << std::setw(17) << d_max << "\n";
+    }
+    return 0;
+}
+
+int bench_interpolation_table(std::size_t n)
+{
+    std::cout << "\ninterpolation table against gamma_inc, fixed s, n=" << n << "\n";
+
+    const std::complex<double> I(0, 1);
+    const std::complex<double> s = 0.5 + 0.2*I;
+    const std::complex<double> lower = 1. - 2.*I, upper = 5. + 2.*I;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > z(n), res(n), res_check(n);
+    std::vector<int> status(n);
+    for (std::size_t i = 0; i < n; i++) {
+        z[i] = lower + 4*u(gen) + 4*u(gen)*I;
+    }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    cplxfnc::InterpolationTable table(cplxfnc::TABLE_GAMMA_INC, s, lower, upper, 8, 8, 12, cplxfnc::Settings(1e-12));
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    cplxfnc::gamma_inc_batch(n, &s, 0, z.data(), sizeof(std::complex<double>), res_check.data(),
+                             sizeof(std::complex<double>), status.data(), sizeof(int));
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; i++) table(z[i], &res[i]);
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+    double t_build = std::chrono::duration<double>(t1 - t0).count();
+    double t_arb = std::chrono::duration<double>(t2 - t1).count();
+    double t_table = std::chrono::duration<double>(t3 - t2).count();
+    double d_max = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        d_max = std::max(d_max, std::abs(res[i] - res_check[i]) / std::abs(res_check[i]));
+    }
+    std::cout << "build (8x8 cells, degree 12) " << std::setprecision(4) << t_build << " s, max_err "
+              << table.max_err() << "\n";
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "calls/s\n";
+    std::cout << std::setw(14) << "gamma_inc" << std::setw(14) << std::setprecision(4) << t_arb
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_arb << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "table" << std::setw(14) << std::setprecision(4) << t_table
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_table << std::defaultfloat << "\n";
+    std::cout << "speedup " << std::setprecision(3) << t_arb / t_table
+              << ", max rel. difference " << d_max << "\n";
+    return 0;
+}
+
+int bench_gamma_inc_sequence(std::size_t n)
+{
+    std::cout << "\ngamma_inc_sequence against gamma_inc(s+k, z), k < 100, " << n / 100 << " sequences\n";
+
+    const std::size_t K = 100;
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    const std::size_t m = std::max<std::size_t>(n / K, 1);
+    std::vector<std::complex<double> > s(m), z(m), res(K), res_check(K);
+    for (std::size_t i = 0; i < m; i++) {
+        s[i] = -20. + 40*u(gen) + 10*(u(gen) - 0.5)*I;
+        z[i] = (0.1 + 30*u(gen)) * std::exp(I*2.*(u(gen) - 0.5));
+    }
+
+    double t_scalar = 0, t_seq = 0, d_max = 0;
+    std::size_t anchors = 0, n_fail = 0;
+    for (std::size_t i = 0; i < m; i++) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < K; k++) {
+            if (cplxfnc::gamma_inc(s[i] + double(k), z[i], &res_check[k], 1e-16, 5, false)) n_fail++;
+        }
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        std::size_t a;
+        if (cplxfnc::gamma_inc_sequence(s[i], z[i], K, res.data(), cplxfnc::Settings(), &a)) n_fail++;
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        t_scalar += std::chrono::duration<double>(t1 - t0).count();
+        t_seq += std::chrono::duration<double>(t2 - t1).count();
+        anchors += a;
+        for (std::size_t k = 0; k < K; k++) {
+            d_max = std::max(d_max, std::abs(res[k] - res_check[k]) / std::abs(res_check[k]));
+        }
+    }
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "values/s\n";
+    std::cout << std::setw(14) << "gamma_inc" << std::setw(14) << std::setprecision(4) << t_scalar
+              << std::setw(13) << std::setprecision(0) << std::fixed << m*K / t_scalar << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "sequence" << std::setw(14) << std::setprecision(4) << t_seq
+              << std::setw(13) << std::setprecision(0) << std::fixed << m*K / t_seq << std::defaultfloat << "\n";
+    std::cout << "speedup " << std::setprecision(3) << t_scalar / t_seq << ", anchors per sequence "
+              << double(anchors) / m << ", max rel. difference " << d_max << ", failures " << n_fail << "\n";
+    return 0;
+}
+
+int bench_zeta_sequence(std::size_t n)
+{
+    std::cout << "\nzeta_sequence against zeta(s, a+k), k < 100, " << n / 100 << " sequences\n";
+
+    const std::size_t K = 100;
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    const std::size_t m = std::max<std::size_t>(n / K, 1);
+    std::vector<std::complex<double> > s(m), a(m), res(K), res_check(K);
+    for (std::size_t i = 0; i < m; i++) {
+        s[i] = 1.1 + 10*u(gen) + 20*(u(gen) - 0.5)*I;
+        a[i] = 0.1 + 5*u(gen) + 10*(u(gen) - 0.5)*I;
+    }
+
+    double t_scalar = 0, t_seq = 0, d_max = 0;
+    std::size_t anchors = 0, n_fail = 0;
+    for (std::size_t i = 0; i < m; i++) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < K; k++) {
+            if (cplxfnc::zeta(s[i], a[i] + double(k), &res_check[k], 1e-16, 5, false)) n_fail++;
+        }
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        std::size_t an;
+        if (cplxfnc::zeta_sequence(s[i], a[i], K, res.data(), cplxfnc::Settings(), &an)) n_fail++;
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        t_scalar += std::chrono::duration<double>(t1 - t0).count();
+        t_seq += std::chrono::duration<double>(t2 - t1).count();
+        anchors += an;
+        for (std::size_t k = 0; k < K; k++) {
+            d_max = std::max(d_max, std::abs(res[k] - res_check[k]) / std::abs(res_check[k]));
+        }
+    }
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "values/s\n";
+    std::cout << std::setw(14) << "zeta" << std::setw(14) << std::setprecision(4) << t_scalar
+              << std::setw(13) << std::setprecision(0) << std::fixed << m*K / t_scalar << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "sequence" << std::setw(14) << std::setprecision(4) << t_seq
+              << std::setw(13) << std::setprecision(0) << std::fixed << m*K / t_seq << std::defaultfloat << "\n";
+    std::cout << "speedup " << std::setprecision(3) << t_scalar / t_seq << ", anchors per sequence "
+              << double(anchors) / m << ", max rel. difference " << d_max << ", failures " << n_fail << "\n";
+    return 0;
+}
+
+int bench_dd_batch(std::size_t n)
+{
+    std::cout << "\ngamma_inc_batch against gamma_inc_dd_batch, " << n << " points\n";
+
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), z(n), res(n), hi(n), lo(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = -20. + 40*u(gen) + 10*(u(gen) - 0.5)*I;
+        z[i] = (0.1 + 30*u(gen)) * std::exp(I*2.*(u(gen) - 0.5));
+    }
+
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::size_t n_fail = cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res.data(), NULL);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    std::size_t n_fail_dd = cplxfnc::gamma_inc_dd_batch(n, s.data(), c, z.data(), c, hi.data(), c, lo.data(), c,
+                                                        NULL, 0);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    double t_d = std::chrono::duration<double>(t1 - t0).count();
+    double t_dd = std::chrono::duration<double>(t2 - t1).count();
+    double d_max = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (!std::isnan(hi[i].real()) && !std::isnan(res[i].real())) {
+            d_max = std::max(d_max, std::abs(hi[i] - res[i]) / std::abs(hi[i]));
+        }
+    }
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "values/s\n";
+    std::cout << std::setw(14) << "double" << std::setw(14) << std::setprecision(4) << t_d
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_d << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "double-double" << std::setw(14) << std::setprecision(4) << t_dd
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_dd << std::defaultfloat << "\n";
+    std::cout << "cost ratio " << std::setprecision(3) << t_dd / t_d << ", max rel. difference of hi "
+              << d_max << ", failures " << n_fail << " / " << n_fail_dd << "\n";
+    return 0;
+}
+
+int bench_real_batch(std::size_t n)
+{
+    std::cout << "\ngamma_inc_batch against gamma_inc_real_batch on the real line, " << n << " points\n";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), z(n), res(n);
+    std::vector<double> s_re(n), z_re(n), res_re(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s_re[i] = -20. + 40*u(gen);
+        z_re[i] = 0.1 + 30*u(gen);
+        s[i] = s_re[i];
+        z[i] = z_re[i];
+    }
+
+    const std::ptrdiff_t d = sizeof(double);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::size_t n_fail = cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res.data(), NULL);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    std::size_t n_fail_re = cplxfnc::gamma_inc_real_batch(n, s_re.data(), d, z_re.data(), d, res_re.data(), d,
+                                                          NULL, 0);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    double t_c = std::chrono::duration<double>(t1 - t0).count();
+    double t_r = std::chrono::duration<double>(t2 - t1).count();
+    double d_max = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (!std::isnan(res_re[i]) && !std::isnan(res[i].real())) {
+            d_max = std::max(d_max, std::abs(res_re[i] - res[i]) / std::abs(res[i]));
+        }
+    }
+    std::cout << std::setw(14) << "method" << std::setw(14) << "time [s]" << std::setw(14) << "values/s\n";
+    std::cout << std::setw(14) << "complex" << std::setw(14) << std::setprecision(4) << t_c
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_c << std::defaultfloat << "\n";
+    std::cout << std::setw(14) << "real" << std::setw(14) << std::setprecision(4) << t_r
+              << std::setw(13) << std::setprecision(0) << std::fixed << n / t_r << std::defaultfloat << "\n";
+    std::cout << "speedup " << std::setprecision(3) << t_c / t_r << ", max rel. difference "
+              << d_max << ", failures " << n_fail << " / " << n_fail_re << "\n";
+    return 0;
+}
+
+int bench_special_values(std::size_t n)
+{
+    std::cout << "\nspecial values against nearby generic arguments, " << n << " points\n";
+
+    // integer s (finite sum) and a = 1 (Riemann zeta), the generic arguments are shifted by 1e-12
+    const std::complex<double> I(0, 1);
+    const double shift = 1e-12;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), s_g(n), z(n), a(n), a_g(n), res(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = double(2 + int(20*u(gen)));
+        s_g[i] = s[i] + shift;
+        z[i] = (0.1 + 30*u(gen)) * std::exp(I*2.*(u(gen) - 0.5));
+        a[i] = 1.;
+        a_g[i] = 1. + shift;
+    }
+
+    std::cout << std::setw(14) << "function" << std::setw(14) << "special [s]" << std::setw(14) << "generic [s]"
+              << std::setw(10) << "speedup\n";
+    for (int f = 0; f < 2; f++) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (f == 0) cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res.data(), NULL);
+        else cplxfnc::zeta_batch(n, s.data(), a.data(), res.data(), NULL);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        if (f == 0) cplxfnc::gamma_inc_batch(n, s_g.data(), z.data(), res.data(), NULL);
+        else cplxfnc::zeta_batch(n, s.data(), a_g.data(), res.data(), NULL);
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        double t_s = std::chrono::duration<double>(t1 - t0).count();
+        double t_g = std::chrono::duration<double>(t2 - t1).count();
+        std::cout << std::setw(14) << (f == 0 ? "gamma_inc" : "zeta") << std::setw(14) << std::setprecision(4) << t_s
+                  << std::setw(14) << t_g << std::setw(9) << std::setprecision(3) << t_g / t_s << "\n";
+    }
+    return 0;
+}
+
+int bench_estimate(std::size_t n)
+{
+    std::cout << "\ncost estimates against gamma_inc, " << n << " points\n";
+
+    const std::complex<double> I(0, 1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<std::complex<double> > s(n), z(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = -20. + 40*u(gen) + 10*(u(gen) - 0.5)*I;
+        z[i] = (0.1 + 30*u(gen)) * std::exp(I*2.*(u(gen) - 0.5));
+    }
+
+    std::vector<cplxfnc::CostEstimate> est(n);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; i++) est[i] = cplxfnc::gamma_inc_estimate(s[i], z[i]);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    cplxfnc::GammaIncEvaluator ev;
+    std::size_t n_match = 0, n_under = 0;
+    std::complex<double> r;
+    for (std::size_t i = 0; i < n; i++) {
+        ev(s[i], z[i], &r);
+        if (ev.last_attempts() == est[i].attempts) n_match++;
+        if (ev.last_attempts() > est[i].attempts) n_under++;
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    double t_est = std::chrono::duration<double>(t1 - t0).count();
+    double t_eval = std::chrono::duration<double>(t2 - t1).count();
+    std::cout << "estimate " << std::setprecision(3) << 1e9 * t_est / n << " ns per point, evaluation "
+              << 1e9 * t_eval / n << " ns per point\n";
+    std::cout << "attempts estimated exactly for " << double(n_match) / n << ", underestimated for "
+              << double(n_under) / n << " of the points\n";
+    return 0;
+}
+
+int bench_path(std::size_t n)
+{
+    std::cout << "\npath continuation against single evaluations, gamma_inc(2.5+i, z(t)) and u_asymp(0.3+0.2i, 1.5, z(t)), "
+              << n << " points\n";
+
+    const std::complex<double> I(0, 1);
+    std::vector<std::complex<double> > z(n), res(n), ref(n);
+    // a slowly turning spiral
+    for (std::size_t i = 0; i < n; i++) {
+        const double t = double(i) / n;
+        z[i] = (3. + 2*t) * std::exp(I*t);
+    }
+
+    cplxfnc::GammaIncEvaluator ev;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; i++) ev(2.5 + 1.*I, z[i], &ref[i]);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    cplxfnc::GammaIncPath path(2.5 + 1.*I);
+    for (std::size_t i = 0; i < n; i++) path(z[i], &res[i]);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    double max_err = 0;
+    for (std::size_t i = 0; i < n; i++) max_err = std::max(max_err, std::abs(res[i] / ref[i] - 1.));
+    std::cout << "gamma_inc: evaluator " << std::setprecision(3)
+              << 1e6 * std::chrono::duration<double>(t1 - t0).count() / n << " us per point, path "
+              << 1e6 * std::chrono::duration<double>(t2 - t1).count() / n << " us per point ("
+              << path.anchors() << " anchors), max rel. deviation " << max_err << "\n";
+
+    for (std::size_t i = 0; i < n; i++) z[i] = 20. * z[i];
+    cplxfnc::UAsympEvaluator uev;
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; i++) uev(0.3 + 0.2*I, 1.5, z[i], &ref[i]);
+    t1 = std::chrono::steady_clock::now();
+    cplxfnc::UAsympPath upath(0.3 + 0.2*I, 1.5);
+    for (std::size_t i = 0; i < n; i++) upath(z[i], &res[i]);
+    t2 = std::chrono::steady_clock::now();
+    max_err = 0;
+    for (std::size_t i = 0; i < n; i++) max_err = std::max(max_err, std::abs(res[i] / ref[i] - 1.));
+    std::cout << "u_asymp:   evaluator " << 1e6 * std::chrono::duration<double>(t1 - t0).count() / n
+              << " us per point, path " << 1e6 * std::chrono::duration<double>(t2 - t1).count() / n
+              << " us per point (" << upath.anchors() << " anchors), max rel. deviation " << max_err << "\n";
+    return 0;
+}
+
+// ##################################################
+// ##     per region report (JSON)
+// ##################################################
+
+// a named region of arguments, gen fills the (up to three) arguments of one call
+struct Region {
+    const char * function;
+    const char * name;
+    std::function<void(std::mt19937 &, std::complex<double> *)> gen;
+};
+
+std::vector<Region> bench_regions()
+{
+    const std::complex<double> I(0, 1);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<Region> r;
+
+    r.push_back({"zeta", "moderate", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.5 + 2*u(g) + 2*(u(g) - 0.5)*I;
+        x[1] = 0.1 + 10*u(g) + (u(g) - 0.5)*I; }});
+    r.push_back({"zeta", "negative_re_s", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = -10. + 9*u(g) + 2*(u(g) - 0.5)*I;
+        x[1] = 0.1 + 10*u(g) + (u(g) - 0.5)*I; }});
+    r.push_back({"zeta", "near_real_axis", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.5 + 2*u(g) + 1e-8*(u(g) - 0.5)*I;
+        x[1] = 0.1 + 10*u(g) + 1e-8*(u(g) - 0.5)*I; }});
+    r.push_back({"zeta", "huge_im_a", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 1.2 + 0.5*u(g)*I;
+        x[1] = 1. + std::pow(10., 12 + 12*u(g))*I; }});
+
+    r.push_back({"gamma_inc", "small_z", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.1 + 2*u(g) + 2*(u(g) - 0.5)*I;
+        x[1] = std::pow(10., -3 + 3*u(g)) * std::exp(I*6.*(u(g) - 0.5)); }});
+    r.push_back({"gamma_inc", "large_z", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.1 + 2*u(g) + 2*(u(g) - 0.5)*I;
+        x[1] = std::pow(10., 2 + 4*u(g)) * std::exp(I*3.*(u(g) - 0.5)); }});
+    r.push_back({"gamma_inc", "negative_re_s", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = -10. + 9*u(g) + 2*(u(g) - 0.5)*I;
+        x[1] = 1. + 10*u(g) + 10*(u(g) - 0.5)*I; }});
+    r.push_back({"gamma_inc", "near_real_axis", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = -0.9 + 2*u(g) + 1e-8*(u(g) - 0.5)*I;
+        x[1] = -20. + 40*u(g) + 1e-10*(u(g) - 0.5)*I; }});
+
+    r.push_back({"u_asymp", "moderate_z", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.1 + 2*u(g) + (u(g) - 0.5)*I;
+        x[1] = x[0];
+        x[2] = (50. + 150*u(g)) * std::exp(I*2.*(u(g) - 0.5)); }});
+    r.push_back({"u_asymp", "large_z", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 0.1 + 2*u(g) + (u(g) - 0.5)*I;
+        x[1] = x[0];
+        x[2] = std::pow(10., 3 + 5*u(g)) * std::exp(I*2.*(u(g) - 0.5)); }});
+    r.push_back({"u_asymp", "negative_re_a", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = -5. + 4*u(g) + (u(g) - 0.5)*I;
+        x[1] = x[0];
+        x[2] = 50. + 150*u(g); }});
+    r.push_back({"u_asymp", "near_real_axis", [=](std::mt19937 & g, std::complex<double> * x) mutable {
+        x[0] = 1.5 + 0.5*u(g);
+        x[1] = x[0];
+        x[2] = -50. - 150*u(g) - 1e-8*I; }});
+    return r;
+}
+
+void json_histogram(std::ostream & os, const std::map<unsigned int, std::size_t> & h)
+{
+    os << "{";
+    for (std::map<unsigned int, std::size_t>::const_iterator it = h.begin(); it != h.end(); ++it) {
+        os << (it == h.begin() ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+    }
+    os << "}";
+}
+
+int bench_regions_json(std::size_t n, double tol)
+{
+    const cplxfnc::Settings settings(tol);
+    cplxfnc::ZetaEvaluator zeta_eval(settings);
+    cplxfnc::GammaIncEvaluator gamma_inc_eval(settings);
+    cplxfnc::UAsympEvaluator u_asymp_eval(settings);
+
+    std::vector<Region> regions = bench_regions();
+    std::cout << "{\n  \"n\": " << n << ",\n  \"tol\": " << tol << ",\n  \"regions\": [\n";
+    for (std::size_t r = 0; r < regions.size(); r++) {
+        const std::string fn = regions[r].function;
+        std::mt19937 gen(42);
+        std::vector<double> latency(n);
+        std::map<unsigned int, std::size_t> prec, attempts;
+        std::size_t n_fail = 0;
+        double t_total = 0;
+        std::complex<double> x[3], res;
+        for (std::size_t i = 0; i < n; i++) {
+            regions[r].gen(gen, x);
+            int status;
+            unsigned int p, a;
+            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            if (fn == "zeta") {
+                status = zeta_eval(x[0], x[1], &res);
+                p = zeta_eval.last_prec(); a = zeta_eval.last_attempts();
+            } else if (fn == "gamma_inc") {
+                status = gamma_inc_eval(x[0], x[1], &res);
+                p = gamma_inc_eval.last_prec(); a = gamma_inc_eval.last_attempts();
+            } else {
+                status = u_asymp_eval(x[0], x[1], x[2], &res);
+                p = u_asymp_eval.last_prec(); a = u_asymp_eval.last_attempts();
+            }
+            std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+            latency[i] = std::chrono::duration<double>(t1 - t0).count();
+            t_total += latency[i];
+            if (status) n_fail++;
+            prec[p]++;
+            attempts[a]++;
+        }
+        std::sort(latency.begin(), latency.end());
+
+        std::cout << "    {\"function\": \"" << fn << "\", \"region\": \"" << regions[r].name << "\"" <<
+        ", \"calls_per_s\": " << n / t_total <<
+        ", \"p50_us\": " << 1e6 * latency[n / 2] <<
+        ", \"p99_us\": " << 1e6 * latency[std::min(n - 1, (99 * n) / 100)] <<
+        ", \"failures\": " << n_fail <<
+        ",\n     \"prec\": ";
+        json_histogram(std::cout, prec);
+        std::cout << ",\n     \"attempts\": ";
+        json_histogram(std::cout, attempts);
+        std::cout << "}" << (r + 1 < regions.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}\n";
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    // usage: cplxfnc_bench [n] [max_threads]
+    //        cplxfnc_bench --json [n]
+    if ((argc > 1) && (std::string(argv[1]) == "--json")) {
+        std::size_t n = 1000;
+        if (argc > 2) n = std::stoul(argv[2]);
+        if (n == 0) {
+            std::cerr << "cplxfnc_bench: n must be positive\n";
+            return -1;
+        }
+        return bench_regions_json(n, 1e-16);
+    }
+    std::size_t n = 2000;
+    unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (argc > 1) n = std::stoul(argv[1]);
+    if (argc > 2) max_threads = std::stoul(argv[2]);
+    if ((n == 0) || (max_threads == 0)) {
+        std::cerr << "cplxfnc_bench: n and max_threads must be positive\n";
+        return -1;
+    }
+
+    std::cout << "\nrun benchmarks for cplxfnc library\n";
+    if (bench_parallel_scaling(n, max_threads)) return -1;
+    if (bench_escalation_policies(n)) return -1;
+    if (bench_hurwitz_zeta(n)) return -1;
+    if (bench_fast_path(n, 1e-16)) return -1;
+    if (bench_fast_path(n, 1e-13)) return -1;
+    if (bench_interpolation_table(n)) return -1;
+    if (bench_gamma_inc_sequence(n)) return -1;
+    if (bench_zeta_sequence(n)) return -1;
+    if (bench_dd_batch(n)) return -1;
+    if (bench_real_batch(n)) return -1;
+    if (bench_special_values(n)) return -1;
+    if (bench_estimate(n)) return -1;
+    if (bench_path(n)) return -1;
+    return 0;
+}
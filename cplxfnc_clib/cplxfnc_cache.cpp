@@ -0,0 +1,208 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     result cache
+// ##################################################
+
+namespace {
+
+// function id, the bit patterns of up to 3 complex arguments and of tol
+struct Key {
+    std::uint64_t w[8];
+
+    bool operator==(const Key & other) const { return std::memcmp(w, other.w, sizeof(w)) == 0; }
+};
+
+// splitmix64 finalizer applied to each word
+inline std::uint64_t hash64(const Key & k)
+{
+    std::uint64_t h = 0;
+    for (unsigned int i = 0; i < 8; i++) {
+        std::uint64_t x = h ^ k.w[i];
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        h = x ^ (x >> 31);
+    }
+    return h;
+}
+
+// the low bits for the buckets of the shard's map (all of std::size_t may be
+// only 32 bits wide), the high 32 bits of hash64 select the shard
+struct KeyHash {
+    std::size_t operator()(const Key & k) const { return std::size_t(hash64(k)); }
+};
+
+inline std::uint64_t bits(double x)
+{
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+Key make_key(CacheFunction fn, const std::complex<double> * args, unsigned int n_args, double tol)
+{
+    Key k;
+    std::memset(k.w, 0, sizeof(k.w));
+    k.w[0] = std::uint64_t(fn) | (std::uint64_t(n_args) << 8);
+    for (unsigned int i = 0; (i < n_args) && (i < 3); i++) {
+        k.w[1 + 2*i] = bits(args[i].real());
+        k.w[2 + 2*i] = bits(args[i].imag());
+    }
+    k.w[7] = bits(tol);
+    return k;
+}
+
+}
+
+struct ResultCache::Shard {
+    typedef std::pair<Key, std::complex<double> > Entry;
+    typedef std::list<Entry> List;
+
+    std::mutex m;
+    List lru;                       // most recently used first
+    std::unordered_map<Key, List::iterator, KeyHash> map;
+    std::size_t capacity;
+    unsigned long hits;
+    unsigned long misses;
+    char pad[64];                   // keep the locks of neighbouring shards on different cache lines
+};
+
+ResultCache::ResultCache(std::size_t capacity, unsigned int n_shards)
+    : n_shards(n_shards > 0 ? n_shards : 1)
+{
+    shards = new Shard[this->n_shards];
+    for (unsigned int i = 0; i < this->n_shards; i++) {
+        shards[i].capacity = (capacity + this->n_shards - 1) / this->n_shards;
+        shards[i].hits = 0;
+        shards[i].misses = 0;
+    }
+}
+
+ResultCache::~ResultCache()
+{
+    delete [] shards;
+}
+
+bool ResultCache::lookup(CacheFunction fn, const std::complex<double> * args, unsigned int n_args, double tol,
+                         std::complex<double> * res)
+{
+    Key k = make_key(fn, args, n_args, tol);
+    Shard & sh = shards[(hash64(k) >> 32) % n_shards];
+
+    std::lock_guard<std::mutex> lock(sh.m);
+    std::unordered_map<Key, Shard::List::iterator, KeyHash>::iterator it = sh.map.find(k);
+    if (it == sh.map.end()) {
+        sh.misses++;
+        return false;
+    }
+    sh.hits++;
+    sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+    *res = it->second->second;
+    return true;
+}
+
+void ResultCache::insert(CacheFunction fn, const std::complex<double> * args, unsigned int n_args, double tol,
+                         std::complex<double> res)
+{
+    Key k = make_key(fn, args, n_args, tol);
+    Shard & sh = shards[(hash64(k) >> 32) % n_shards];
+
+    std::lock_guard<std::mutex> lock(sh.m);
+    if (sh.capacity == 0) return;
+    std::unordered_map<Key, Shard::List::iterator, KeyHash>::iterator it = sh.map.find(k);
+    if (it != sh.map.end()) {
+        it->second->second = res;
+        sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+        return;
+    }
+    if (sh.map.size() >= sh.capacity) {
+        sh.map.erase(sh.lru.back().first);
+        sh.lru.pop_back();
+    }
+    sh.lru.push_front(Shard::Entry(k, res));
+    sh.map[k] = sh.lru.begin();
+}
+
+unsigned long ResultCache::hits() const
+{
+    unsigned long n = 0;
+    for (unsigned int i = 0; i < n_shards; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].m);
+        n += shards[i].hits;
+    }
+    return n;
+}
+
+unsigned long ResultCache::misses() const
+{
+    unsigned long n = 0;
+    for (unsigned int i = 0; i < n_shards; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].m);
+        n += shards[i].misses;
+    }
+    return n;
+}
+
+std::size_t ResultCache::size() const
+{
+    std::size_t n = 0;
+    for (unsigned int i = 0; i < n_shards; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].m);
+        n += shards[i].map.size();
+    }
+    return n;
+}
+
+void ResultCache::clear()
+{
+    for (unsigned int i = 0; i < n_shards; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].m);
+        shards[i].map.clear();
+        shards[i].lru.clear();
+    }
+}
+
+void ResultCache::reset_stats()
+{
+    for (unsigned int i = 0; i < n_shards; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].m);
+        shards[i].hits = 0;
+        shards[i].misses = 0;
+    }
+}
+
+} /* namespace cplxfnc */
@@ -24,10 +24,18 @@
 
 #include "cplxfnc.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <complex>
+#include <cstdio>
+#include <future>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 // ##################################################
 // ##     Hurwitz Zeta function
@@ -399,6 +407,1505 @@ int u_asymp_simple_run() {
     return 0;
 }
 
+// ##################################################
+// ##     batch evaluation
+// ##################################################
+
+int batch_check_values()
+{
+    std::cout << "check batch values ... ";
+
+    const std::complex<double> I(0, 1);
+    double tol = 1e-16;
+#define num_batch 5
+    std::complex<double> s[num_batch] = {2., 1.2, 1.2 + I, 0.1 + I, -0.1};
+    std::complex<double> x[num_batch] = {1. + I, 1. - 1234.*I, 10.*I, 35., -3.6};
+    std::complex<double> res[num_batch], res_check;
+    int status[num_batch];
+
+    cplxfnc::zeta_batch(num_batch, s, x, res, status, tol, 2);
+    for (unsigned int i = 0; i < num_batch; i++) {
+        if (cplxfnc::zeta(s[i], x[i], &res_check, tol, 2, false) != status[i] || res[i] != res_check) {
+            std::cout << "\nERROR (zeta_batch differs from zeta)\n" <<
+            "s=" << s[i] << " and a=" << x[i] << std::endl;
+            return -1;
+        }
+    }
+
+    cplxfnc::gamma_inc_batch(num_batch, s, x, res, status, tol, 2);
+    for (unsigned int i = 0; i < num_batch; i++) {
+        if (cplxfnc::gamma_inc(s[i], x[i], &res_check, tol, 2, false) != status[i] || res[i] != res_check) {
+            std::cout << "\nERROR (gamma_inc_batch differs from gamma_inc)\n" <<
+            "s=" << s[i] << " and z=" << x[i] << std::endl;
+            return -1;
+        }
+    }
+
+    // broadcast s and a over a strided z
+    std::complex<double> a = 0.4;
+    std::complex<double> z[2*num_batch];
+    for (unsigned int i = 0; i < num_batch; i++) {
+        z[2*i] = 50. + 10.*i;
+        z[2*i+1] = 0;
+    }
+    cplxfnc::u_asymp_batch(num_batch, &a, 0, &a, 0, z, 2*sizeof(std::complex<double>),
+                           res, sizeof(std::complex<double>), status, sizeof(int), tol, 5);
+    for (unsigned int i = 0; i < num_batch; i++) {
+        if (cplxfnc::u_asymp(a, a, z[2*i], &res_check, tol, 5, false) != status[i] || res[i] != res_check) {
+            std::cout << "\nERROR (u_asymp_batch differs from u_asymp)\n" <<
+            "z=" << z[2*i] << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+int batch_check_status()
+{
+    std::cout << "check batch status ... ";
+
+    const std::complex<double> I(0, 1);
+    double tol = 1e-16;
+    std::complex<double> s[3] = {2., 0.1 + I, -0.1};
+    std::complex<double> z[3] = {1., 35., 0.};
+    std::complex<double> res[3];
+    int status[3];
+
+    std::size_t n_fail = cplxfnc::gamma_inc_batch(3, s, z, res, status, tol, 1);
+    if ((n_fail != 2) || (status[0] != 0) || (status[1] != -1) || (status[2] != -2)) {
+        std::cout << "\nERROR (gamma_inc_batch status)\n" <<
+        "expect status 0, -1, -2 but got " << status[0] << ", " << status[1] << ", " << status[2] << std::endl;
+        return -1;
+    }
+
+    n_fail = cplxfnc::gamma_inc_batch(3, s, z, res, NULL, tol, 1);
+    if (n_fail != 2) {
+        std::cout << "\nERROR (gamma_inc_batch without status array)\n" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     parallel batch evaluation
+// ##################################################
+
+int parallel_check_values()
+{
+    std::cout << "check parallel batch ... ";
+
+    const std::complex<double> I(0, 1);
+    double tol = 1e-16;
+    const std::size_t n = 101;
+    std::vector<std::complex<double> > s(n), z(n), res(n), res_check(n);
+    std::vector<int> status(n), status_check(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = -1. + 0.03*i + 0.5*I;
+        z[i] = 1.2 + std::pow(10., 0.1*i)*I;
+    }
+    s[n/2] = -0.1;
+    z[n/2] = 0;
+
+    cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res_check.data(), status_check.data(), tol, 2);
+    unsigned int n_threads[3] = {1, 3, 8};
+    std::size_t chunk_size[3] = {1, 7, n};
+    for (unsigned int i = 0; i < 3; i++) {
+        cplxfnc::ParallelEvaluator pe(n_threads[i], chunk_size[i]);
+        for (unsigned int j = 0; j < 2; j++) {
+            std::size_t n_fail = pe.gamma_inc_batch(n, s.data(), z.data(), res.data(), status.data(), tol, 2);
+            for (std::size_t k = 0; k < n; k++) {
+                if ((status[k] != status_check[k]) ||
+                    ((status[k] == 0) && (res[k] != res_check[k]))) {
+                    std::cout << "\nERROR (parallel gamma_inc_batch differs from gamma_inc_batch)\n" <<
+                    "threads=" << n_threads[i] << " chunk_size=" << chunk_size[i] <<
+                    " s=" << s[k] << " and z=" << z[k] << std::endl;
+                    return -1;
+                }
+            }
+            if ((n_fail == 0) || (status[n/2] != -2)) {
+                std::cout << "\nERROR (parallel gamma_inc_batch, expect value error)" << std::endl;
+                return -1;
+            }
+        }
+        if (pe.zeta_batch(0, s.data(), z.data(), res.data(), status.data()) != 0) {
+            std::cout << "\nERROR (parallel zeta_batch, empty batch)" << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+namespace {
+
+void count_point(void * user, std::complex<double> res, int status)
+{
+    if (status == 0) static_cast<std::atomic<int> *>(user)->fetch_add(1);
+}
+
+void store_n_fail(void * user, std::size_t n_fail)
+{
+    static_cast<std::atomic<std::size_t> *>(user)->store(n_fail);
+}
+
+// every callback submits three more points until left is used up
+struct Resubmit {
+    cplxfnc::AsyncEvaluator * ae;
+    std::atomic<int> left;
+    std::atomic<int> done;
+};
+
+void resubmit(void * user, std::complex<double> res, int status)
+{
+    Resubmit * r = static_cast<Resubmit *>(user);
+    r->done.fetch_add(1);
+    if (r->left.fetch_sub(1) > 0) {
+        for (int k = 0; k < 3; k++) r->ae->zeta(2., 1., resubmit, user);
+    }
+}
+
+}
+
+int async_check_values()
+{
+    std::cout << "check asynchronous evaluation ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::size_t n = 101;
+    std::vector<std::complex<double> > s(n), z(n), res(n), res_check(n);
+    std::vector<int> status(n), status_check(n);
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = -1. + 0.03*i + 0.5*I;
+        z[i] = 1.2 + std::pow(10., 0.1*i)*I;
+    }
+    s[n/2] = -0.1;
+    z[n/2] = 0;
+    cplxfnc::gamma_inc_batch(n, s.data(), z.data(), res_check.data(), status_check.data(), 1e-16, 2);
+
+    // a small queue and groups, so the submissions block and are merged
+    cplxfnc::AsyncEvaluator ae(cplxfnc::Settings(1e-16, 2), 3, 16, 5);
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    std::future<std::size_t> f_batch = ae.gamma_inc_batch(n, s.data(), c, z.data(), c, res.data(), c,
+                                                          status.data(), sizeof(int));
+    std::vector<std::future<std::complex<double> > > f_point;
+    std::atomic<int> n_ok(0);
+    for (std::size_t i = 0; i < n; i++) {
+        f_point.push_back(ae.gamma_inc(s[i], z[i]));
+        ae.gamma_inc(s[i], z[i], count_point, &n_ok);
+    }
+    if (f_batch.get() != 1) {
+        std::cout << "\nERROR (async gamma_inc_batch, expect one failed point)" << std::endl;
+        return -1;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        if ((status[i] != status_check[i]) || ((status[i] == 0) && (res[i] != res_check[i]))) {
+            std::cout << "\nERROR (async gamma_inc_batch differs from gamma_inc_batch)\n" <<
+            "s=" << s[i] << " and z=" << z[i] << std::endl;
+            return -1;
+        }
+        try {
+            std::complex<double> r = f_point[i].get();
+            if ((status_check[i] != 0) || (r != res_check[i])) {
+                std::cout << "\nERROR (async gamma_inc)\n" << "s=" << s[i] << " and z=" << z[i] << std::endl;
+                return -1;
+            }
+        } catch (const std::runtime_error & e) {
+            if (status_check[i] == 0) {
+                std::cout << "\nERROR (async gamma_inc, unexpected exception)\n" << e.what() << std::endl;
+                return -1;
+            }
+        }
+    }
+    ae.wait();
+    if ((n_ok != int(n) - 1) || (ae.pending() != 0)) {
+        std::cout << "\nERROR (async gamma_inc with callback)" << std::endl;
+        return -1;
+    }
+
+    // empty batch and the other functions
+    std::atomic<std::size_t> n_fail(1);
+    ae.zeta_batch(0, s.data(), c, z.data(), c, res.data(), c, NULL, 0, store_n_fail, &n_fail);
+    if (n_fail != 0) {
+        std::cout << "\nERROR (async zeta_batch, empty batch)" << std::endl;
+        return -1;
+    }
+    std::future<std::complex<double> > f_zeta = ae.zeta(2., 1.);
+    std::future<std::complex<double> > f_u = ae.u_asymp(2., 2., 100.);
+    if ((f_zeta.get() != cplxfnc::zeta(2., 1.)) || (f_u.get() != cplxfnc::u_asymp(2., 2., 100.))) {
+        std::cout << "\nERROR (async zeta, u_asymp)" << std::endl;
+        return -1;
+    }
+
+    // callbacks submitting to a full queue of a single worker must not deadlock
+    cplxfnc::AsyncEvaluator ae_1(cplxfnc::Settings(), 1, 2, 1);
+    Resubmit r;
+    r.ae = &ae_1;
+    r.left = 10;
+    r.done = 0;
+    ae_1.zeta(2., 1., resubmit, &r);
+    ae_1.wait();
+    if (r.done != 31) {
+        std::cout << "\nERROR (async submit from a callback)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     adaptive initial precision
+// ##################################################
+
+int predictor_check()
+{
+    std::cout << "check precision predictor ... ";
+
+    const std::complex<double> I(0, 1);
+    cplxfnc::PrecisionPredictor pred(0.9, 8);
+    std::complex<double> z = 1e8 + I;
+
+    if (pred.predict(z) != 0) {
+        std::cout << "\nERROR (empty predictor should return 0)" << std::endl;
+        return -1;
+    }
+    for (unsigned int i = 0; i < 10; i++) {
+        pred.record(z, 150);
+    }
+    pred.record(z, 600);
+    unsigned int prec = pred.predict(z);
+    if ((prec < 150) || (prec >= 600) || (pred.predict(1.) != 0) || (pred.predict(-z) != 0)) {
+        std::cout << "\nERROR (wrong prediction " << prec << ")" << std::endl;
+        return -1;
+    }
+    pred.reset();
+    if (pred.predict(z) != 0) {
+        std::cout << "\nERROR (predictor was reset)" << std::endl;
+        return -1;
+    }
+
+    // the results must not depend on the predicted initial precision
+    double tol = 1e-16;
+    std::complex<double> res, res_check;
+    for (unsigned int i = 0; i < 20; i++) {
+        std::complex<double> zi = z + 1e5*i;
+        int status = cplxfnc::gamma_inc(-0.5, zi, &res, tol, 5, false, 12, &pred);
+        cplxfnc::gamma_inc(-0.5, zi, &res_check, tol, 5, false, 12);
+        if (status || (std::abs(res - res_check) > tol*std::abs(res_check))) {
+            std::cout << "\nERROR (gamma_inc with predictor)\n" << "z=" << zi << std::endl;
+            return -1;
+        }
+    }
+    if (pred.predict(z) <= 12) {
+        std::cout << "\nERROR (expect a prediction above the initial precision)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     precision escalation
+// ##################################################
+
+int policy_check()
+{
+    std::cout << "check escalation policies ... ";
+
+    cplxfnc::DoublingPolicy doubling;
+    cplxfnc::DeficitPolicy deficit(10);
+    if ((doubling.next_prec(56, -40, -53) != 112) ||
+        (deficit.next_prec(56, -40, -53) != 79) ||
+        (deficit.next_prec(56, 0, -53) != 112) ||
+        (deficit.next_prec(56, 1L << 60, -53) != 112)) {
+        std::cout << "\nERROR (unexpected next precision)" << std::endl;
+        return -1;
+    }
+
+    const std::complex<double> I(0, 1);
+    double tol = 1e-16;
+    std::complex<double> res, res_check;
+    for (unsigned int i = 0; i < 10; i++) {
+        std::complex<double> z = 1e8 + 1e7*i*I;
+        int status = cplxfnc::gamma_inc(-0.5, z, &res, tol, 8, false, 12, NULL, &deficit);
+        cplxfnc::gamma_inc(-0.5, z, &res_check, tol, 8, false, 12, NULL, &doubling);
+        if (status || (std::abs(res - res_check) > tol*std::abs(res_check))) {
+            std::cout << "\nERROR (gamma_inc with deficit policy)\n" << "z=" << z << std::endl;
+            return -1;
+        }
+    }
+    cplxfnc::zeta(1.00000004 + I*10., 1.e6 + I*1.e6, &res, tol, 1, false, ZETA_DEFAULT_INIT_PREC, NULL, &deficit);
+    if ((deficit.calls() != 11) || (deficit.failures() != 1) || (doubling.calls() != 10) ||
+        (deficit.attempts() < 11) || (doubling.attempts() < 20)) {
+        std::cout << "\nERROR (policy statistics)\n" <<
+        "deficit: calls " << deficit.calls() << " attempts " << deficit.attempts() << " failures " << deficit.failures() << "\n" <<
+        "doubling: calls " << doubling.calls() << " attempts " << doubling.attempts() << std::endl;
+        return -1;
+    }
+    deficit.reset_stats();
+    if ((deficit.calls() != 0) || (deficit.attempts() != 0) || (deficit.failures() != 0)) {
+        std::cout << "\nERROR (policy statistics were reset)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     result cache
+// ##################################################
+
+int cache_check()
+{
+    std::cout << "check result cache ... ";
+
+    const std::complex<double> I(0, 1);
+    std::complex<double> args[2], res;
+
+    cplxfnc::ResultCache lru(4, 1);
+    for (unsigned int i = 0; i < 5; i++) {
+        args[0] = 1.; args[1] = double(i);
+        lru.insert(cplxfnc::CACHE_ZETA, args, 2, 1e-16, double(i));
+        if (i == 3) {
+            args[1] = 0.;   // touch the first entry, the second becomes the least recently used
+            lru.lookup(cplxfnc::CACHE_ZETA, args, 2, 1e-16, &res);
+        }
+    }
+    args[1] = 1.;
+    bool evicted = !lru.lookup(cplxfnc::CACHE_ZETA, args, 2, 1e-16, &res);
+    args[1] = 0.;
+    bool kept = lru.lookup(cplxfnc::CACHE_ZETA, args, 2, 1e-16, &res) && (res == 0.);
+    bool other_fn = !lru.lookup(cplxfnc::CACHE_GAMMA_INC, args, 2, 1e-16, &res);
+    bool other_tol = !lru.lookup(cplxfnc::CACHE_ZETA, args, 2, 1e-10, &res);
+    if ((lru.size() != 4) || !evicted || !kept || !other_fn || !other_tol) {
+        std::cout << "\nERROR (LRU eviction or key)" << std::endl;
+        return -1;
+    }
+
+    // repeated arguments are evaluated once, failed points are not cached
+    double tol = 1e-16;
+    const std::size_t n = 20;
+    std::complex<double> s[n], z[n], res_c[n], res_check[n];
+    int status[n], status_check[n];
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = 0.1 + 0.5*I;
+        z[i] = 1. + 3.*(i % 4);
+    }
+    s[n-1] = -0.1;
+    z[n-1] = 0.;
+    cplxfnc::ResultCache cache;
+    cplxfnc::gamma_inc_batch(n, s, z, res_check, status_check, tol, 5);
+    cplxfnc::gamma_inc_batch(n, s, z, res_c, status, tol, 5, false, GAMMA_INC_DEFAULT_INIT_PREC,
+                             NULL, NULL, &cache);
+    for (std::size_t i = 0; i < n; i++) {
+        if ((status[i] != status_check[i]) || ((status[i] == 0) && (res_c[i] != res_check[i]))) {
+            std::cout << "\nERROR (cached gamma_inc_batch differs)\n" << "z=" << z[i] << std::endl;
+            return -1;
+        }
+    }
+    if ((cache.misses() != 4) || (cache.hits() != n - 5) || (cache.size() != 4)) {
+        std::cout << "\nERROR (cache statistics)\n" << "hits " << cache.hits() <<
+        " misses " << cache.misses() << " size " << cache.size() << std::endl;
+        return -1;
+    }
+    cache.clear();
+    cache.reset_stats();
+    if ((cache.size() != 0) || (cache.hits() != 0) || (cache.misses() != 0)) {
+        std::cout << "\nERROR (cache was cleared)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     Hurwitz zeta function for fixed s
+// ##################################################
+
+int hurwitz_zeta_check_values()
+{
+    std::cout << "check HurwitzZeta values ... ";
+
+    double tol = 1e-16;
+    const std::complex<double> I(0, 1);
+
+    // a and zeta(1.2 + I, a), see check_values
+    double data [6][4] = { {1.,    0. ,  7.89008276053315959e-1, -8.904382488200783911e-1},
+                           {1.,    1. , -3.74965169663485969e-1, -2.732104072569482620},
+                           {0.,    1. , -1.86148443143806753   , -7.307139932227024369},
+                           {1.,   10. , -1.89011737420273344   ,  2.105544806767073391},
+                           {1.,-1234. , -1.56061472179186142e-2, -4.656891594125561926e-2},
+                           {1.,    0. ,  7.89008276053315959e-1, -8.904382488200783911e-1} };
+
+    cplxfnc::HurwitzZeta hz(1.2 + I, tol, 5);
+    std::complex<double> a[6], res[6];
+    int status[6];
+    for (int i = 0; i < 6; i++) {
+        a[i] = data[i][0] + I*data[i][1];
+    }
+    hz.batch(6, a, res, status);
+    for (int i = 0; i < 6; i++) {
+        std::complex<double> res_check = data[i][2] + I*data[i][3];
+        if (status[i] || (std::abs(res[i] - res_check) > tol*std::abs(res_check)) || (hz(a[i]) != res[i])) {
+            std::cout << "\nERROR (HurwitzZeta)\n" << std::scientific << std::setprecision(16) <<
+            "s=" << hz.s() << " and a=" << a[i] << std::endl <<
+            "returned      : " << res[i] << std::endl <<
+            "but should be : " << res_check << std::endl;
+            return -1;
+        }
+    }
+
+    // real a on the grid (shifted by up to 15), in the counters of zeta
+    cplxfnc::HurwitzZeta hz_grid(1.2 + I, cplxfnc::Settings(tol), 100);
+    const double a_grid[5] = {0.3, 1., 2.75, 15.9, 1e-5};
+    cplxfnc_stats_reset();
+    for (int i = 0; i < 5; i++) {
+        std::complex<double> res_check = cplxfnc::zeta(1.2 + I, a_grid[i]);
+        std::complex<double> r_grid = hz_grid(a_grid[i]);
+        if (std::abs(r_grid - res_check) > tol*std::abs(res_check)) {
+            std::cout << "\nERROR (HurwitzZeta grid)\n" << std::scientific << std::setprecision(16) <<
+            "a=" << a_grid[i] << "\nreturned      : " << r_grid << "\nbut should be : " << res_check << std::endl;
+            return -1;
+        }
+    }
+    cplxfnc_stats st;
+    cplxfnc_stats_read(CPLXFNC_STATS_ZETA, &st);
+    if (st.calls != 10) {
+        std::cout << "\nERROR (HurwitzZeta calls not counted)" << std::endl;
+        return -1;
+    }
+
+    cplxfnc::HurwitzZeta hz_pole(1., tol, 2);
+    std::complex<double> r;
+    if (hz_pole(1., &r) == 0) {
+        std::cout << "\nERROR (HurwitzZeta at the pole s=1 should fail)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     double precision fast path
+// ##################################################
+
+int fast_path_check()
+{
+    std::cout << "check double precision fast path ... ";
+
+    double tol = 1e-13;
+    const std::complex<double> I(0, 1);
+    const std::size_t n = 10;
+
+    // the last two points are outside the domain of the kernels (complex a, Re(z) < 0)
+    std::complex<double> s[n] = {2., 1.2 + I, 3. - 20.*I, 30., 0.5 + 14.*I, 2., 1.2 + I, 3., 1.2 + I, 2.};
+    std::complex<double> a[n] = {1., 0.3, 2.5, 0.1, 1., 7., 1., 1.5, 1. + I, 0.5 - 2.*I};
+    std::complex<double> res[n], res_check[n];
+    int status[n], status_check[n];
+
+    cplxfnc::FastPath fast;
+    cplxfnc::zeta_batch(n, s, a, res_check, status_check, tol, 5);
+    cplxfnc::zeta_batch(n, s, a, res, status, tol, 5, false, ZETA_DEFAULT_INIT_PREC,
+                        NULL, NULL, NULL, &fast);
+    for (std::size_t i = 0; i < n; i++) {
+        if (status[i] || status_check[i] || (std::abs(res[i] - res_check[i]) > 2*tol*std::abs(res_check[i]))) {
+            std::cout << "\nERROR (zeta_batch with fast path)\n" << std::scientific << std::setprecision(16) <<
+            "s=" << s[i] << " and a=" << a[i] << std::endl <<
+            "returned      : " << res[i] << std::endl <<
+            "but should be : " << res_check[i] << std::endl;
+            return -1;
+        }
+    }
+    if ((fast.fast() + fast.arb() != n) || (fast.fast() == 0) || (fast.arb() < 2)) {
+        std::cout << "\nERROR (fast path counters of zeta_batch)\n" <<
+        "fast " << fast.fast() << " arb " << fast.arb() << std::endl;
+        return -1;
+    }
+
+    std::complex<double> z[n] = {30., 50. + 10.*I, 60., 80., 25. + I, 40. - 30.*I, 45. + 2.*I, 100., -5. + I, -30.};
+    std::complex<double> sg[n] = {0.5 + I, 2., 10., 20. + 5.*I, 1.5, -3.5 + 2.*I, 0., 0.5, 0.5 + I, 2.};
+    fast.reset_stats();
+    cplxfnc::gamma_inc_batch(n, sg, z, res_check, status_check, tol, 5);
+    cplxfnc::gamma_inc_batch(n, sg, z, res, status, tol, 5, false, GAMMA_INC_DEFAULT_INIT_PREC,
+                             NULL, NULL, NULL, &fast);
+    for (std::size_t i = 0; i < n; i++) {
+        if (status[i] || status_check[i] || (std::abs(res[i] - res_check[i]) > 2*tol*std::abs(res_check[i]))) {
+            std::cout << "\nERROR (gamma_inc_batch with fast path)\n" << std::scientific << std::setprecision(16) <<
+            "s=" << sg[i] << " and z=" << z[i] << std::endl <<
+            "returned      : " << res[i] << std::endl <<
+            "but should be : " << res_check[i] << std::endl;
+            return -1;
+        }
+    }
+    if ((fast.fast() + fast.arb() != n) || (fast.fast() == 0) || (fast.arb() < 2)) {
+        std::cout << "\nERROR (fast path counters of gamma_inc_batch)\n" <<
+        "fast " << fast.fast() << " arb " << fast.arb() << std::endl;
+        return -1;
+    }
+
+    // the scalar functions take the same path
+    fast.reset_stats();
+    std::complex<double> r = cplxfnc::zeta(2., 1., tol, 5, false, ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, &fast);
+    if ((std::abs(r - M_PI*M_PI/6) > tol) || (fast.fast() != 1)) {
+        std::cout << "\nERROR (zeta(2, 1) with fast path)\n" << std::scientific << std::setprecision(16) <<
+        "returned : " << r << " fast " << fast.fast() << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     persistent evaluators
+// ##################################################
+
+int evaluator_check()
+{
+    std::cout << "check persistent evaluators ... ";
+
+    const std::complex<double> I(0, 1);
+    double tol = 1e-16;
+
+    cplxfnc::ZetaEvaluator zeta_eval;
+    cplxfnc::GammaIncEvaluator gamma_inc_eval(cplxfnc::Settings(tol, 5));
+    cplxfnc::UAsympEvaluator u_asymp_eval;
+    for (int i = 0; i < 8; i++) {
+        std::complex<double> s = 0.3*i + 0.7*I;
+        std::complex<double> x = 1. + 2.5*i + 0.1*i*I;
+        if ((zeta_eval(s, x) != cplxfnc::zeta(s, x)) ||
+            (gamma_inc_eval(s, x) != cplxfnc::gamma_inc(s, x)) ||
+            (u_asymp_eval(s, 1. - s, 50. + 20.*x) != cplxfnc::u_asymp(s, 1. - s, 50. + 20.*x))) {
+            std::cout << "\nERROR (evaluator differs from free function)\n" <<
+            "s=" << s << " x=" << x << std::endl;
+            return -1;
+        }
+    }
+    if ((zeta_eval.settings().init_prec != 0) || (gamma_inc_eval.settings().limit != 5) ||
+        (zeta_eval.last_prec() < ZETA_DEFAULT_INIT_PREC) || (zeta_eval.last_attempts() == 0)) {
+        std::cout << "\nERROR (evaluator settings)" << std::endl;
+        return -1;
+    }
+
+    // limit=1 at a small initial precision fails, the throwing call raises
+    zeta_eval.set_settings(cplxfnc::Settings(tol, 1, false, 8));
+    std::complex<double> res;
+    if ((zeta_eval(1.2 + I, 1. + 1234.*I, &res) != -1) || (zeta_eval.last_prec() != 8) ||
+        (zeta_eval.last_attempts() != 1)) {
+        std::cout << "\nERROR (set_settings has no effect)" << std::endl;
+        return -1;
+    }
+    try {
+        zeta_eval(1.2 + I, 1. + 1234.*I);
+        std::cout << "\nERROR (evaluator should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+    if ((gamma_inc_eval(-0.5, 0., &res) != -2) || (u_asymp_eval(1., 1., 0.1, &res) != -2)) {
+        std::cout << "\nERROR (evaluator value errors)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     deadlines and cancellation
+// ##################################################
+
+int stop_check()
+{
+    std::cout << "check deadlines and cancellation ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::complex<double> s = 0.5 + 20.*I, a = 1.5;
+    const std::complex<double> ref = cplxfnc::zeta(s, a);
+
+    // a low initial precision, so the first attempt misses tol
+    cplxfnc::StopToken token;
+    cplxfnc::Settings settings(1e-16, 5, false, 20);
+    settings.stop = &token;
+    cplxfnc::ZetaEvaluator ev(settings);
+    std::complex<double> r;
+    if ((ev(s, a, &r) != 0) || (std::abs(r - ref) > 2e-16*std::abs(ref))) {
+        std::cout << "\nERROR (zeta with StopToken not stopped)" << std::endl;
+        return -1;
+    }
+    token.cancel();
+    if ((ev(s, a, &r) != cplxfnc::STOPPED) || (ev.last_attempts() != 1) || !(ev.last_rel_error() > 1e-16) ||
+        (std::abs(r - ref) > 2*ev.last_rel_error()*std::abs(ref))) {
+        std::cout << "\nERROR (zeta with cancelled StopToken)\n" << "returned : " << r <<
+        " attempts " << ev.last_attempts() << " rel. error " << ev.last_rel_error() << std::endl;
+        return -1;
+    }
+    try {
+        ev(s, a);
+        std::cout << "\nERROR (zeta with cancelled StopToken should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+    double rel_err;
+    if ((cplxfnc::zeta(s, a, &r, &rel_err, settings) != cplxfnc::STOPPED) || (rel_err != ev.last_rel_error())) {
+        std::cout << "\nERROR (zeta with cancelled StopToken, rel_err " << rel_err << ")" << std::endl;
+        return -1;
+    }
+
+    // a deadline in the past stops the batch before every point
+    token.reset();
+    token.set_deadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    const std::size_t n = 5;
+    std::complex<double> sg[n], z[n], res[n];
+    int status[n];
+    for (std::size_t i = 0; i < n; i++) {
+        sg[i] = -1. + 0.5*i + 0.5*I;
+        z[i] = 1. + 3.*i*I;
+    }
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    double rel[n];
+    cplxfnc::Settings stop_settings;
+    stop_settings.stop = &token;
+    std::size_t n_fail = cplxfnc::gamma_inc_batch(n, sg, c, z, c, res, c, status, sizeof(int),
+                                                  rel, sizeof(double), stop_settings);
+    if (n_fail != n) {
+        std::cout << "\nERROR (gamma_inc_batch after the deadline)" << std::endl;
+        return -1;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        if ((status[i] != cplxfnc::STOPPED) || !std::isnan(res[i].real()) || !std::isinf(rel[i])) {
+            std::cout << "\nERROR (gamma_inc_batch after the deadline, status " << status[i] << ")" << std::endl;
+            return -1;
+        }
+    }
+
+    // a distant deadline changes nothing
+    cplxfnc::StopToken later(std::chrono::hours(1));
+    std::complex<double> res_check[n];
+    cplxfnc::gamma_inc_batch(n, sg, z, res_check, status, 1e-16, 5);
+    stop_settings.stop = &later;
+    cplxfnc::ParallelEvaluator pe(2);
+    n_fail = pe.gamma_inc_batch(n, sg, c, z, c, res, c, status, sizeof(int), rel, sizeof(double), stop_settings);
+    for (std::size_t i = 0; i < n; i++) {
+        if ((n_fail != 0) || (res[i] != res_check[i]) || !(rel[i] <= 2e-16)) {
+            std::cout << "\nERROR (gamma_inc_batch before the deadline)" << std::endl;
+            return -1;
+        }
+    }
+
+    // an exact ball (gamma_inc(1, 0) = exp(0) by the special path) has the bound 0
+    cplxfnc::GammaIncEvaluator gev;
+    if ((cplxfnc::gamma_inc(1., 0., &r, &rel_err, cplxfnc::Settings()) != 0) || (rel_err != 0) ||
+        (gev(1., 0., &r) != 0) || (gev.last_rel_error() != 0)) {
+        std::cout << "\nERROR (rel_err of an exact result)\n" << rel_err << " " << gev.last_rel_error() << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     absolute tolerance
+// ##################################################
+
+int atol_check()
+{
+    std::cout << "check absolute tolerance ... ";
+
+    // the first zero of the Riemann zeta function, rounded to double
+    const std::complex<double> rho(0.5, 14.134725141734693);
+    const double atol = 1e-12;
+    std::complex<double> r;
+    int st = cplxfnc::zeta(rho, 1., &r, 1e-16, 5, false, ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, atol);
+    if ((st != cplxfnc::ATOL_MET) || (std::abs(r) > atol)) {
+        std::cout << "\nERROR (zeta atol)\nstatus " << st << ", returned " << r << std::endl;
+        return -1;
+    }
+    // the throwing version accepts it as well
+    if (std::abs(cplxfnc::zeta(rho, 1., 1e-16, 5, false, ZETA_DEFAULT_INIT_PREC,
+                               NULL, NULL, NULL, NULL, NULL, atol)) > atol) {
+        std::cout << "\nERROR (zeta atol, throwing)" << std::endl;
+        return -1;
+    }
+
+    // away from the zero tol is met first and the status is 0
+    const std::complex<double> s[2] = {rho, 2.};
+    const std::complex<double> one = 1.;
+    std::complex<double> res[2];
+    int status[2];
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    std::size_t n_fail = cplxfnc::zeta_batch(2, s, c, &one, 0, res, c, status, sizeof(int), 1e-16, 5, false,
+                                             ZETA_DEFAULT_INIT_PREC, NULL, NULL, NULL, NULL, NULL, atol);
+    if ((n_fail != 0) || (status[0] != cplxfnc::ATOL_MET) || (status[1] != 0) ||
+        (std::abs(res[1] - cplxfnc::zeta(2., 1.)) > 1e-16 * std::abs(res[1]))) {
+        std::cout << "\nERROR (zeta_batch atol)\nstatus " << status[0] << " " << status[1] << std::endl;
+        return -1;
+    }
+
+    // without atol the status is never ATOL_MET
+    cplxfnc::Settings settings(1e-16, 2);
+    if (cplxfnc::ZetaEvaluator(settings)(rho, 1., &r) == cplxfnc::ATOL_MET) {
+        std::cout << "\nERROR (zeta without atol)" << std::endl;
+        return -1;
+    }
+    settings.atol = atol;
+    double x;
+    if ((cplxfnc::ZetaEvaluator(settings)(rho, 1., &r) != cplxfnc::ATOL_MET) ||
+        (cplxfnc::zeta_real(2., 1., &x, settings) != 0)) {
+        std::cout << "\nERROR (zeta settings atol)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     special values
+// ##################################################
+
+int special_check()
+{
+    std::cout << "check special values ... ";
+
+    const std::complex<double> I(0, 1);
+    cplxfnc_stats st;
+    cplxfnc_stats_reset();
+
+    // zeta(s, 1) against zeta(s, 2) + 1 (generic kernel)
+    const std::complex<double> s_r[3] = {3., 0.5 + 14.*I, -2.5};
+    for (int i = 0; i < 3; i++) {
+        std::complex<double> r = cplxfnc::zeta(s_r[i], 1.);
+        std::complex<double> ref = cplxfnc::zeta(s_r[i], 2.) + 1.;
+        if (std::abs(r - ref) > 4e-16*std::abs(ref)) {
+            std::cout << "\nERROR (zeta(s, 1))\n" << "s=" << s_r[i] <<
+            "\nreturned      : " << r << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    // zeta(n, a) for (half-)integer a against HurwitzZeta, zeta(2, 1/2) = pi^2/2
+    const double a[4] = {0.5, 1.5, 3., 7.5};
+    for (unsigned int n = 2; n < 6; n++) {
+        const std::complex<double> s_n = double(n);
+        cplxfnc::HurwitzZeta hz(s_n);
+        for (int i = 0; i < 4; i++) {
+            std::complex<double> r = cplxfnc::zeta(double(n), a[i]);
+            std::complex<double> ref = hz(a[i]);
+            if ((std::abs(r - ref) > 2e-16*std::abs(ref)) || (r.imag() != 0)) {
+                std::cout << "\nERROR (zeta(n, a))\n" << "n=" << n << " a=" << a[i] <<
+                "\nreturned      : " << r << "\nbut should be : " << ref << std::endl;
+                return -1;
+            }
+        }
+    }
+    if (std::abs(cplxfnc::zeta(2., 0.5) - 4.934802200544679) > 1e-15) {
+        std::cout << "\nERROR (zeta(2, 1/2))" << std::endl;
+        return -1;
+    }
+
+    // Gamma(s), exp(-z) and the finite sum for integer s
+    const std::complex<double> z = 3. - 2.*I;
+    std::complex<double> sum = 0, term = 1;
+    for (int k = 0; k < 5; k++) {
+        sum += term;
+        term *= z / double(k + 1);
+    }
+    const std::complex<double> g[3] = {cplxfnc::gamma_inc(2.5, 0.), cplxfnc::gamma_inc(1., z),
+                                       cplxfnc::gamma_inc(5., z)};
+    const std::complex<double> g_ref[3] = {1.329340388179137, std::exp(-z), 24. * std::exp(-z) * sum};
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(g[i] - g_ref[i]) > 1e-15*std::abs(g_ref[i])) {
+            std::cout << "\nERROR (gamma_inc special value " << i << ")\n" <<
+            "returned      : " << g[i] << "\nbut should be : " << g_ref[i] << std::endl;
+            return -1;
+        }
+    }
+
+    cplxfnc_stats_read(CPLXFNC_STATS_ZETA, &st);
+    // zeta(3, 2) in the first loop is a special value too
+    if ((st.special[CPLXFNC_SPECIAL_ZETA_RIEMANN] != 3) || (st.special[CPLXFNC_SPECIAL_ZETA_RATIONAL] != 1 + 4*4 + 1)) {
+        std::cout << "\nERROR (zeta special counters) " << st.special[0] << " " << st.special[1] << std::endl;
+        return -1;
+    }
+    cplxfnc_stats_read(CPLXFNC_STATS_GAMMA_INC, &st);
+    if ((st.special[CPLXFNC_SPECIAL_GAMMA] != 1) || (st.special[CPLXFNC_SPECIAL_EXP] != 1) ||
+        (st.special[CPLXFNC_SPECIAL_FINITE_SUM] != 1)) {
+        std::cout << "\nERROR (gamma_inc special counters)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     cost estimates
+// ##################################################
+
+int estimate_check()
+{
+    std::cout << "check cost estimates ... ";
+
+    // the value errors are those of the functions
+    if ((cplxfnc::gamma_inc_estimate(-0.5, 0.).status != -2) ||
+        (cplxfnc::u_asymp_estimate(1., 2., 0.1).status != -2) ||
+        (cplxfnc::u_asymp_estimate(1., 2., 30.).status != 0)) {
+        std::cout << "\nERROR (estimate value errors)" << std::endl;
+        return -1;
+    }
+
+    // an easy point needs a single attempt at the initial precision
+    cplxfnc::CostEstimate e = cplxfnc::zeta_estimate(2., 1.);
+    if ((e.status != 0) || (e.attempts != 1) || (e.prec != ZETA_DEFAULT_INIT_PREC) || (e.cost != 1)) {
+        std::cout << "\nERROR (zeta_estimate)\nprec " << e.prec << " attempts " << e.attempts <<
+        " cost " << e.cost << std::endl;
+        return -1;
+    }
+
+    // a smaller tol and cancellation cost more, a far too small tol is hopeless
+    cplxfnc::CostEstimate e_tol = cplxfnc::gamma_inc_estimate(2.5, 3., cplxfnc::Settings(1e-40));
+    cplxfnc::CostEstimate e_neg = cplxfnc::gamma_inc_estimate(2.5, -60.);
+    e = cplxfnc::gamma_inc_estimate(2.5, 3.);
+    if ((e_tol.prec <= e.prec) || (e_tol.cost <= e.cost) || (e_neg.cost <= e.cost) ||
+        (cplxfnc::gamma_inc_estimate(2.5, 3., cplxfnc::Settings(1e-300, 3)).status != -1)) {
+        std::cout << "\nERROR (gamma_inc_estimate)" << std::endl;
+        return -1;
+    }
+
+    // the precision recorded by a predictor replaces the model
+    cplxfnc::PrecisionPredictor predictor(0.9, 1);
+    predictor.record(1e4, 400);
+    cplxfnc::Settings settings;
+    settings.predictor = &predictor;
+    e = cplxfnc::gamma_inc_estimate(2.5, 1e4, settings);
+    if ((e.status != 0) || (e.prec < 400) || (e.attempts != 1)) {
+        std::cout << "\nERROR (estimate with predictor)\nprec " << e.prec << " attempts " << e.attempts << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     instrumentation counters
+// ##################################################
+
+int stats_check()
+{
+    std::cout << "check instrumentation counters ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::size_t n = 40;
+    std::complex<double> s[n], a[n], res[n];
+    int status[n];
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = 1.2 + I;
+        a[i] = 1. + std::pow(10., double(i % 8))*I;
+    }
+
+    cplxfnc_stats st;
+    cplxfnc_stats_reset();
+    {
+        // the counters of the worker threads survive the threads
+        cplxfnc::ParallelEvaluator pe(4);
+        pe.zeta_batch(n, s, a, res, status);
+    }
+    cplxfnc::gamma_inc(-0.5, 0., res, 1e-16, 5, false);
+    cplxfnc_stats_read(CPLXFNC_STATS_ZETA, &st);
+
+    unsigned long long n_prec = 0;
+    for (int k = 0; k < CPLXFNC_PREC_BINS; k++) n_prec += st.prec_hist[k];
+    if ((st.calls != n) || (st.arb_evals != n + st.escalations) || (st.limit_failures != 0) ||
+        (n_prec != n)) {
+        std::cout << "\nERROR (zeta counters)\n" << "calls " << st.calls << " arb_evals " << st.arb_evals <<
+        " escalations " << st.escalations << " successes " << n_prec << std::endl;
+        return -1;
+    }
+    cplxfnc_stats_read(CPLXFNC_STATS_GAMMA_INC, &st);
+    if ((st.calls != 1) || (st.value_errors != 1) || (st.arb_evals != 0)) {
+        std::cout << "\nERROR (gamma_inc counters)" << std::endl;
+        return -1;
+    }
+
+    cplxfnc_stats_reset();
+    cplxfnc_stats_read(CPLXFNC_STATS_ZETA, &st);
+    if ((st.calls != 0) || (st.arb_ns != 0) || (cplxfnc_stats_read(3, &st) != -2)) {
+        std::cout << "\nERROR (counters reset)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     diagnostics
+// ##################################################
+
+int trace_check()
+{
+    std::cout << "check trace sink ... ";
+
+    const std::complex<double> I(0, 1);
+    const double tol = 1e-16;
+    cplxfnc::TraceEvent ev;
+
+    // a limit failure records one event in the sink of the settings
+    cplxfnc::TraceSink sink;
+    cplxfnc::Settings settings(tol, 1, false, 8);
+    settings.trace = &sink;
+    cplxfnc::ZetaEvaluator zeta_eval(settings);
+    std::complex<double> res;
+    if ((zeta_eval(1.2 + I, 1. + 1234.*I, &res) != -1) || !sink.pop(&ev) ||
+        (ev.kind != cplxfnc::TRACE_LIMIT) || (std::string(ev.function) != "zeta") || (ev.n_args != 2) ||
+        (ev.args[1] != 1. + 1234.*I) || (ev.prec != 8) || (ev.attempt != 1) || (ev.err_bits <= ev.err_bits_ref) ||
+        sink.pop(&ev)) {
+        std::cout << "\nERROR (limit event)" << std::endl;
+        return -1;
+    }
+
+    // verbose records every attempt, value errors are always recorded
+    settings.limit = 5;
+    settings.init_prec = 0;
+    settings.verbose = true;
+    zeta_eval.set_settings(settings);
+    zeta_eval(1.2 + I, 1. + 1234.*I, &res);
+    std::size_t n_attempt = sink.drain([](const cplxfnc::TraceEvent & e) {
+        if (e.kind != cplxfnc::TRACE_ATTEMPT) throw std::runtime_error("unexpected event");
+    });
+    cplxfnc::GammaIncEvaluator gamma_inc_eval(settings);
+    gamma_inc_eval(-0.5, 0., &res);
+    if ((n_attempt != zeta_eval.last_attempts()) || !sink.pop(&ev) || (ev.kind != cplxfnc::TRACE_VALUE_ERROR) ||
+        (std::string(ev.function) != "gamma_inc") || (cplxfnc::format_event(ev).find("value error") == std::string::npos)) {
+        std::cout << "\nERROR (attempt / value error events)" << std::endl;
+        return -1;
+    }
+
+    // the free functions use the process wide sink, none is set by default
+    cplxfnc::zeta(1.2 + I, 1. + 1234.*I, &res, tol, 1, false, 8);
+    cplxfnc::set_trace_sink(&sink);
+    cplxfnc::zeta(1.2 + I, 1. + 1234.*I, &res, tol, 1, false, 8);
+    cplxfnc::set_trace_sink(NULL);
+    if ((sink.drain([](const cplxfnc::TraceEvent &) {}) != 1) || (cplxfnc::trace_sink() != NULL)) {
+        std::cout << "\nERROR (process wide sink)" << std::endl;
+        return -1;
+    }
+
+    // a full buffer drops events, concurrent producers with a background drainer lose none otherwise
+    cplxfnc::TraceSink small(2);
+    for (int i = 0; i < 3; i++) small.push(ev);
+    if (small.dropped() != 1) {
+        std::cout << "\nERROR (full buffer)" << std::endl;
+        return -1;
+    }
+    cplxfnc::TraceSink bg(64);
+    std::atomic<unsigned int> n_drained(0);
+    bg.start([&n_drained](const cplxfnc::TraceEvent &) { n_drained++; }, 1);
+    std::vector<std::thread> producers;
+    for (int k = 0; k < 4; k++) {
+        producers.push_back(std::thread([&bg, &ev]() { for (int i = 0; i < 10000; i++) bg.push(ev); }));
+    }
+    for (std::size_t k = 0; k < producers.size(); k++) producers[k].join();
+    bg.stop();
+    if (n_drained + bg.dropped() != 40000) {
+        std::cout << "\nERROR (background drainer)\n" << "drained " << n_drained << " dropped " << bg.dropped() << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     interpolation tables
+// ##################################################
+
+int table_check()
+{
+    std::cout << "check interpolation tables ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::complex<double> s = 0.5 + 0.2*I;
+    const std::complex<double> lower = 1. - I, upper = 3. + I;
+    const cplxfnc::Settings settings(1e-12);
+    cplxfnc::InterpolationTable table(cplxfnc::TABLE_GAMMA_INC, s, lower, upper, 2, 2, 16, settings);
+    if (!(table.max_err() < 1e-12) || table.mapped()) {
+        std::cout << "\nERROR (table verification)\n" << "max_err " << table.max_err() << std::endl;
+        return -1;
+    }
+
+    const std::string path = "cplxfnc_check_table.bin";
+    table.save(path);
+    cplxfnc::InterpolationTable mapped(path);
+    std::remove(path.c_str());
+    if (!mapped.mapped() || (mapped.function() != cplxfnc::TABLE_GAMMA_INC) || (mapped.s() != s) ||
+        (mapped.degree() != 16) || (mapped.max_err() != table.max_err())) {
+        std::cout << "\nERROR (mapped table header)" << std::endl;
+        return -1;
+    }
+
+    for (int i = 0; i <= 20; i++) {
+        const std::complex<double> z = lower + 0.1*i + 0.09*i*I;
+        std::complex<double> ref = cplxfnc::gamma_inc(s, z);
+        if ((std::abs(table(z) - ref) > 10*table.max_err()*std::abs(ref) + 1e-15) || (mapped(z) != table(z))) {
+            std::cout << "\nERROR (table lookup)\n" << "z=" << z << " table " << table(z) <<
+            " gamma_inc " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    std::complex<double> res;
+    if ((table(upper + 0.1, &res) != -2) || (table(std::complex<double>(NAN, 0), &res) != -2)) {
+        std::cout << "\nERROR (bounds check)" << std::endl;
+        return -1;
+    }
+    try {
+        cplxfnc::InterpolationTable("cplxfnc_check_no_such_table.bin");
+        std::cout << "\nERROR (loading a missing file should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+
+    // the cut of gamma_inc, a pole of zeta(2, a) and a degree too low for tol
+    const cplxfnc::TableFunction fn[3] = {cplxfnc::TABLE_GAMMA_INC, cplxfnc::TABLE_ZETA, cplxfnc::TABLE_GAMMA_INC};
+    const std::complex<double> s_r[3] = {s, 2., s};
+    const std::complex<double> lower_r[3] = {-1. - I, -2.5 - I, lower};
+    const std::complex<double> upper_r[3] = {1. + I, -1.5 + I, upper};
+    const unsigned int degree_r[3] = {12, 12, 2};
+    for (int i = 0; i < 3; i++) {
+        try {
+            cplxfnc::InterpolationTable(fn[i], s_r[i], lower_r[i], upper_r[i], 1, 1, degree_r[i], settings);
+            std::cout << "\nERROR (table " << i << " should be rejected)" << std::endl;
+            return -1;
+        } catch (const std::runtime_error &) {}
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     derivatives
+// ##################################################
+
+int jet_check()
+{
+    std::cout << "check derivatives ... ";
+
+    const std::complex<double> I(0, 1);
+    const double tol = 1e-14;
+    const cplxfnc::Settings settings(tol);
+    std::complex<double> res[3];
+
+    // zeta(2) = pi^2/6, zeta'(2), zeta''(2)
+    const std::complex<double> zeta_2[3] = {1.6449340668482264, -0.93754825431584375, 1.9892802342989010};
+    if (cplxfnc::zeta_jet_s(2., 1., 2, res, settings) != 0) {
+        std::cout << "\nERROR (zeta_jet_s failed)" << std::endl;
+        return -1;
+    }
+    for (int k = 0; k < 3; k++) {
+        if (std::abs(res[k] - zeta_2[k]) > 10*tol*std::abs(zeta_2[k])) {
+            std::cout << "\nERROR (zeta_jet_s)\n" << "k=" << k << " " << res[k] << " but should be " <<
+            zeta_2[k] << std::endl;
+            return -1;
+        }
+    }
+
+    // d/da zeta(s, a) = -s zeta(s+1, a), d^2/da^2 zeta(s, a) = s (s+1) zeta(s+2, a)
+    const std::complex<double> s = 1.2 + I, a = 2.5 + 3.*I;
+    std::vector<std::complex<double> > d = cplxfnc::zeta_jet_a(s, a, 2, settings);
+    const std::complex<double> ref_a[3] = {cplxfnc::zeta(s, a), -s*cplxfnc::zeta(s + 1., a),
+                                           s*(s + 1.)*cplxfnc::zeta(s + 2., a)};
+    for (int k = 0; k < 3; k++) {
+        if (std::abs(d[k] - ref_a[k]) > 10*tol*std::abs(ref_a[k])) {
+            std::cout << "\nERROR (zeta_jet_a)\n" << "k=" << k << " " << d[k] << " but should be " <<
+            ref_a[k] << std::endl;
+            return -1;
+        }
+    }
+
+    // d/dz Gamma(s, z) = -z^(s-1) e^-z
+    const std::complex<double> z = 1.5 - 0.5*I;
+    d = cplxfnc::gamma_inc_jet_z(s, z, 1, settings);
+    std::complex<double> ref = -std::pow(z, s - 1.)*std::exp(-z);
+    if ((std::abs(d[0] - cplxfnc::gamma_inc(s, z)) > 10*tol*std::abs(d[0])) ||
+        (std::abs(d[1] - ref) > 10*tol*std::abs(ref))) {
+        std::cout << "\nERROR (gamma_inc_jet_z)\n" << d[1] << " but should be " << ref << std::endl;
+        return -1;
+    }
+
+    // d/ds Gamma(s, z) against a central difference, Gamma'(2) = 1 - euler_gamma
+    const double h = 1e-5;
+    d = cplxfnc::gamma_inc_jet_s(s, z, 1, settings);
+    ref = (cplxfnc::gamma_inc(s + h, z) - cplxfnc::gamma_inc(s - h, z)) / (2*h);
+    if ((std::abs(d[0] - cplxfnc::gamma_inc(s, z)) > 10*tol*std::abs(d[0])) ||
+        (std::abs(d[1] - ref) > 1e-8*std::abs(ref))) {
+        std::cout << "\nERROR (gamma_inc_jet_s)\n" << d[1] << " but should be " << ref << std::endl;
+        return -1;
+    }
+    d = cplxfnc::gamma_inc_jet_s(2., 0., 1, settings);
+    if ((std::abs(d[0] - 1.) > 10*tol) || (std::abs(d[1] - 0.42278433509846714) > 10*tol)) {
+        std::cout << "\nERROR (gamma_inc_jet_s at z=0)\n" << d[1] << std::endl;
+        return -1;
+    }
+
+    // at the trivial zero zeta(-2) = 0 a tol out of reach, atol is met (ATOL_MET, no throw)
+    const cplxfnc::Settings atol_settings(1e-300, 2, false, 0, NULL, NULL, NULL, NULL, NULL, 1e-12);
+    const std::complex<double> zeta_m2[3] = {0., -0.030448457058393271, -0.065763516187425196};
+    if (cplxfnc::zeta_jet_s(-2., 1., 2, res, atol_settings) != cplxfnc::ATOL_MET) {
+        std::cout << "\nERROR (zeta_jet_s with atol)" << std::endl;
+        return -1;
+    }
+    try {
+        d = cplxfnc::zeta_jet_s(-2., 1., 2, atol_settings);
+    } catch (const std::runtime_error & e) {
+        std::cout << "\nERROR (zeta_jet_s with atol threw)\n" << e.what() << std::endl;
+        return -1;
+    }
+    for (int k = 0; k < 3; k++) {
+        if (std::abs(d[k] - zeta_m2[k]) > 1e-11) {
+            std::cout << "\nERROR (zeta_jet_s with atol)\n" << "k=" << k << " " << d[k] << " but should be " <<
+            zeta_m2[k] << std::endl;
+            return -1;
+        }
+    }
+
+    if ((cplxfnc::zeta_jet_a(0., 1., 1, res) != -2) || (cplxfnc::gamma_inc_jet_z(1., 0., 1, res) != -2) ||
+        (cplxfnc::gamma_inc_jet_s(-0.5, 0., 1, res) != -2)) {
+        std::cout << "\nERROR (jet value errors)" << std::endl;
+        return -1;
+    }
+    try {
+        cplxfnc::zeta_jet_s(1.2 + I, 1. + 1234.*I, 2, cplxfnc::Settings(tol, 1, false, 8));
+        std::cout << "\nERROR (zeta_jet_s should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     sequences
+// ##################################################
+
+int sequence_check()
+{
+    std::cout << "check sequences ... ";
+
+    const std::complex<double> I(0, 1);
+    const double tol = 1e-14;
+    const std::size_t n = 40;
+    std::complex<double> res[n];
+    // forward stable, backward stable (Re(s) < 0, small z) and complex arguments
+    const std::complex<double> s[4] = {0.5, -10.5, -30.3 + 2.*I, 2. + 3.*I};
+    const std::complex<double> z[4] = {2., 1., 5., 20. - 5.*I};
+    for (int i = 0; i < 4; i++) {
+        std::size_t anchors;
+        if ((cplxfnc::gamma_inc_sequence(s[i], z[i], n, res, cplxfnc::Settings(tol), &anchors) != 0) ||
+            (anchors > 4)) {
+            std::cout << "\nERROR (gamma_inc_sequence failed)\n" << "s=" << s[i] << " z=" << z[i] << std::endl;
+            return -1;
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            std::complex<double> ref = cplxfnc::gamma_inc(s[i] + double(k), z[i]);
+            if (std::abs(res[k] - ref) > 10*tol*std::abs(ref)) {
+                std::cout << "\nERROR (gamma_inc_sequence)\n" << "s=" << s[i] << " z=" << z[i] << " k=" << k <<
+                "\nreturned      : " << res[k] << "\nbut should be : " << ref << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    // zeta(s, a+k), backward stable for large Re(s)
+    const std::complex<double> sz[4] = {1.2, 10., 1.2 + 10.*I, -2.5};
+    const std::complex<double> az[4] = {1., 1., 0.5 + 2.*I, 1.5};
+    for (int i = 0; i < 4; i++) {
+        std::size_t anchors;
+        if ((cplxfnc::zeta_sequence(sz[i], az[i], n, res, cplxfnc::Settings(tol), &anchors) != 0) || (anchors > 4)) {
+            std::cout << "\nERROR (zeta_sequence failed)\n" << "s=" << sz[i] << " a=" << az[i] << std::endl;
+            return -1;
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            std::complex<double> ref = cplxfnc::zeta(sz[i], az[i] + double(k));
+            if (std::abs(res[k] - ref) > 10*tol*std::abs(ref)) {
+                std::cout << "\nERROR (zeta_sequence)\n" << "s=" << sz[i] << " a=" << az[i] << " k=" << k <<
+                "\nreturned      : " << res[k] << "\nbut should be : " << ref << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    if ((cplxfnc::gamma_inc_sequence(-0.5, 0., 3, res) != -2) || !std::isnan(res[2].real())) {
+        std::cout << "\nERROR (gamma_inc_sequence value error)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+int typed_check()
+{
+    std::cout << "check typed results ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::complex<double> s[3] = {0.5, 2. + 3.*I, -10.5};
+    const std::complex<double> z[3] = {2., 20. - 5.*I, 1.};
+    for (int i = 0; i < 3; i++) {
+        std::complex<double> ref = cplxfnc::gamma_inc(s[i], z[i]);
+        std::complex<float> f = cplxfnc::gamma_inc<std::complex<float> >(s[i], z[i]);
+        std::complex<long double> l = cplxfnc::gamma_inc<std::complex<long double> >(s[i], z[i]);
+        cplxfnc::ComplexDD dd = cplxfnc::gamma_inc<cplxfnc::ComplexDD>(s[i], z[i]);
+        std::complex<double> hi(dd.real.hi, dd.imag.hi);
+        if ((std::abs(std::complex<double>(f) - ref) > 4e-7*std::abs(ref)) ||
+            (std::abs(std::complex<double>(l) - ref) > 1e-15*std::abs(ref)) ||
+            (std::abs(hi - ref) > 1e-15*std::abs(ref)) ||
+            (std::abs(dd.real.lo) > 1.2e-16*std::abs(dd.real.hi)) ||
+            (std::abs(dd.imag.lo) > 1.2e-16*std::abs(dd.imag.hi))) {
+            std::cout << "\nERROR (typed gamma_inc)\n" << "s=" << s[i] << " z=" << z[i] <<
+            "\nfloat         : " << f << "\nlong double   : " << l <<
+            "\ndouble-double : " << hi << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    // zeta(2) = pi^2/6 and gamma_inc(0.5, 2) to double-double
+    cplxfnc::ComplexDD dd;
+    if ((cplxfnc::zeta(2., 1., &dd) != 0) || (dd.real.hi != 1.6449340668482264) ||
+        (std::abs(dd.real.lo - 3.040672350398476e-17) > 1e-32) || (dd.imag.hi != 0)) {
+        std::cout << "\nERROR (typed zeta)\nreturned      : " << dd.real.hi << " + " << dd.real.lo << std::endl;
+        return -1;
+    }
+    if ((cplxfnc::gamma_inc(0.5, 2., &dd) != 0) || (dd.real.hi != 0.08064711796031769) ||
+        (std::abs(dd.real.lo - 3.3969178907000144e-20) > 1e-33)) {
+        std::cout << "\nERROR (typed gamma_inc)\nreturned      : " << dd.real.hi << " + " << dd.real.lo << std::endl;
+        return -1;
+    }
+
+    // a float result needs fewer bits than a double result
+    struct cplxfnc_stats st;
+    cplxfnc_stats_reset();
+    std::complex<float> f = cplxfnc::u_asymp<std::complex<float> >(1., 2., 30.);
+    cplxfnc_stats_read(CPLXFNC_STATS_U_ASYMP, &st);
+    unsigned int bin_float = 0;
+    while (st.prec_hist[bin_float] == 0) bin_float++;
+    cplxfnc_stats_reset();
+    std::complex<double> d = cplxfnc::u_asymp(1., 2., 30.);
+    cplxfnc_stats_read(CPLXFNC_STATS_U_ASYMP, &st);
+    unsigned int bin_double = 0;
+    while (st.prec_hist[bin_double] == 0) bin_double++;
+    if ((bin_float >= bin_double) || (std::abs(std::complex<double>(f) - d) > 4e-7*std::abs(d))) {
+        std::cout << "\nERROR (typed u_asymp)\nfloat precision bin " << bin_float <<
+        ", double precision bin " << bin_double << std::endl;
+        return -1;
+    }
+
+    if (cplxfnc::gamma_inc(-0.5, 0., &f) != -2) {
+        std::cout << "\nERROR (typed gamma_inc value error)" << std::endl;
+        return -1;
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+int dd_batch_check()
+{
+    std::cout << "check double-double batch ... ";
+
+    const std::complex<double> I(0, 1);
+    const std::size_t n = 4;
+    const std::complex<double> s[n] = {0.5, 2. + 3.*I, -10.5, -0.5};
+    const std::complex<double> z[n] = {2., 20. - 5.*I, 1., 0.};
+    std::complex<double> hi[n], lo[n];
+    int status[n];
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    std::size_t n_fail = cplxfnc::gamma_inc_dd_batch(n, s, c, z, c, hi, c, lo, c, status, sizeof(int));
+    if ((n_fail != 1) || (status[3] != -2) || !std::isnan(hi[3].real()) || !std::isnan(lo[3].real())) {
+        std::cout << "\nERROR (gamma_inc_dd_batch status)" << std::endl;
+        return -1;
+    }
+    for (std::size_t i = 0; i < n - 1; i++) {
+        cplxfnc::ComplexDD ref = cplxfnc::gamma_inc<cplxfnc::ComplexDD>(s[i], z[i]);
+        if ((status[i] != 0) || (hi[i] != std::complex<double>(ref.real.hi, ref.imag.hi)) ||
+            (lo[i] != std::complex<double>(ref.real.lo, ref.imag.lo))) {
+            std::cout << "\nERROR (gamma_inc_dd_batch)\n" << "s=" << s[i] << " z=" << z[i] <<
+            "\nreturned      : " << hi[i] << " + " << lo[i] <<
+            "\nbut should be : " << ref.real.hi << " + " << ref.real.lo << std::endl;
+            return -1;
+        }
+    }
+
+    // a coarser tol, broadcast s
+    const std::complex<double> a[n] = {1., 1.5, 2. + I, 10.};
+    cplxfnc::zeta_dd_batch(n, s + 1, 0, a, c, hi, c, lo, c, status, sizeof(int), 1e-24);
+    for (std::size_t i = 0; i < n; i++) {
+        std::complex<double> ref = cplxfnc::zeta(s[1], a[i]);
+        if ((status[i] != 0) || (std::abs(hi[i] - ref) > 1e-15*std::abs(ref))) {
+            std::cout << "\nERROR (zeta_dd_batch)\n" << "a=" << a[i] <<
+            "\nreturned      : " << hi[i] << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     real arguments
+// ##################################################
+
+int real_check()
+{
+    std::cout << "check real arguments ... ";
+
+    const std::size_t n = 5;
+    const double s[n] = {0.5, 2., -10.5, 3.5, -0.5};
+    const double z[n] = {2., 20., 1., 0., 0.};
+    double res[n];
+    int status[n];
+    std::size_t n_fail = cplxfnc::gamma_inc_real_batch(n, s, sizeof(double), z, sizeof(double),
+                                                       res, sizeof(double), status, sizeof(int));
+    if ((n_fail != 1) || (status[4] != -2) || !std::isnan(res[4])) {
+        std::cout << "\nERROR (gamma_inc_real_batch status)" << std::endl;
+        return -1;
+    }
+    for (std::size_t i = 0; i < n - 1; i++) {
+        std::complex<double> ref = cplxfnc::gamma_inc(s[i], z[i]);
+        if ((status[i] != 0) || (std::abs(res[i] - ref) > 2e-16*std::abs(ref))) {
+            std::cout << "\nERROR (gamma_inc_real_batch)\n" << "s=" << s[i] << " z=" << z[i] <<
+            "\nreturned      : " << res[i] << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    // zeta(2) = pi^2/6, broadcast s
+    const double a[n] = {1., 1.5, 0.1, 10., 1e3};
+    cplxfnc::zeta_real_batch(n, s + 1, 0, a, sizeof(double), res, sizeof(double), status, sizeof(int));
+    for (std::size_t i = 0; i < n; i++) {
+        std::complex<double> ref = cplxfnc::zeta(s[1], a[i]);
+        if ((status[i] != 0) || (std::abs(res[i] - ref) > 2e-16*std::abs(ref))) {
+            std::cout << "\nERROR (zeta_real_batch)\n" << "a=" << a[i] <<
+            "\nreturned      : " << res[i] << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+    if (std::abs(cplxfnc::zeta_real(2., 1.) - 1.6449340668482264) > 2e-16) {
+        std::cout << "\nERROR (zeta_real)" << std::endl;
+        return -1;
+    }
+
+    // the result is not real
+    double r;
+    if ((cplxfnc::zeta_real(2., -0.5, &r) != -2) || (cplxfnc::gamma_inc_real(0.5, -1., &r) != -2)) {
+        std::cout << "\nERROR (real value error)" << std::endl;
+        return -1;
+    }
+    try {
+        cplxfnc::gamma_inc_real(0.5, -1.);
+        std::cout << "\nERROR (gamma_inc_real should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+
+    std::cout << "done\n";
+    return 0;
+}
+
+// ##################################################
+// ##     path continuation
+// ##################################################
+
+int path_check()
+{
+    std::cout << "check path continuation ... ";
+
+    const std::complex<double> I(0, 1);
+    const double tol = 1e-14;
+    const std::size_t n = 200;
+    std::complex<double> z[n], res[n];
+
+    // a slowly varying path, and one crossing the branch cut on the negative real axis
+    const std::complex<double> s[2] = {2.5 + 1.*I, 0.5 + 1.*I};
+    const std::complex<double> z_from[2] = {2., -2. + 0.5*I};
+    const std::complex<double> z_to[2] = {4. + 1.5*I, -2. - 0.5*I};
+    for (int i = 0; i < 2; i++) {
+        for (std::size_t k = 0; k < n; k++) z[k] = z_from[i] + (z_to[i] - z_from[i]) * (double(k) / (n - 1));
+        std::size_t anchors;
+        if (cplxfnc::gamma_inc_path(s[i], n, z, res, cplxfnc::Settings(tol), &anchors) != 0) {
+            std::cout << "\nERROR (gamma_inc_path failed)\n" << "s=" << s[i] << std::endl;
+            return -1;
+        }
+        if ((i == 0) && (anchors > 10)) {
+            std::cout << "\nERROR (gamma_inc_path anchors)\n" << "anchors=" << anchors << std::endl;
+            return -1;
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            std::complex<double> ref = cplxfnc::gamma_inc(s[i], z[k]);
+            if (std::abs(res[k] - ref) > 10*tol*std::abs(ref)) {
+                std::cout << "\nERROR (gamma_inc_path)\n" << "s=" << s[i] << " z=" << z[k] <<
+                "\nreturned      : " << res[k] << "\nbut should be : " << ref << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    const std::complex<double> a = 0.3 + 0.2*I, b = 1.5;
+    cplxfnc::UAsympPath u(a, b, cplxfnc::Settings(tol));
+    for (std::size_t k = 0; k < n; k++) {
+        const std::complex<double> zk = 20. + 5.*I * (double(k) / (n - 1));
+        std::complex<double> ref = cplxfnc::u_asymp(a, b, zk);
+        std::complex<double> r = u(zk);
+        if (std::abs(r - ref) > 10*tol*std::abs(ref)) {
+            std::cout << "\nERROR (UAsympPath)\n" << "z=" << zk <<
+            "\nreturned      : " << r << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+    if ((u.anchors() > 10) || (u.anchors() + u.steps() != n)) {
+        std::cout << "\nERROR (UAsympPath anchors)\n" << "anchors=" << u.anchors() << std::endl;
+        return -1;
+    }
+
+    // with a single attempt the guard bits of an anchor are out of reach, a point
+    // gamma_inc meets anyway must not fail
+    std::complex<double> r;
+    for (int i = 0; i < 2; i++) {
+        cplxfnc::GammaIncPath p(s[i], cplxfnc::Settings(tol, 1));
+        std::complex<double> ref;
+        const int status = cplxfnc::gamma_inc(s[i], z_from[i], &ref, NULL, cplxfnc::Settings(tol, 1));
+        if ((status == 0) && ((p(z_from[i], &r) != 0) || (std::abs(r - ref) > tol*std::abs(ref)))) {
+            std::cout << "\nERROR (path anchor fallback)\n" << "s=" << s[i] << " z=" << z_from[i] <<
+            "\nreturned      : " << r << "\nbut should be : " << ref << std::endl;
+            return -1;
+        }
+    }
+
+    // the value errors of gamma_inc and u_asymp
+    cplxfnc::GammaIncPath g(-0.5);
+    if ((g(1., &r) != 0) || (g(0., &r) != -2) || (u(0.1, &r) != -2)) {
+        std::cout << "\nERROR (path value error)" << std::endl;
+        return -1;
+    }
+    try {
+        g(0.);
+        std::cout << "\nERROR (GammaIncPath should throw)" << std::endl;
+        return -1;
+    } catch (const std::runtime_error &) {}
+
+    std::cout << "done\n";
+    return 0;
+}
+
 int main(){
     std::cout << "\nrun tests for cplxfnc library\n";
 
@@ -406,6 +1913,7 @@ int main(){
     if (check_values()) return -1;
     if (check_call_error()) return -1;
     if (check_call_overloads()) return -1;
+    if (hurwitz_zeta_check_values()) return -1;
 
     std::cout << "\ntest Incomplete Gamma\n";
     if (gamma_inc_simple_run()) return -1;
@@ -415,6 +1923,64 @@ int main(){
     if (gamma_inc_large_values()) return -1;
     if (u_asymp_simple_run()) return -1;
 
+    std::cout << "\ntest batch evaluation\n";
+    if (batch_check_values()) return -1;
+    if (batch_check_status()) return -1;
+    if (parallel_check_values()) return -1;
+    if (async_check_values()) return -1;
+
+    std::cout << "\ntest adaptive initial precision\n";
+    if (predictor_check()) return -1;
+
+    std::cout << "\ntest precision escalation\n";
+    if (policy_check()) return -1;
+
+    std::cout << "\ntest result cache\n";
+    if (cache_check()) return -1;
+
+    std::cout << "\ntest double precision fast path\n";
+    if (fast_path_check()) return -1;
+
+    std::cout << "\ntest persistent evaluators\n";
+    if (evaluator_check()) return -1;
+
+    std::cout << "\ntest deadlines and cancellation\n";
+    if (stop_check()) return -1;
+
+    std::cout << "\ntest absolute tolerance\n";
+    if (atol_check()) return -1;
+
+    std::cout << "\ntest special values\n";
+    if (special_check()) return -1;
+
+    std::cout << "\ntest cost estimates\n";
+    if (estimate_check()) return -1;
+
+    std::cout << "\ntest instrumentation counters\n";
+    if (stats_check()) return -1;
+
+    std::cout << "\ntest diagnostics\n";
+    if (trace_check()) return -1;
+
+    std::cout << "\ntest interpolation tables\n";
+    if (table_check()) return -1;
+
+    std::cout << "\ntest derivatives\n";
+    if (jet_check()) return -1;
+
+    std::cout << "\ntest sequences\n";
+    if (sequence_check()) return -1;
+
+    std::cout << "\ntest typed results\n";
+    if (typed_check()) return -1;
+    if (dd_batch_check()) return -1;
+
+    std::cout << "\ntest real arguments\n";
+    if (real_check()) return -1;
+
+    std::cout << "\ntest path continuation\n";
+    if (path_check()) return -1;
+
 
     return 0;
 }
@@ -0,0 +1,132 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "acb_hypgeom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     cost estimates
+// ##
+// ##     The model: an attempt at prec gives a relative error of 2^(loss - prec),
+// ##     loss are the bits lost to cancellation plus ESTIMATE_GUARD_BITS. The
+// ##     escalation loop is replayed with err_bits = loss - prec until the error
+// ##     meets tol or the limit is reached.
+// ##     loss (in bits, heuristic):
+// ##       zeta       log2(1 + |s|) + |Im(s) arg(a)| / ln 2, 0 for the closed forms
+// ##       gamma_inc  log2(1 + |s|) + max(0, -Re(z)) / ln 2
+// ##       u_asymp    log2(1 + |a| + |b|)
+// ##     With a predictor holding data for the main argument its predicted
+// ##     precision replaces bits + loss.
+// ##################################################
+
+namespace {
+
+const double ESTIMATE_GUARD_BITS = 2;
+const double LN2 = 0.6931471805599453;
+
+CostEstimate replay(const detail::Config & cfg, std::complex<double> x, double loss, unsigned int default_init_prec)
+{
+    CostEstimate est;
+    est.status = 0;
+    est.cost = 0;
+
+    // the precision needed: predicted or bits + loss
+    double needed = -double(cfg.err_bits_ref) + loss + ESTIMATE_GUARD_BITS;
+    if (cfg.predictor != NULL) {
+        const unsigned int p = cfg.predictor->predict(x);
+        if (p > 0) needed = p;
+    }
+
+    unsigned int prec = cfg.start_prec(x);
+    unsigned int c = 1;
+    while (1) {
+        const double r = double(prec) / default_init_prec;
+        est.cost += r * r;
+        if (prec >= needed) break;
+        if (c >= cfg.limit) {
+            est.status = -1;
+            break;
+        }
+        prec = cfg.next_prec(prec, slong(std::ceil(needed + cfg.err_bits_ref)) - slong(prec));
+        c += 1;
+    }
+    est.prec = prec;
+    est.attempts = c;
+    return est;
+}
+
+CostEstimate value_error()
+{
+    CostEstimate est;
+    est.status = -2;
+    est.prec = 0;
+    est.attempts = 0;
+    est.cost = 0;
+    return est;
+}
+
+}
+
+CostEstimate zeta_estimate(std::complex<double> s, std::complex<double> a, const Settings & settings)
+{
+    const detail::Config cfg(settings, ZETA_DEFAULT_INIT_PREC);
+    double loss = 0;
+    if (detail::zeta_special(s, a) == detail::SPECIAL_NONE) {
+        loss = std::log2(1 + std::abs(s)) + std::abs(s.imag() * std::arg(a)) / LN2;
+    }
+    return replay(cfg, a, loss, ZETA_DEFAULT_INIT_PREC);
+}
+
+CostEstimate gamma_inc_estimate(std::complex<double> s, std::complex<double> z, const Settings & settings)
+{
+    if ((s.real() < 0) && (z.real() == 0) && (z.imag() == 0)) return value_error();
+    const detail::Config cfg(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+    const double loss = std::log2(1 + std::abs(s)) + std::max(0., -z.real()) / LN2;
+    return replay(cfg, z, loss, GAMMA_INC_DEFAULT_INIT_PREC);
+}
+
+CostEstimate u_asymp_estimate(std::complex<double> a, std::complex<double> b, std::complex<double> z,
+                              const Settings & settings)
+{
+    const detail::Config cfg(settings, U_ASYMP_DEFAULT_INIT_PREC);
+    acb_t z_b;
+    acb_init(z_b);
+    acb_set_d_d(z_b, z.real(), z.imag());
+    const bool asymp = acb_hypgeom_u_use_asymp(z_b, -cfg.err_bits_ref);
+    acb_clear(z_b);
+    if (!asymp) return value_error();
+    const double loss = std::log2(1 + std::abs(a) + std::abs(b));
+    return replay(cfg, z, loss, U_ASYMP_DEFAULT_INIT_PREC);
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,549 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     double precision fast path
+// ##################################################
+
+FastPath::FastPath() : n_fast(0), n_arb(0) {}
+
+unsigned long FastPath::fast() const { return n_fast.load(std::memory_order_relaxed); }
+unsigned long FastPath::arb() const { return n_arb.load(std::memory_order_relaxed); }
+
+void FastPath::reset_stats()
+{
+    n_fast.store(0, std::memory_order_relaxed);
+    n_arb.store(0, std::memory_order_relaxed);
+}
+
+void FastPath::count(bool fast)
+{
+    if (fast) {
+        n_fast.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        n_arb.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+namespace {
+
+const double U = 1.1102230246251565e-16;    // the unit roundoff 2^-53
+const double INF = std::numeric_limits<double>::infinity();
+
+// ##################################################
+// ##     elementary functions on the lanes
+// ##
+// ##     exp, log, sincos and atan from +, -, *, / and bit operations only, so the
+// ##     loops over the lanes which call them are vectorised (calls into libm are
+// ##     not, and libm does not specify its accuracy). Their errors are at most
+// ##       exp_lane(x)      EXP_ERR u relative                      EXP_MIN <= x <= EXP_MAX
+// ##       log_lane(x)      u (LOG_ERR_REL |log x| + LOG_ERR_ABS)   normal x > 0
+// ##       sincos_lane(x)   SINCOS_ERR u                            |x| <= SINCOS_MAX
+// ##       atan_lane(x)     ATAN_ERR u
+// ##     with u = 2^-53. Each bound adds the error of the argument reduction, the
+// ##     truncation error of the Taylor polynomial and a first order bound of the
+// ##     rounding errors of its Horner scheme at the largest reduced argument
+// ##     (4.9, 1.0 and 1.4, 3.2 and 6.1), rounded up.
+// ##################################################
+
+const double EXP_ERR = 6;
+const double LOG_ERR_REL = 1.25;
+const double LOG_ERR_ABS = 2;
+const double SINCOS_ERR = 4;
+const double ATAN_ERR = 8;
+
+const double EXP_MIN = -708;                // exp_lane stays normal
+const double EXP_MAX = 709;
+const double SINCOS_MAX = 1e6;              // the quadrant stays below 2^20
+
+const double SHIFTER = 6755399441055744.0;  // 1.5 2^52, x + SHIFTER rounds x to an integer
+const double TWO52 = 4503599627370496.0;
+const double INV_LN2 = 1.4426950408889634;
+const double LN2_HI = 6.93147180369123816490e-01;      // 32 bits, k LN2_HI is exact
+const double LN2_LO = 1.90821492927058770002e-10;
+const double SQRT1_2 = 0.7071067811865476;
+const std::uint64_t SIGN_BIT = 0x8000000000000000ULL;
+const std::uint64_t EXPONENT_BITS = 0xfff0000000000000ULL;     // with the sign bit
+const double TWO_OVER_PI = 0.6366197723675814;
+const double PIO2_HI = 1.57079632673412561417e+00;     // 31 bits, k PIO2_HI is exact
+const double PIO2_LO = 6.07710050650619224932e-11;
+const double TAN_PI_8 = 0.41421356237309503;
+const double PI_4 = 0.7853981633974483;
+const double PI_2 = 1.5707963267948966;
+
+// 1/j!, j = 0 ... 13
+const double EXP_C[14] = {
+    1.0,                     1.0,                     0.5,
+    0.16666666666666666,     0.041666666666666664,    0.008333333333333333,
+    0.001388888888888889,    0.0001984126984126984,   2.48015873015873e-05,
+    2.7557319223985893e-06,  2.755731922398589e-07,   2.505210838544172e-08,
+    2.08767569878681e-09,    1.6059043836821613e-10 };
+
+// 1/(2j+1), j = 1 ... 11
+const double LOG_C[11] = {
+    0.3333333333333333,      0.2,                     0.14285714285714285,
+    0.1111111111111111,      0.09090909090909091,     0.07692307692307693,
+    0.06666666666666667,     0.058823529411764705,    0.05263157894736842,
+    0.047619047619047616,    0.043478260869565216 };
+
+// (-1)^j / (2j+1)!, j = 0 ... 8
+const double SIN_C[9] = {
+    1.0,                    -0.16666666666666666,     0.008333333333333333,
+   -0.0001984126984126984,   2.7557319223985893e-06, -2.505210838544172e-08,
+    1.6059043836821613e-10, -7.647163731819816e-13,   2.8114572543455206e-15 };
+
+// (-1)^j / (2j)!, j = 0 ... 9
+const double COS_C[10] = {
+    1.0,                    -0.5,                     0.041666666666666664,
+   -0.001388888888888889,    2.48015873015873e-05,   -2.755731922398589e-07,
+    2.08767569878681e-09,   -1.1470745597729725e-11,  4.779477332387385e-14,
+   -1.5619206968586225e-16 };
+
+// (-1)^(j+1) / (2j+3), j = 0 ... 25
+const double ATAN_C[26] = {
+   -0.3333333333333333,      0.2,                    -0.14285714285714285,
+    0.1111111111111111,     -0.09090909090909091,     0.07692307692307693,
+   -0.06666666666666667,     0.058823529411764705,   -0.05263157894736842,
+    0.047619047619047616,   -0.043478260869565216,    0.04,
+   -0.037037037037037035,    0.034482758620689655,   -0.03225806451612903,
+    0.030303030303030304,   -0.02857142857142857,     0.02702702702702703,
+   -0.02564102564102564,     0.024390243902439025,   -0.023255813953488372,
+    0.022222222222222223,   -0.02127659574468085,     0.02040816326530612,
+   -0.0196078431372549,      0.018867924528301886 };
+
+inline std::uint64_t to_bits(double x)
+{
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b;
+}
+
+inline double from_bits(std::uint64_t b)
+{
+    double x;
+    std::memcpy(&x, &b, sizeof(x));
+    return x;
+}
+
+// c[0] + x (c[1] + x (... + x c[J])), unrolled
+template <int J> struct Horner {
+    static double eval(double x, const double * c) { return c[0] + x * Horner<J-1>::eval(x, c + 1); }
+};
+
+template <> struct Horner<0> {
+    static double eval(double, const double * c) { return c[0]; }
+};
+
+// the integer 0 <= i < 2^52 as double
+inline double small_int(std::uint64_t i) { return from_bits(to_bits(TWO52) | i) - TWO52; }
+
+inline double exp_lane(double x)
+{
+    // x = k ln2 + r with |r| <= ln2/2, x - k LN2_HI is exact (Sterbenz)
+    const double t = x * INV_LN2 + SHIFTER;
+    const double k = t - SHIFTER;
+    const double r = (x - k * LN2_HI) - k * LN2_LO;
+    const double p = Horner<13>::eval(r, EXP_C);
+    // the low bits of t hold k, 2^k is built from them
+    return p * from_bits((to_bits(t) - to_bits(SHIFTER) + 1023) << 52);
+}
+
+inline double log_lane(double x)
+{
+    // x = 2^e m with sqrt(1/2) <= m < sqrt(2), log(m) = 2 atanh(f) with f = (m-1)/(m+1).
+    // Offsetting the bits of x by those of sqrt(1/2) moves e into the exponent field.
+    const std::uint64_t b = to_bits(x);
+    const std::uint64_t t = b + (SIGN_BIT - to_bits(SQRT1_2));
+    const double e = small_int(t >> 52) - 2048;
+    const double m = from_bits(b - (t & EXPONENT_BITS) + SIGN_BIT);
+    const double f = (m - 1) / (m + 1);
+    const double f2 = f * f;
+    const double p = Horner<10>::eval(f2, LOG_C);
+    const double lm = 2 * f + 2 * f * (f2 * p);
+    return e * LN2_HI + (e * LN2_LO + lm);
+}
+
+inline void sincos_lane(double x, double & s, double & c)
+{
+    // x = k pi/2 + r with |r| <= pi/4, x - k PIO2_HI is exact (Sterbenz)
+    const double t = x * TWO_OVER_PI + SHIFTER;
+    const double k = t - SHIFTER;
+    const double r = (x - k * PIO2_HI) - k * PIO2_LO;
+    const double r2 = r * r;
+    const double sr = r * Horner<8>::eval(r2, SIN_C);
+    const double pc = Horner<9>::eval(r2, COS_C);
+    // the quadrant k mod 4 from the low bits of t selects and negates with bit masks
+    const std::uint64_t q = to_bits(t) - to_bits(SHIFTER);
+    const std::uint64_t swap = 0 - (q & 1);
+    s = from_bits(((to_bits(pc) & swap) | (to_bits(sr) & ~swap)) ^ (((q >> 1) & 1) << 63));
+    c = from_bits(((to_bits(sr) & swap) | (to_bits(pc) & ~swap)) ^ (((q ^ (q >> 1)) & 1) << 63));
+}
+
+inline double atan_lane(double x)
+{
+    // atan(a) = pi/2 - atan(1/a) for a > 1 and atan(b) = pi/4 + atan((b-1)/(b+1))
+    // for b > tan(pi/8) leave |c| <= tan(pi/8) for the series
+    const double a = std::abs(x);
+    const double a_inv = 1 / a;
+    const double b = (a > 1) ? a_inv : a;
+    const double b_red = (b - 1) / (b + 1);
+    const double c = (b > TAN_PI_8) ? b_red : b;
+    const double c2 = c * c;
+    const double r1 = c + (c * c2) * Horner<25>::eval(c2, ATAN_C);
+    const double r2 = PI_4 + r1;
+    const double r3 = (b > TAN_PI_8) ? r2 : r1;
+    const double r4 = PI_2 - r3;
+    const double r = (a > 1) ? r4 : r3;
+    return (x < 0) ? -r : r;
+}
+
+// ##################################################
+// ##     complex doubles with an error bound
+// ##
+// ##     The radius of a result bounds the propagated radii to first order and
+// ##     the rounding errors of the operation by u times the 1-norms of the
+// ##     intermediate results. The neglected second order terms and the rounding
+// ##     errors of the radii themselves stay below 1e-9 of the radii in the
+// ##     domains of the kernels, the final bounds are multiplied by SAFETY = 2.
+// ##################################################
+
+const double SAFETY = 2;
+
+struct Ball {
+    double re, im, rad;
+};
+
+inline Ball ball(double re, double im=0, double rad=0)
+{
+    Ball b = {re, im, rad};
+    return b;
+}
+
+inline double norm1(const Ball & x) { return std::abs(x.re) + std::abs(x.im); }
+
+Ball operator-(const Ball & x) { return ball(-x.re, -x.im, x.rad); }
+
+Ball operator+(const Ball & x, const Ball & y)
+{
+    Ball r = ball(x.re + y.re, x.im + y.im);
+    r.rad = x.rad + y.rad + U * norm1(r);
+    return r;
+}
+
+Ball operator*(const Ball & x, const Ball & y)
+{
+    Ball r = ball(x.re * y.re - x.im * y.im, x.re * y.im + x.im * y.re);
+    r.rad = x.rad * (norm1(y) + y.rad) + norm1(x) * y.rad + 2 * U * norm1(x) * norm1(y);
+    return r;
+}
+
+// 1/x for 1e-150 <= |x| <= 1e150
+Ball inv(const Ball & x)
+{
+    const double q = x.re * x.re + x.im * x.im;
+    Ball r = ball(x.re / q, -x.im / q);
+    const double m = std::sqrt(q) * (1 - 4 * U);                // <= |x|
+    r.rad = (m > x.rad) ? x.rad / (m * (m - x.rad)) + 3.01 * U * norm1(r) : INF;
+    return r;
+}
+
+// 1/x and log(x) for real normal x > 0
+Ball inv_real(const Ball & x)
+{
+    const double m = x.re - x.rad;
+    return ball(1 / x.re, 0, (m > 0) ? x.rad / (x.re * m) + U / x.re : INF);
+}
+
+Ball log_real(const Ball & x)
+{
+    const double l = log_lane(x.re);
+    const double m = x.re - x.rad;
+    return ball(l, 0, (m > 0) ? x.rad / m + U * (LOG_ERR_REL * std::abs(l) + LOG_ERR_ABS) : INF);
+}
+
+// false if x leaves the ranges of exp_lane and sincos_lane
+bool exp_ball(const Ball & x, Ball & r)
+{
+    if (!((x.re >= EXP_MIN) && (x.re <= EXP_MAX) && (std::abs(x.im) <= SINCOS_MAX) && (x.rad <= 1e-3))) {
+        return false;
+    }
+    const double m = exp_lane(x.re);
+    double s, c;
+    sincos_lane(x.im, s, c);
+    r = ball(m * c, m * s);
+    // |exp(x+d) - exp(x)| <= |exp(x)| |d| e^|d|
+    r.rad = m * (1.01 * x.rad + 2 * (EXP_ERR + SINCOS_ERR + 1) * U);
+    return true;
+}
+
+// |x| rounded down
+double abs_lower(const Ball & x) { return std::sqrt(x.re * x.re + x.im * x.im) * (1 - 4 * U); }
+
+// ##################################################
+// ##     Euler-Maclaurin summation for zeta(s, a), a > 0
+// ##
+// ##     zeta(s, a) = sum_{k<N} (a+k)^-s + (a+N)^(1-s) / (s-1) + (a+N)^-s / 2
+// ##                + sum_{j=1}^M B_2j / (2j)! (s)_(2j-1) (a+N)^(-s-2j+1) + R
+// ##     |R| <= 4 |(s)_2M| / (2 pi)^2M (a+N)^(-Re(s)-2M+1) / (Re(s)+2M-1)
+// ##     (F. Johansson, Numer. Algorithms 69 (2015), theorem 1)
+// ##################################################
+
+const int ZETA_M = 12;
+const double ZETA_MAX_ABS_S = 32;
+const double INV_TWO_PI_2M = 6.977231927006102e-20;    // (2 pi)^-2M
+
+// B_2j / (2j)!, j = 1 ... ZETA_M
+const double BERNOULLI_FAC[ZETA_M] = {
+    0.083333333333333329,   -0.0013888888888888889,   3.3068783068783071e-05,
+   -8.2671957671957675e-07,  2.08767569878681e-08,   -5.2841901386874932e-10,
+    1.3382536530684679e-11, -3.3896802963225827e-13,  8.5860620562778452e-15,
+   -2.1748686985580619e-16,  5.5090028283602295e-18, -1.3954464685812522e-19 };
+
+bool zeta_fast_domain(std::complex<double> s, std::complex<double> a)
+{
+    return (a.imag() == 0) && (a.real() >= std::numeric_limits<double>::min()) && std::isfinite(a.real()) &&
+           std::isfinite(s.real()) && std::isfinite(s.imag()) &&
+           (std::abs(s) <= ZETA_MAX_ABS_S) && (std::abs(s - 1.) >= 1e-100) &&
+           (s.real() + 2*ZETA_M - 1 > 0);
+}
+
+// ##################################################
+// ##     asymptotic series for gamma(s, z), Re(z) > 0
+// ##
+// ##     gamma(s, z) = z^(s-1) e^-z sum_{k<n} (s-1)...(s-k) z^-k + R_n
+// ##     with R_n = (s-1)...(s-n) gamma(s-n, z). For n >= Re(s) - 1 integrating
+// ##     along the horizontal ray from z gives
+// ##     |R_n| <= |(s-1)...(s-n)| |z|^(Re(s)-n-1) e^(|Im(s) arg(z)|) e^-Re(z)
+// ##################################################
+
+const int GAMMA_INC_MAX_TERMS = 64;
+const double GAMMA_INC_MAX_IM_S = 1e6;
+
+bool gamma_inc_fast_domain(std::complex<double> s, std::complex<double> z)
+{
+    return (z.real() > 0) && std::isfinite(z.real()) && std::isfinite(z.imag()) &&
+           (std::abs(z) >= 1e-150) && (std::abs(z) <= 1e150) &&
+           std::isfinite(s.real()) && std::isfinite(s.imag()) &&
+           (s.real() - 1 < GAMMA_INC_MAX_TERMS) && (std::abs(s.imag()) <= GAMMA_INC_MAX_IM_S);
+}
+
+} /* namespace */
+
+// The kernels run over the FAST_LANES lanes in lock step with the real and imaginary
+// parts in separate arrays. The loops over the lanes which sum the series are free of
+// dependencies, branches and libm calls and are vectorised by the compiler. Lanes
+// outside the domain of the kernel (or beyond n) are computed with harmless dummy
+// arguments and rejected. A result is accepted if its error bound, which covers the
+// truncation and all rounding errors, is at most 2^err_bits_ref relative to the
+// smallest modulus the exact value can have.
+
+void detail::zeta_fast(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+                       slong err_bits_ref, std::complex<double> * res, bool * ok)
+{
+    const std::size_t L = FAST_LANES;
+    const double target = std::ldexp(1., int(err_bits_ref));
+    double s_re[L], s_im[L], x0[L], err_a[L], err_b[L];
+    bool in_domain[L];
+    double n_terms = 0;
+    for (std::size_t l = 0; l < L; l++) {
+        in_domain[l] = (l < n) && zeta_fast_domain(s[l], a[l]);
+        const std::complex<double> sl = in_domain[l] ? s[l] : 2.;
+        s_re[l] = sl.real();
+        s_im[l] = sl.imag();
+        x0[l] = in_domain[l] ? a[l].real() : 1.;
+        const double s1 = std::abs(s_re[l]) + std::abs(s_im[l]);
+        err_a[l] = s1 * (LOG_ERR_REL + 1);
+        err_b[l] = s1 * (LOG_ERR_ABS + 1.01) + EXP_ERR + SINCOS_ERR + 1;
+        n_terms = std::max(n_terms, 10 + std::ceil(std::abs(sl)));
+    }
+    const int N = int(n_terms);
+
+    // the power sum. a+k is off by u (a+k), its log by u (LOG_ERR_REL |log| + LOG_ERR_ABS + 1.01),
+    // so the arguments of exp and sincos are off by |s| times that plus u |s log|. The components
+    // of a term m (cos, sin) are then off by at most m u (err_a |log| + err_b), and the summation
+    // adds N u times the sum of the 1-norms. Terms outside the range of exp_lane reject the lane
+    // (exp_lane returns garbage for them).
+    double sum_re[L], sum_im[L], mod[L], round[L], range[L];
+    for (std::size_t l = 0; l < L; l++) {
+        sum_re[l] = 0; sum_im[l] = 0; mod[l] = 0; round[l] = 0; range[l] = 0;
+    }
+    for (int k = 0; k < N; k++) {
+        for (std::size_t l = 0; l < L; l++) {
+            const double lx = log_lane(x0[l] + k);
+            const double e = -s_re[l] * lx;
+            // positive if e is outside [EXP_MIN, EXP_MAX]
+            range[l] = std::max(range[l], std::abs(e - (EXP_MAX + EXP_MIN) / 2) - (EXP_MAX - EXP_MIN) / 2);
+            const double m = exp_lane(e);
+            double sn, cs;
+            sincos_lane(-s_im[l] * lx, sn, cs);
+            sum_re[l] += m * cs;
+            sum_im[l] += m * sn;
+            mod[l] += m;
+            round[l] += m * (err_a[l] * std::abs(lx) + err_b[l]);
+        }
+    }
+
+    // the tail w [ x/(s-1) + 1/2 + u sum_j c_j (u^2)^(j-1) ] with x = a+N, w = x^-s, u = 1/x
+    // and c_j = B_2j/(2j)! s (s+1) ... (s+2j-2), and the remainder bound
+    for (std::size_t l = 0; l < n; l++) {
+        const Ball sl = ball(s_re[l], s_im[l]);
+        const Ball x = ball(x0[l] + N, 0, U * (x0[l] + N));
+        const Ball lx = log_real(x);
+        const Ball u = inv_real(x);
+        const Ball u2 = u * u;
+
+        Ball poch = sl;                                 // (s)_(2j-1)
+        Ball poly = ball(0);
+        Ball uj = u;                                    // u^(2j-1)
+        for (int j = 1; j <= ZETA_M; j++) {
+            if (j > 1) {
+                poch = poch * (sl + ball(2*j - 3)) * (sl + ball(2*j - 2));
+                uj = uj * u2;
+            }
+            const double b = BERNOULLI_FAC[j-1];
+            poly = poly + ball(b, 0, U * std::abs(b)) * uj * poch;
+        }
+        poch = poch * (sl + ball(2*ZETA_M - 1));       // (s)_2M
+
+        Ball w = ball(0);
+        const bool w_ok = exp_ball(-sl * lx, w);
+        const Ball tail = w * (x * inv(sl + ball(-1)) + ball(0.5) + poly);
+
+        // the remainder bound, rounded up (its exponent is below -2.3)
+        const double e = -(s_re[l] + 2*ZETA_M - 1) * (lx.re - lx.rad);
+        const double trunc = 4 * (norm1(poch) + poch.rad) * INV_TWO_PI_2M *
+                             exp_lane(std::max(e, EXP_MIN)) / (s_re[l] + 2*ZETA_M - 1) * (1 + 1e-10);
+
+        const Ball z = ball(sum_re[l], sum_im[l], U * (2 * round[l] + 2 * N * mod[l])) + tail;
+        const double err = trunc + SAFETY * z.rad;
+        res[l] = std::complex<double>(z.re, z.im);
+        ok[l] = in_domain[l] && w_ok && (range[l] <= 0) && std::isfinite(z.re) && std::isfinite(z.im) &&
+                (err <= target * (abs_lower(z) - err));
+    }
+}
+
+void detail::gamma_inc_fast(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                            slong err_bits_ref, std::complex<double> * res, bool * ok)
+{
+    const std::size_t L = FAST_LANES;
+    const double target = std::ldexp(1., int(err_bits_ref));
+    const double stop2 = (target / 8) * (target / 8);
+    double s_re[L], s_im[L], w_re[L], w_im[L], arg[L], growth2[L];
+    bool in_domain[L];
+    for (std::size_t l = 0; l < L; l++) {
+        in_domain[l] = (l < n) && gamma_inc_fast_domain(s[l], z[l]);
+        const std::complex<double> sl = in_domain[l] ? s[l] : 1.;
+        const std::complex<double> zl = in_domain[l] ? z[l] : 1.;
+        s_re[l] = sl.real();
+        s_im[l] = sl.imag();
+        // 1/z with a relative error of at most 3.01 u
+        const double q = zl.real() * zl.real() + zl.imag() * zl.imag();
+        w_re[l] = zl.real() / q;
+        w_im[l] = -zl.imag() / q;
+        // the remainder relative to |z^(s-1) e^-z| carries e^(|Im(s) arg(z)| + Im(s) arg(z))
+        arg[l] = atan_lane(zl.imag() / zl.real());
+        const double t = s_im[l] * arg[l];
+        growth2[l] = (std::abs(t) + t <= EXP_MAX / 2) ? exp_lane(2 * (std::abs(t) + t)) : INF;
+    }
+
+    // t_k = (s-1)...(s-k) z^-k, summed until the remainder bound |t_n| growth
+    // meets the tolerance (with room for the rounding errors) or the terms grow
+    double t_re[L], t_im[L], t_prev2[L], sum_re[L], sum_im[L], sum_abs[L], bound2[L], n_terms[L], active[L];
+    for (std::size_t l = 0; l < L; l++) {
+        t_re[l] = 1; t_im[l] = 0; t_prev2[l] = INF;
+        sum_re[l] = 0; sum_im[l] = 0; sum_abs[l] = 0;
+        bound2[l] = INF; n_terms[l] = 0; active[l] = 1;
+    }
+    for (int k = 0; k < GAMMA_INC_MAX_TERMS; k++) {
+        double n_active = 0;
+        for (std::size_t l = 0; l < L; l++) {
+            // the squared bound of the remainder after the k terms summed so far
+            const double sum_mod2 = sum_re[l]*sum_re[l] + sum_im[l]*sum_im[l];
+            const double t_abs2 = t_re[l]*t_re[l] + t_im[l]*t_im[l];
+            const bool valid = (k >= s_re[l] - 1);
+            const bool stop = valid & ((t_abs2 * growth2[l] <= stop2 * sum_mod2) | (k == GAMMA_INC_MAX_TERMS - 1));
+            const bool diverge = valid & (t_abs2 > t_prev2[l]);
+            const bool fire = (active[l] != 0) & (stop | diverge);
+            bound2[l] = fire ? t_abs2 : bound2[l];
+            n_terms[l] = fire ? k : n_terms[l];
+            active[l] = fire ? 0 : active[l];
+            sum_re[l] += active[l] * t_re[l];
+            sum_im[l] += active[l] * t_im[l];
+            sum_abs[l] += active[l] * (std::abs(t_re[l]) + std::abs(t_im[l]));
+            // t_(k+1) = t_k (s-k-1) / z
+            const double f_re = s_re[l] - (k + 1);
+            const double f_im = s_im[l];
+            const double g_re = f_re * w_re[l] - f_im * w_im[l];
+            const double g_im = f_re * w_im[l] + f_im * w_re[l];
+            const double tmp = t_re[l] * g_re - t_im[l] * g_im;
+            t_im[l] = t_re[l] * g_im + t_im[l] * g_re;
+            t_re[l] = tmp;
+            t_prev2[l] = t_abs2;
+            n_active += active[l];
+        }
+        if (n_active == 0) break;
+    }
+
+    // Each step of the recurrence adds at most 12.01 u to the relative error of t_k (3.01 u
+    // from 1/z, u from s-k-1 and 4 u from each complex product), the summation n u, so the
+    // sum is off by 14 n u sum_k |t_k|. The remainder bound is off by the relative errors
+    // of t_n and of growth, both below 1e-9.
+    for (std::size_t l = 0; l < n; l++) {
+        if (!in_domain[l] || (n_terms[l] == 0)) {
+            ok[l] = false;
+            continue;
+        }
+        const double x = z[l].real();
+        const double y = z[l].imag();
+        const double bound = std::sqrt(bound2[l] * growth2[l]) * (1 + 1e-6);
+        const Ball sum = ball(sum_re[l], sum_im[l], 14 * n_terms[l] * U * sum_abs[l] + bound);
+
+        // the prefactor z^(s-1) e^-z = exp((s-1) log(z) - z) with log(z) = log(|z|^2)/2 + i arg(z)
+        const double lq = log_lane(x * x + y * y);
+        const Ball log_z = ball(lq / 2, arg[l], U * (1.01 + (LOG_ERR_REL * std::abs(lq) + LOG_ERR_ABS) / 2 +
+                                                     0.51 + ATAN_ERR));
+        Ball pre = ball(0);
+        const bool pre_ok = exp_ball((ball(s[l].real(), s[l].imag()) + ball(-1)) * log_z + ball(-x, -y), pre);
+
+        const Ball r = pre * sum;
+        const double err = SAFETY * r.rad;
+        res[l] = std::complex<double>(r.re, r.im);
+        ok[l] = pre_ok && std::isfinite(r.re) && std::isfinite(r.im) && (err <= target * (abs_lower(r) - err));
+    }
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,389 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "acb_dirichlet.h"
+#include "arb.h"
+#include "arf.h"
+#include "mag.h"
+#include "acb_poly.h"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     Hurwitz zeta function for fixed s
+// ##
+// ##     zeta(s, a) = sum_{k=0}^{N-1} (a+k)^-s + (a+N)^(1-s) / (s-1) + (a+N)^-s / 2
+// ##                + sum_{j=1}^{M} c_j (a+N)^(-s-2j+1) + R
+// ##     with c_j = B_2j / (2j)! * s (s+1) ... (s+2j-2)
+// ##     For real 0 < a <= GRID_MAX_A (with n_eval > 0) a = a0 + n, 0 < a0 <= 1,
+// ##     and zeta(s, a) = zeta(s, a0) - sum_{k=0}^{n-1} (a0+k)^-s, where zeta(s, a0)
+// ##     comes from the grid of Taylor polynomials of acb_dirichlet_hurwitz_precomp
+// ##     (a0 is a double, i.e. the dyadic rational p / 2^k arb evaluates it at).
+// ##################################################
+
+namespace {
+
+// the s dependent data at one precision, owned by HurwitzZeta::Impl
+// (copied shallowly when the vector grows, cleared in its destructor)
+struct Coefficients {
+    slong prec;
+    slong len;
+    acb_ptr c;          // c_1 ... c_len
+    acb_t inv_sm1;      // 1 / (s - 1)
+};
+
+// the grid of acb_dirichlet_hurwitz_precomp at one precision (heap allocated,
+// so that the vector may move it)
+struct Grid {
+    slong prec;
+    acb_dirichlet_hurwitz_precomp_struct * pre;
+};
+
+// the real a for which the grid is used, larger a need few terms anyway
+const double GRID_MAX_A = 16;
+
+// a0 = p / q with q = 2^k < 2^FLINT_BITS, false if q does not fit
+bool dyadic(double a0, ulong & p, ulong & q)
+{
+    int e;
+    const double f = std::frexp(a0, &e);            // a0 = f 2^e, 1/2 <= f < 1
+    std::uint64_t m = std::uint64_t(std::ldexp(f, 53));
+    int k = 53 - e;
+    while ((k > 0) && ((m & 1) == 0)) {
+        m >>= 1;
+        k--;
+    }
+    if (k >= FLINT_BITS) return false;
+    p = m;
+    q = ulong(1) << k;
+    return true;
+}
+
+}
+
+struct HurwitzZeta::Impl {
+    Impl(std::complex<double> s, const Settings & settings, std::size_t n_eval);
+    ~Impl();
+
+    const Coefficients & coefficients(slong M, slong prec);
+    const Grid & grid(slong prec);
+    void eval(acb_t res, const acb_t a, slong prec);
+    // zeta(s, a0 + shift) from the grid, a0 = p / q
+    void eval_grid(acb_t res, double a0, ulong p, ulong q, unsigned int shift, slong prec);
+    int eval(std::complex<double> a, std::complex<double> * res);
+
+    std::complex<double> s_d;
+    detail::Config cfg;
+    std::size_t n_eval;                 // 0: no grid
+    bool pole;                          // s = 1
+    acb_t s, ms, a, res, t, u, u2, w, x;
+    mag_t bound;
+    std::vector<Coefficients> coeffs;
+    std::vector<Grid> grids;
+};
+
+HurwitzZeta::Impl::Impl(std::complex<double> s_d, const Settings & settings, std::size_t n_eval)
+    : s_d(s_d), cfg(settings, ZETA_DEFAULT_INIT_PREC), n_eval(n_eval),
+      pole((s_d.real() == 1) && (s_d.imag() == 0))
+{
+    acb_init(s); acb_init(ms); acb_init(a); acb_init(res);
+    acb_init(t); acb_init(u); acb_init(u2); acb_init(w); acb_init(x);
+    mag_init(bound);
+    acb_set_d_d(s, s_d.real(), s_d.imag());
+    acb_neg(ms, s);
+}
+
+HurwitzZeta::Impl::~Impl()
+{
+    for (std::size_t i = 0; i < coeffs.size(); i++) {
+        _acb_vec_clear(coeffs[i].c, coeffs[i].len);
+        acb_clear(coeffs[i].inv_sm1);
+    }
+    for (std::size_t i = 0; i < grids.size(); i++) {
+        acb_dirichlet_hurwitz_precomp_clear(grids[i].pre);
+        delete grids[i].pre;
+    }
+    acb_clear(s); acb_clear(ms); acb_clear(a); acb_clear(res);
+    acb_clear(t); acb_clear(u); acb_clear(u2); acb_clear(w); acb_clear(x);
+    mag_clear(bound);
+}
+
+const Coefficients & HurwitzZeta::Impl::coefficients(slong M, slong prec)
+{
+    std::size_t i = 0;
+    while ((i < coeffs.size()) && (coeffs[i].prec != prec)) i++;
+    if (i == coeffs.size()) {
+        Coefficients co;
+        co.prec = prec;
+        co.len = 0;
+        co.c = NULL;
+        acb_init(co.inv_sm1);
+        acb_sub_ui(co.inv_sm1, s, 1, prec);
+        acb_inv(co.inv_sm1, co.inv_sm1, prec);
+        coeffs.push_back(co);
+    }
+    Coefficients & co = coeffs[i];
+    if (co.len >= M) return co;
+
+    // (re)compute c_1 ... c_len, grow geometrically to amortize
+    slong len = (M > 2*co.len) ? M : 2*co.len;
+    if (co.c != NULL) _acb_vec_clear(co.c, co.len);
+    co.c = _acb_vec_init(len);
+    co.len = len;
+
+    arb_t b, f;
+    acb_t r, v;
+    arb_init(b); arb_init(f);
+    acb_init(r); acb_init(v);
+    acb_set(r, s);                                  // r = s (s+1) ... (s+2j-2)
+    for (slong j = 1; j <= len; j++) {
+        if (j > 1) {
+            acb_add_ui(v, s, 2*j - 3, prec);
+            acb_mul(r, r, v, prec);
+            acb_add_ui(v, s, 2*j - 2, prec);
+            acb_mul(r, r, v, prec);
+        }
+        arb_bernoulli_ui(b, 2*j, prec);
+        arb_fac_ui(f, 2*j, prec);
+        arb_div(b, b, f, prec);
+        acb_mul_arb(co.c + j - 1, r, b, prec);
+    }
+    arb_clear(b); arb_clear(f);
+    acb_clear(r); acb_clear(v);
+    return co;
+}
+
+const Grid & HurwitzZeta::Impl::grid(slong prec)
+{
+    std::size_t i = 0;
+    while ((i < grids.size()) && (grids[i].prec != prec)) i++;
+    if (i == grids.size()) {
+        Grid g;
+        g.prec = prec;
+        g.pre = new acb_dirichlet_hurwitz_precomp_struct;
+        // the grid parameters are chosen by arb for n_eval evaluations
+        acb_dirichlet_hurwitz_precomp_init_num(g.pre, s, 0, double(n_eval), prec);
+        grids.push_back(g);
+    }
+    return grids[i];
+}
+
+void HurwitzZeta::Impl::eval_grid(acb_t res, double a0, ulong p, ulong q, unsigned int shift, slong prec)
+{
+    acb_dirichlet_hurwitz_precomp_eval(res, grid(prec).pre, p, q, prec);
+    acb_set_d(t, a0);
+    for (unsigned int k = 0; k < shift; k++) {
+        acb_add_ui(u, t, k, prec);
+        acb_pow(u, u, ms, prec);
+        acb_sub(res, res, u, prec);
+    }
+}
+
+void HurwitzZeta::Impl::eval(acb_t res, const acb_t a, slong prec)
+{
+    if (pole || !acb_is_finite(a)) {
+        acb_hurwitz_zeta(res, s, a, prec);
+        return;
+    }
+
+    ulong N, M;
+    _acb_poly_zeta_em_choose_param(bound, &N, &M, s, a, 1, prec, MAG_BITS);
+    _acb_poly_zeta_em_bound1(bound, s, a, N, M, 1, MAG_BITS);
+    const Coefficients & co = coefficients(M, prec);
+
+    // power sum
+    acb_zero(res);
+    for (ulong k = 0; k < N; k++) {
+        acb_add_ui(t, a, k, prec);
+        acb_pow(t, t, ms, prec);
+        acb_add(res, res, t, prec);
+    }
+
+    // tail: w = (a+N)^-s, u = 1 / (a+N)
+    acb_add_ui(t, a, N, prec);
+    acb_pow(w, t, ms, prec);
+    acb_inv(u, t, prec);
+    acb_mul(u2, u, u, prec);
+
+    acb_zero(x);
+    for (slong j = M; j >= 1; j--) {
+        acb_mul(x, x, u2, prec);
+        acb_add(x, x, co.c + j - 1, prec);
+    }
+    acb_mul(x, x, u, prec);                         // sum_j c_j u^(2j-1)
+
+    acb_mul(t, t, co.inv_sm1, prec);                // (a+N) / (s-1)
+    acb_add(x, x, t, prec);
+    acb_one(t);
+    acb_mul_2exp_si(t, t, -1);
+    acb_add(x, x, t, prec);                         // + 1/2
+    acb_mul(x, x, w, prec);
+
+    acb_add(res, res, x, prec);
+    acb_add_error_mag(res, bound);
+}
+
+int HurwitzZeta::Impl::eval(std::complex<double> a_d, std::complex<double> * res_d)
+{
+    using namespace detail;
+    FunctionStats & stats = thread_stats().fn[STATS_ZETA];
+    stats.add(FunctionStats::CALLS);
+    acb_set_d_d(a, a_d.real(), a_d.imag());
+
+    // the grid for real 0 < a <= GRID_MAX_A
+    ulong p = 0, q = 1;
+    double a0 = 0;
+    unsigned int shift = 0;
+    bool use_grid = false;
+    if ((n_eval > 0) && !pole && (a_d.imag() == 0) && (a_d.real() > 0) && (a_d.real() <= GRID_MAX_A)) {
+        shift = (unsigned int) std::ceil(a_d.real()) - 1;
+        a0 = a_d.real() - shift;                    // exact, 0 < a0 <= 1
+        use_grid = dyadic(a0, p, q);
+    }
+
+    unsigned int prec = cfg.start_prec(a_d);
+    unsigned int c = 1;
+    slong err_bits;
+    const std::complex<double> args[2] = {s_d, a_d};
+
+    while (1) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (use_grid) {
+            eval_grid(res, a0, p, q, shift, prec);
+        } else {
+            eval(res, a, prec);
+        }
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+
+        err_bits = acb_rel_error_bits(res);
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, "zeta", args, 2, prec, err_bits, c);
+
+        const int accepted = cfg.accept(res, err_bits);
+        if (accepted >= 0) {
+            *res_d = std::complex<double>(arf_get_d(arb_midref(acb_realref(res)), ARF_RND_NEAR),
+                                          arf_get_d(arb_midref(acb_imagref(res)), ARF_RND_NEAR));
+            if (accepted == 0) cfg.record(a_d, prec);
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return accepted;
+        }
+        if (c >= cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c, false);
+            cfg.emit(TRACE_LIMIT, "zeta", args, 2, prec, err_bits, c);
+            return -1;
+        }
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            *res_d = std::complex<double>(arf_get_d(arb_midref(acb_realref(res)), ARF_RND_NEAR),
+                                          arf_get_d(arb_midref(acb_imagref(res)), ARF_RND_NEAR));
+            cfg.count(c, false);
+            cfg.emit(TRACE_STOPPED, "zeta", args, 2, prec, err_bits, c);
+            return STOPPED;
+        }
+        stats.add(FunctionStats::ESCALATIONS);
+        prec = next_prec;
+        c += 1;
+    }
+}
+
+HurwitzZeta::HurwitzZeta(std::complex<double> s, const Settings & settings, std::size_t n_eval)
+    : impl(new Impl(s, settings, n_eval))
+{}
+
+HurwitzZeta::HurwitzZeta(std::complex<double> s, double tol, unsigned int limit, bool verbose,
+                         unsigned int init_prec)
+    : impl(new Impl(s, Settings(tol, limit, verbose, init_prec), 0))
+{}
+
+HurwitzZeta::~HurwitzZeta()
+{
+    delete impl;
+}
+
+std::complex<double> HurwitzZeta::s() const
+{
+    return impl->s_d;
+}
+
+int HurwitzZeta::operator()(std::complex<double> a, std::complex<double> * res)
+{
+    return impl->eval(a, res);
+}
+
+std::complex<double> HurwitzZeta::operator()(std::complex<double> a)
+{
+    std::complex<double> res;
+    int status = impl->eval(a, &res);
+    if (status < 0) {
+        std::ostringstream oss;
+        if (status == STOPPED) {
+            oss << "STOPPED: HurwitzZeta s=" << impl->s_d << " and a=" << a << " (deadline or cancellation)";
+        } else {
+            oss << "LIMIT ERROR: HurwitzZeta s=" << impl->s_d << " and a=" << a;
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+std::size_t HurwitzZeta::batch(std::size_t n, const std::complex<double> * a, std::ptrdiff_t a_stride,
+                               std::complex<double> * res, std::ptrdiff_t res_stride,
+                               int * status, std::ptrdiff_t status_stride) noexcept
+{
+    std::size_t n_fail = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (detail::stop_point(impl->cfg, res, res_stride, status, status_stride, i)) {
+            n_fail++;
+            continue;
+        }
+        int st = impl->eval(detail::at(a, a_stride, i), &detail::at(res, res_stride, i));
+        detail::set_status(res, res_stride, status, status_stride, i, st);
+        if (st < 0) n_fail++;
+    }
+    return n_fail;
+}
+
+std::size_t HurwitzZeta::batch(std::size_t n, const std::complex<double> * a, std::complex<double> * res,
+                               int * status) noexcept
+{
+    return batch(n, a, sizeof(std::complex<double>), res, sizeof(std::complex<double>), status, sizeof(int));
+}
+
+} /* namespace cplxfnc */
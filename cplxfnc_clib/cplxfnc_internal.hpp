@@ -0,0 +1,313 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+/*
+ *  internal declarations shared between the translation units of the library,
+ *  not part of the installed interface
+ */
+
+#ifndef CPLXFNC_INTERNAL_H
+#define CPLXFNC_INTERNAL_H
+
+#include "cplxfnc.hpp"
+
+#include "acb.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace cplxfnc {
+namespace detail {
+
+// settings of the precision escalation loop, derived once from the
+// arguments of the public functions
+struct Config {
+    Config(double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+           PrecisionPredictor * predictor=NULL, EscalationPolicy * policy=NULL,
+           ResultCache * cache=NULL, FastPath * fast=NULL, StopToken * stop=NULL, double atol=0);
+    // init_prec=0 in settings selects default_init_prec
+    Config(const Settings & settings, unsigned int default_init_prec);
+
+    // the precision of the first attempt for the main argument x
+    unsigned int start_prec(std::complex<double> x) const;
+    // the evaluation for the main argument x succeeded at precision prec
+    void record(std::complex<double> x, unsigned int prec) const;
+    // the precision of the attempt after an attempt at prec gave err_bits
+    unsigned int next_prec(unsigned int prec, slong err_bits) const;
+    // 0 if the ball x with relative error err_bits meets tol, ATOL_MET if only
+    // its radius meets atol, -1 otherwise
+    int accept(const acb_t x, slong err_bits) const;
+    int accept(const arb_t x, slong err_bits) const;
+    // stop before an attempt at next_prec, the last one at prec took last_ns
+    bool stop_requested(unsigned int prec, unsigned int next_prec, std::uint64_t last_ns) const;
+    // statistics of the policy, once per evaluation
+    void count(unsigned int attempts, bool success) const;
+    // push an event to the trace sink (if any), never blocks
+    void emit(int kind, const char * function, const std::complex<double> * args, unsigned int n_args,
+              unsigned int prec, slong err_bits, unsigned int attempt) const;
+
+    double tol;
+    slong err_bits_ref;        // log2(tol), the required relative error in bits
+    unsigned int limit;
+    bool verbose;
+    unsigned int init_prec;
+    PrecisionPredictor * predictor;
+    EscalationPolicy * policy;
+    ResultCache * cache;
+    FastPath * fast;
+    StopToken * stop;
+    TraceSink * trace;
+    double atol;               // 0: relative tolerance only
+};
+
+// arb temporaries, kept alive over many evaluations by the batch functions,
+// prec, attempts and err_bits describe the last evaluation (0, 0 and WORD_MAX
+// if arb was not called), shortcut is true if the cache or the fast path
+// answered it
+struct ZetaWorkspace {
+    ZetaWorkspace();
+    ~ZetaWorkspace();
+    ZetaWorkspace(const ZetaWorkspace &) = delete;
+    ZetaWorkspace & operator=(const ZetaWorkspace &) = delete;
+
+    acb_t z, s, a;
+    unsigned int prec, attempts;
+    slong err_bits;
+    bool shortcut;
+};
+
+struct GammaIncWorkspace {
+    GammaIncWorkspace();
+    ~GammaIncWorkspace();
+    GammaIncWorkspace(const GammaIncWorkspace &) = delete;
+    GammaIncWorkspace & operator=(const GammaIncWorkspace &) = delete;
+
+    acb_t res, s, z;
+    unsigned int prec, attempts;
+    slong err_bits;
+    bool shortcut;
+};
+
+struct UAsympWorkspace {
+    UAsympWorkspace();
+    ~UAsympWorkspace();
+    UAsympWorkspace(const UAsympWorkspace &) = delete;
+    UAsympWorkspace & operator=(const UAsympWorkspace &) = delete;
+
+    acb_t res, a, b, z;
+    unsigned int prec, attempts;
+    slong err_bits;
+    bool shortcut;
+};
+
+// the escalation loops, return codes as for the public functions,
+// fast_tried skips the fast path (the batch loops ran it already)
+int zeta(ZetaWorkspace & ws, std::complex<double> s, std::complex<double> a,
+         std::complex<double> * res, const Config & cfg, bool fast_tried=false);
+int gamma_inc(GammaIncWorkspace & ws, std::complex<double> s, std::complex<double> z,
+              std::complex<double> * res, const Config & cfg, bool fast_tried=false);
+int u_asymp(UAsympWorkspace & ws, std::complex<double> a, std::complex<double> b, std::complex<double> z,
+            std::complex<double> * res, const Config & cfg);
+
+// the instrumentation counters of one thread (see cplxfnc_stats.cpp), the owning
+// thread is the only writer
+enum StatsFunction { STATS_ZETA = CPLXFNC_STATS_ZETA, STATS_GAMMA_INC = CPLXFNC_STATS_GAMMA_INC,
+                     STATS_U_ASYMP = CPLXFNC_STATS_U_ASYMP, N_STATS_FUNCTIONS = 3 };
+
+struct FunctionStats {
+    enum { CALLS, ARB_EVALS, ESCALATIONS, LIMIT_FAILURES, VALUE_ERRORS, ARB_NS, PREC_HIST,
+           SPECIAL = PREC_HIST + CPLXFNC_PREC_BINS, N_COUNTERS = SPECIAL + CPLXFNC_SPECIAL_KINDS };
+
+    void add(int i, std::uint64_t d=1) {
+        c[i].store(c[i].load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> c[N_COUNTERS];
+};
+
+struct alignas(64) ThreadStats {
+    ThreadStats();
+    ~ThreadStats();
+    ThreadStats(const ThreadStats &) = delete;
+    ThreadStats & operator=(const ThreadStats &) = delete;
+
+    FunctionStats fn[N_STATS_FUNCTIONS];
+};
+
+// the counters of the calling thread
+ThreadStats & thread_stats();
+unsigned int prec_bin(unsigned int prec);
+
+inline std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// the double precision kernels of the fast path for n <= FAST_LANES points,
+// ok[i] tells whether the error bound of res[i] meets 2^err_bits_ref
+const std::size_t FAST_LANES = 8;
+
+void zeta_fast(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+               slong err_bits_ref, std::complex<double> * res, bool * ok);
+void gamma_inc_fast(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                    slong err_bits_ref, std::complex<double> * res, bool * ok);
+
+// the closed forms of cplxfnc_special.cpp: the kind (CPLXFNC_SPECIAL_*) that
+// applies to the arguments or SPECIAL_NONE, and its evaluation at prec
+const int SPECIAL_NONE = -1;
+
+int zeta_special(std::complex<double> s, std::complex<double> a);
+void zeta_special_eval(acb_t res, int kind, std::complex<double> s, const acb_t s_b,
+                       std::complex<double> a, slong prec);
+int gamma_inc_special(std::complex<double> s, std::complex<double> z);
+void gamma_inc_special_eval(acb_t res, int kind, std::complex<double> s, const acb_t s_b,
+                            const acb_t z_b, slong prec);
+
+// element i of a strided array, the stride is given in bytes
+template <typename T>
+inline T & at(T * p, std::ptrdiff_t stride, std::size_t i)
+{
+    typedef typename std::conditional<std::is_const<T>::value, const char, char>::type byte;
+    return *reinterpret_cast<T *>(reinterpret_cast<byte *>(p) + std::ptrdiff_t(i) * stride);
+}
+
+// store the return code of point i, a failed point (negative code) gets NaN as result (a
+// stopped one keeps the estimate)
+inline void set_status(std::complex<double> * res, std::ptrdiff_t res_stride,
+                       int * status, std::ptrdiff_t status_stride, std::size_t i, int value)
+{
+    if ((value < 0) && (value != STOPPED)) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        at(res, res_stride, i) = std::complex<double>(nan, nan);
+    }
+    if (status != NULL) {
+        at(status, status_stride, i) = value;
+    }
+}
+
+// the relative error bound of the last evaluation: tol if the cache or the
+// fast path answered it, else 2^err_bits of the last arb attempt, infinity if
+// there was none or its midpoint is zero (acb_rel_error_bits gives WORD_MAX),
+// 0 for an exact ball (-WORD_MAX)
+inline double rel_error(bool shortcut, slong err_bits, double tol)
+{
+    if (shortcut) return tol;
+    if (err_bits == WORD_MAX) return std::numeric_limits<double>::infinity();
+    return std::ldexp(1., int(std::max<slong>(std::min<slong>(err_bits, 4096), -4096)));
+}
+
+// the same for a result with return code value, infinity if it failed
+inline double rel_error(int value, bool shortcut, slong err_bits, double tol)
+{
+    if ((value < 0) && (value != STOPPED)) return std::numeric_limits<double>::infinity();
+    return rel_error(shortcut, err_bits, tol);
+}
+
+// store the relative error bound of point i, rel_err may be NULL
+inline void set_rel_error(double * rel_err, std::ptrdiff_t rel_err_stride, std::size_t i,
+                          int value, bool shortcut, slong err_bits, double tol)
+{
+    if (rel_err != NULL) {
+        at(rel_err, rel_err_stride, i) = rel_error(value, shortcut, err_bits, tol);
+    }
+}
+
+// true if the stop token of cfg requests the stop before point i is started,
+// the point then gets -3, NaN and an infinite error bound
+inline bool stop_point(const Config & cfg, std::complex<double> * res, std::ptrdiff_t res_stride,
+                       int * status, std::ptrdiff_t status_stride, std::size_t i,
+                       double * rel_err=NULL, std::ptrdiff_t rel_err_stride=0)
+{
+    if ((cfg.stop == NULL) || !cfg.stop->stop_requested()) return false;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    at(res, res_stride, i) = std::complex<double>(nan, nan);
+    if (status != NULL) {
+        at(status, status_stride, i) = STOPPED;
+    }
+    if (rel_err != NULL) {
+        at(rel_err, rel_err_stride, i) = std::numeric_limits<double>::infinity();
+    }
+    return true;
+}
+
+// the batch loops over the points [begin, end), strides in bytes as for the
+// public batch functions, rel_err (may be NULL) gets the error bound of each
+// point, return the number of failed points
+std::size_t zeta_batch(ZetaWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err=NULL, std::ptrdiff_t rel_err_stride=0);
+std::size_t gamma_inc_batch(GammaIncWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+        const std::complex<double> * s, std::ptrdiff_t s_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err=NULL, std::ptrdiff_t rel_err_stride=0);
+std::size_t u_asymp_batch(UAsympWorkspace & ws, const Config & cfg, std::size_t begin, std::size_t end,
+        const std::complex<double> * a, std::ptrdiff_t a_stride,
+        const std::complex<double> * b, std::ptrdiff_t b_stride,
+        const std::complex<double> * z, std::ptrdiff_t z_stride,
+        std::complex<double> * res, std::ptrdiff_t res_stride,
+        int * status, std::ptrdiff_t status_stride,
+        double * rel_err=NULL, std::ptrdiff_t rel_err_stride=0);
+
+} /* namespace detail */
+
+// the state of the persistent evaluators
+struct ZetaEvaluator::Impl {
+    explicit Impl(const Settings & settings) : settings(settings), cfg(settings, ZETA_DEFAULT_INIT_PREC) {}
+
+    Settings settings;
+    detail::Config cfg;
+    detail::ZetaWorkspace ws;
+};
+
+struct GammaIncEvaluator::Impl {
+    explicit Impl(const Settings & settings) : settings(settings), cfg(settings, GAMMA_INC_DEFAULT_INIT_PREC) {}
+
+    Settings settings;
+    detail::Config cfg;
+    detail::GammaIncWorkspace ws;
+};
+
+struct UAsympEvaluator::Impl {
+    explicit Impl(const Settings & settings) : settings(settings), cfg(settings, U_ASYMP_DEFAULT_INIT_PREC) {}
+
+    Settings settings;
+    detail::Config cfg;
+    detail::UAsympWorkspace ws;
+};
+
+} /* namespace cplxfnc */
+
+#endif
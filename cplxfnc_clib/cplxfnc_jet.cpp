@@ -0,0 +1,337 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "arb.h"
+#include "arf.h"
+#include "acb_poly.h"
+#include "acb_hypgeom.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     derivatives
+// ##
+// ##     jet runs the precision escalation for the Taylor coefficients c_k
+// ##     (k = 0 ... n) computed by series(c, prec), the result is k! c_k.
+// ##################################################
+
+namespace {
+
+// cap of the extra starting precision of gamma_inc_jet_s (|z| up to about 45000)
+const unsigned int GAMMA_INC_JET_MAX_EXTRA_PREC = 1 << 16;
+
+// arb temporaries of one jet evaluation
+struct JetWorkspace {
+    explicit JetWorkspace(unsigned int n) : n(n) {
+        c = _acb_vec_init(n + 1);
+        acb_init(x); acb_init(y); acb_init(t); acb_init(r);
+        arb_init(fac);
+        acb_poly_init(p); acb_poly_init(q); acb_poly_init(out);
+    }
+    ~JetWorkspace() {
+        _acb_vec_clear(c, n + 1);
+        acb_clear(x); acb_clear(y); acb_clear(t); acb_clear(r);
+        arb_clear(fac);
+        acb_poly_clear(p); acb_poly_clear(q); acb_poly_clear(out);
+    }
+
+    // the n+1 coefficients of out
+    void get_coeffs() {
+        for (unsigned int k = 0; k <= n; k++) acb_poly_get_coeff_acb(c + k, out, k);
+    }
+
+    // the error bits of the coefficients relative to the largest one, so a
+    // vanishing c_k does not need a small relative error, abs_err is the
+    // largest absolute error bound of k! c_k
+    slong err_bits(double * abs_err) {
+        mag_t r, rad, m, scale;
+        mag_init(r); mag_init(rad); mag_init(m); mag_init(scale);
+        double fac_k = 1;
+        *abs_err = 0;
+        for (unsigned int k = 0; k <= n; k++) {
+            if (k > 0) fac_k *= k;
+            mag_hypot(r, arb_radref(acb_realref(c + k)), arb_radref(acb_imagref(c + k)));
+            mag_max(rad, rad, r);
+            const double e = fac_k*mag_get_d(r);
+            if (!(e <= *abs_err)) *abs_err = e;         // nan propagates
+            acb_get_mag_lower(m, c + k);
+            mag_max(scale, scale, m);
+        }
+        slong bits;
+        if (mag_is_zero(rad)) {
+            bits = -ARF_PREC_EXACT;
+        } else if (mag_is_zero(scale)) {
+            bits = ARF_PREC_EXACT;
+        } else {
+            mag_div(r, rad, scale);
+            bits = slong(std::ceil(mag_get_d_log2_approx(r)));
+        }
+        mag_clear(r); mag_clear(rad); mag_clear(m); mag_clear(scale);
+        return bits;
+    }
+
+    // res[k] = k! c_k rounded to double
+    void get_derivatives(std::complex<double> * res, unsigned int prec) {
+        for (unsigned int k = 0; k <= n; k++) {
+            arb_fac_ui(fac, k, prec);
+            acb_mul_arb(c + k, c + k, fac, prec);
+            res[k] = std::complex<double>(arf_get_d(arb_midref(acb_realref(c + k)), ARF_RND_NEAR),
+                                          arf_get_d(arb_midref(acb_imagref(c + k)), ARF_RND_NEAR));
+        }
+    }
+
+    unsigned int n;
+    acb_ptr c;
+    acb_t x, y, t, r;
+    arb_t fac;
+    acb_poly_t p, q, out;
+};
+
+// prec is the precision of the first attempt
+template <class Series>
+int jet(const char * function, detail::StatsFunction f, const std::complex<double> * args, JetWorkspace & ws,
+        std::complex<double> * res, const detail::Config & cfg, unsigned int prec, Series series)
+{
+    using namespace detail;
+    FunctionStats & stats = thread_stats().fn[f];
+
+    unsigned int c = 1;
+    slong err_bits;
+    double abs_err;
+
+    while (1) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        series(ws, prec);
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+
+        err_bits = ws.err_bits(&abs_err);
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, function, args, 2, prec, err_bits, c);
+
+        if ((err_bits <= cfg.err_bits_ref) || ((cfg.atol > 0) && (abs_err <= cfg.atol))) {
+            ws.get_derivatives(res, prec);
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return (err_bits <= cfg.err_bits_ref) ? 0 : ATOL_MET;
+        }
+        if (c >= cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c, false);
+            cfg.emit(TRACE_LIMIT, function, args, 2, prec, err_bits, c);
+            return -1;
+        }
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            ws.get_derivatives(res, prec);
+            cfg.count(c, false);
+            cfg.emit(TRACE_STOPPED, function, args, 2, prec, err_bits, c);
+            return STOPPED;
+        }
+        prec = next_prec;
+        c += 1;
+        stats.add(FunctionStats::ESCALATIONS);
+    }
+}
+
+int value_error(const char * function, detail::StatsFunction f, const std::complex<double> * args,
+                const detail::Config & cfg)
+{
+    detail::thread_stats().fn[f].add(detail::FunctionStats::VALUE_ERRORS);
+    cfg.emit(TRACE_VALUE_ERROR, function, args, 2, 0, 0, 0);
+    return -2;
+}
+
+std::vector<std::complex<double> > throwing(int (*jet_fn)(std::complex<double>, std::complex<double>, unsigned int,
+                                                          std::complex<double> *, const Settings &),
+                                            const char * name, const char * arg_name,
+                                            std::complex<double> s, std::complex<double> x, unsigned int n,
+                                            const Settings & settings)
+{
+    std::vector<std::complex<double> > res(n + 1);
+    int status = jet_fn(s, x, n, res.data(), settings);
+    if (status < 0) {
+        std::ostringstream oss;
+        if (status == -1) {
+            oss << "LIMIT ERROR: " << name << " s=" << s << " and " << arg_name << "=" << x;
+        } else if (status == -2) {
+            oss << "VALUE ERROR: " << name << " s=" << s << " and " << arg_name << "=" << x;
+        } else if (status == STOPPED) {
+            oss << "STOPPED: " << name << " s=" << s << " and " << arg_name << "=" << x << " (deadline or cancellation)";
+        } else {
+            oss << name << " unknown error: error code: " << status;
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+}
+
+int zeta_jet_s(std::complex<double> s, std::complex<double> a, unsigned int n, std::complex<double> * res,
+               const Settings & settings)
+{
+    const detail::Config cfg(settings, ZETA_DEFAULT_INIT_PREC);
+    const std::complex<double> args[2] = {s, a};
+    detail::thread_stats().fn[detail::STATS_ZETA].add(detail::FunctionStats::CALLS);
+    JetWorkspace ws(n);
+    // zeta(s + x, a)
+    acb_set_d_d(ws.x, s.real(), s.imag());
+    acb_set_d_d(ws.y, a.real(), a.imag());
+    acb_poly_set_coeff_acb(ws.p, 0, ws.x);
+    acb_poly_set_coeff_si(ws.p, 1, 1);
+    return jet("zeta", detail::STATS_ZETA, args, ws, res, cfg, cfg.init_prec, [](JetWorkspace & w, slong prec) {
+        acb_poly_zeta_series(w.out, w.p, w.y, 0, w.n + 1, prec);
+        w.get_coeffs();
+    });
+}
+
+int zeta_jet_a(std::complex<double> s, std::complex<double> a, unsigned int n, std::complex<double> * res,
+               const Settings & settings)
+{
+    const detail::Config cfg(settings, ZETA_DEFAULT_INIT_PREC);
+    const std::complex<double> args[2] = {s, a};
+    detail::thread_stats().fn[detail::STATS_ZETA].add(detail::FunctionStats::CALLS);
+    if ((s.imag() == 0) && (s.real() <= 0) && (s.real() == std::floor(s.real())) && (1 - s.real() <= n)) {
+        return value_error("zeta", detail::STATS_ZETA, args, cfg);
+    }
+    JetWorkspace ws(n);
+    acb_set_d_d(ws.x, s.real(), s.imag());
+    acb_set_d_d(ws.y, a.real(), a.imag());
+    // c_k = (-1)^k (s)_k / k! zeta(s+k, a), r = (-1)^k (s)_k / k!
+    return jet("zeta", detail::STATS_ZETA, args, ws, res, cfg, cfg.init_prec, [](JetWorkspace & w, slong prec) {
+        acb_one(w.r);
+        for (unsigned int k = 0; k <= w.n; k++) {
+            if (k > 0) {
+                acb_add_ui(w.t, w.x, k - 1, prec);
+                acb_mul(w.r, w.r, w.t, prec);
+                acb_div_ui(w.r, w.r, k, prec);
+                acb_neg(w.r, w.r);
+            }
+            acb_add_ui(w.t, w.x, k, prec);
+            acb_hurwitz_zeta(w.c + k, w.t, w.y, prec);
+            acb_mul(w.c + k, w.c + k, w.r, prec);
+        }
+    });
+}
+
+int gamma_inc_jet_s(std::complex<double> s, std::complex<double> z, unsigned int n, std::complex<double> * res,
+                    const Settings & settings)
+{
+    const detail::Config cfg(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+    const std::complex<double> args[2] = {s, z};
+    detail::thread_stats().fn[detail::STATS_GAMMA_INC].add(detail::FunctionStats::CALLS);
+    if ((s.real() < 0) && (z == 0.)) {
+        return value_error("gamma_inc", detail::STATS_GAMMA_INC, args, cfg);
+    }
+    JetWorkspace ws(n);
+    acb_set_d_d(ws.x, s.real(), s.imag());
+    acb_set_d_d(ws.y, z.real(), z.imag());
+    if (z == 0.) {
+        // Gamma(s + x)
+        acb_poly_set_coeff_acb(ws.p, 0, ws.x);
+        acb_poly_set_coeff_si(ws.p, 1, 1);
+        return jet("gamma_inc", detail::STATS_GAMMA_INC, args, ws, res, cfg, cfg.init_prec, [](JetWorkspace & w, slong prec) {
+            acb_poly_gamma_series(w.out, w.p, w.n + 1, prec);
+            w.get_coeffs();
+        });
+    }
+    // e^-z U(1-s-x, 1-s-x, z), p = 1-s-x (exact, arb removes the singularity at integer b), q = z
+    acb_sub_ui(ws.t, ws.x, 1, ARF_PREC_EXACT);
+    acb_neg(ws.t, ws.t);
+    acb_poly_set_coeff_acb(ws.p, 0, ws.t);
+    acb_poly_set_coeff_si(ws.p, 1, -1);
+    acb_poly_set_coeff_acb(ws.q, 0, ws.y);
+    // the series of U by 1F1 cancels about |z|/ln(2) bits, start with them
+    const double extra = std::min(std::abs(z)/M_LN2, double(GAMMA_INC_JET_MAX_EXTRA_PREC));
+    return jet("gamma_inc", detail::STATS_GAMMA_INC, args, ws, res, cfg, cfg.init_prec + unsigned(extra),
+               [](JetWorkspace & w, slong prec) {
+                   acb_hypgeom_u_1f1_series(w.out, w.p, w.p, w.q, w.n + 1, prec);
+                   w.get_coeffs();
+                   acb_neg(w.t, w.y);
+                   acb_exp(w.t, w.t, prec);
+                   for (unsigned int k = 0; k <= w.n; k++) acb_mul(w.c + k, w.c + k, w.t, prec);
+               });
+}
+
+int gamma_inc_jet_z(std::complex<double> s, std::complex<double> z, unsigned int n, std::complex<double> * res,
+                    const Settings & settings)
+{
+    const detail::Config cfg(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+    const std::complex<double> args[2] = {s, z};
+    detail::thread_stats().fn[detail::STATS_GAMMA_INC].add(detail::FunctionStats::CALLS);
+    if ((z == 0.) && ((n > 0) || (s.real() < 0))) {
+        return value_error("gamma_inc", detail::STATS_GAMMA_INC, args, cfg);
+    }
+    JetWorkspace ws(n);
+    // Gamma(s, z + x)
+    acb_set_d_d(ws.x, s.real(), s.imag());
+    acb_set_d_d(ws.y, z.real(), z.imag());
+    acb_poly_set_coeff_acb(ws.p, 0, ws.y);
+    acb_poly_set_coeff_si(ws.p, 1, 1);
+    return jet("gamma_inc", detail::STATS_GAMMA_INC, args, ws, res, cfg, cfg.init_prec, [](JetWorkspace & w, slong prec) {
+        acb_hypgeom_gamma_upper_series(w.out, w.x, w.p, 0, w.n + 1, prec);
+        w.get_coeffs();
+    });
+}
+
+std::vector<std::complex<double> > zeta_jet_s(std::complex<double> s, std::complex<double> a, unsigned int n,
+                                              const Settings & settings)
+{
+    return throwing(zeta_jet_s, "zeta_jet_s", "a", s, a, n, settings);
+}
+
+std::vector<std::complex<double> > zeta_jet_a(std::complex<double> s, std::complex<double> a, unsigned int n,
+                                              const Settings & settings)
+{
+    return throwing(zeta_jet_a, "zeta_jet_a", "a", s, a, n, settings);
+}
+
+std::vector<std::complex<double> > gamma_inc_jet_s(std::complex<double> s, std::complex<double> z, unsigned int n,
+                                                   const Settings & settings)
+{
+    return throwing(gamma_inc_jet_s, "gamma_inc_jet_s", "z", s, z, n, settings);
+}
+
+std::vector<std::complex<double> > gamma_inc_jet_z(std::complex<double> s, std::complex<double> z, unsigned int n,
+                                                   const Settings & settings)
+{
+    return throwing(gamma_inc_jet_z, "gamma_inc_jet_z", "z", s, z, n, settings);
+}
+
+} /* namespace cplxfnc */
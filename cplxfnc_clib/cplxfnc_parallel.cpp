@@ -0,0 +1,346 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "flint/flint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cplxfnc {
+
+namespace {
+
+// the arb state of one worker thread
+struct Worker {
+    detail::ZetaWorkspace zeta;
+    detail::GammaIncWorkspace gamma_inc;
+    detail::UAsympWorkspace u_asymp;
+};
+
+// the chunks [begin, end) of one worker, the owner takes from the front,
+// other workers steal from the back
+struct Range {
+    std::mutex m;
+    std::size_t begin;
+    std::size_t end;
+};
+
+}
+
+struct ParallelEvaluator::Impl {
+    // evaluates the points [begin, end) with the arb state of the calling worker,
+    // returns the number of failed points
+    typedef std::function<std::size_t(Worker &, std::size_t, std::size_t)> Task;
+
+    Impl(unsigned int n_threads, std::size_t chunk_size);
+    ~Impl();
+
+    std::size_t run(std::size_t n, const Task & task);
+    void work(unsigned int id);
+    bool next_chunk(unsigned int id, std::size_t & chunk);
+
+    std::size_t chunk_size;
+    std::vector<std::thread> threads;
+    std::unique_ptr<Range[]> ranges;
+
+    std::mutex submit_mutex;                // serializes concurrent calls of run
+    std::mutex m;                           // guards the members below
+    std::condition_variable cv_start;
+    std::condition_variable cv_done;
+    unsigned long generation;
+    bool shutdown;
+    unsigned int busy;
+    const Task * task;
+    std::size_t n;
+    std::atomic<std::size_t> n_fail;
+};
+
+ParallelEvaluator::Impl::Impl(unsigned int n_threads, std::size_t chunk_size)
+    : chunk_size(std::max<std::size_t>(chunk_size, 1)), ranges(new Range[n_threads]),
+      generation(0), shutdown(false), busy(0), task(NULL), n(0), n_fail(0)
+{
+    for (unsigned int i = 0; i < n_threads; i++) {
+        ranges[i].begin = ranges[i].end = 0;
+    }
+    threads.reserve(n_threads);
+    for (unsigned int i = 0; i < n_threads; i++) {
+        threads.push_back(std::thread(&Impl::work, this, i));
+    }
+}
+
+ParallelEvaluator::Impl::~Impl()
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        shutdown = true;
+    }
+    cv_start.notify_all();
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+std::size_t ParallelEvaluator::Impl::run(std::size_t n, const Task & task)
+{
+    if (n == 0) return 0;
+
+    std::lock_guard<std::mutex> submit_lock(submit_mutex);
+    const std::size_t n_threads = threads.size();
+    const std::size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+    for (std::size_t i = 0; i < n_threads; i++) {
+        std::lock_guard<std::mutex> lock(ranges[i].m);
+        ranges[i].begin = i * n_chunks / n_threads;
+        ranges[i].end = (i + 1) * n_chunks / n_threads;
+    }
+
+    std::unique_lock<std::mutex> lock(m);
+    this->task = &task;
+    this->n = n;
+    n_fail = 0;
+    busy = n_threads;
+    generation++;
+    cv_start.notify_all();
+    cv_done.wait(lock, [this]{ return busy == 0; });
+    this->task = NULL;
+    return n_fail;
+}
+
+bool ParallelEvaluator::Impl::next_chunk(unsigned int id, std::size_t & chunk)
+{
+    Range & own = ranges[id];
+    {
+        std::lock_guard<std::mutex> lock(own.m);
+        if (own.begin < own.end) {
+            chunk = own.begin++;
+            return true;
+        }
+    }
+
+    // own chunks are done, steal the upper half of the remaining chunks of another worker
+    const unsigned int n_threads = threads.size();
+    for (unsigned int k = 1; k < n_threads; k++) {
+        Range & victim = ranges[(id + k) % n_threads];
+        std::size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (victim.begin >= victim.end) continue;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        chunk = begin;
+        std::lock_guard<std::mutex> lock(own.m);
+        own.begin = begin + 1;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+void ParallelEvaluator::Impl::work(unsigned int id)
+{
+    {
+        Worker worker;
+        unsigned long seen = 0;
+        while (1) {
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv_start.wait(lock, [this, seen]{ return shutdown || (generation != seen); });
+                if (shutdown) break;
+                seen = generation;
+            }
+
+            std::size_t chunk, fails = 0;
+            while (next_chunk(id, chunk)) {
+                std::size_t begin = chunk * chunk_size;
+                fails += (*task)(worker, begin, std::min(begin + chunk_size, n));
+            }
+            n_fail += fails;
+
+            std::lock_guard<std::mutex> lock(m);
+            if (--busy == 0) cv_done.notify_all();
+        }
+    }
+    // free the thread local caches of flint and arb before the thread ends
+    flint_cleanup();
+}
+
+ParallelEvaluator::ParallelEvaluator(unsigned int n_threads, std::size_t chunk_size)
+{
+    if (n_threads == 0) {
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    impl = new Impl(n_threads, chunk_size);
+}
+
+ParallelEvaluator::~ParallelEvaluator()
+{
+    delete impl;
+}
+
+unsigned int ParallelEvaluator::num_threads() const
+{
+    return impl->threads.size();
+}
+
+// ##################################################
+// ##     Hurwitz Zeta function
+// ##################################################
+
+std::size_t ParallelEvaluator::zeta_batch(std::size_t n,
+                                          const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                          const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                          std::complex<double> * res, std::ptrdiff_t res_stride,
+                                          int * status, std::ptrdiff_t status_stride,
+                                          double * rel_err, std::ptrdiff_t rel_err_stride,
+                                          const Settings & settings) noexcept
+{
+    const detail::Config cfg(settings, ZETA_DEFAULT_INIT_PREC);
+    return impl->run(n, [&](Worker & w, std::size_t begin, std::size_t end) {
+        return detail::zeta_batch(w.zeta, cfg, begin, end, s, s_stride, a, a_stride,
+                                  res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    });
+}
+
+std::size_t ParallelEvaluator::zeta_batch(std::size_t n,
+                                          const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                          const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                          std::complex<double> * res, std::ptrdiff_t res_stride,
+                                          int * status, std::ptrdiff_t status_stride,
+                                          double tol, unsigned int limit, bool verbose,
+                                          unsigned int init_prec,
+                                          PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return zeta_batch(n, s, s_stride, a, a_stride, res, res_stride, status, status_stride, NULL, 0,
+                      Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t ParallelEvaluator::zeta_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * a,
+                                          std::complex<double> * res, int * status,
+                                          double tol, unsigned int limit, bool verbose,
+                                          unsigned int init_prec,
+                                          PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return zeta_batch(n, s, c, a, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+// ##################################################
+// ##     incomplete upper gamma function
+// ##################################################
+
+std::size_t ParallelEvaluator::gamma_inc_batch(std::size_t n,
+                                               const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                               const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                               std::complex<double> * res, std::ptrdiff_t res_stride,
+                                               int * status, std::ptrdiff_t status_stride,
+                                               double * rel_err, std::ptrdiff_t rel_err_stride,
+                                               const Settings & settings) noexcept
+{
+    const detail::Config cfg(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+    return impl->run(n, [&](Worker & w, std::size_t begin, std::size_t end) {
+        return detail::gamma_inc_batch(w.gamma_inc, cfg, begin, end, s, s_stride, z, z_stride,
+                                       res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    });
+}
+
+std::size_t ParallelEvaluator::gamma_inc_batch(std::size_t n,
+                                               const std::complex<double> * s, std::ptrdiff_t s_stride,
+                                               const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                               std::complex<double> * res, std::ptrdiff_t res_stride,
+                                               int * status, std::ptrdiff_t status_stride,
+                                               double tol, unsigned int limit, bool verbose,
+                                               unsigned int init_prec,
+                                               PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return gamma_inc_batch(n, s, s_stride, z, z_stride, res, res_stride, status, status_stride, NULL, 0,
+                           Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t ParallelEvaluator::gamma_inc_batch(std::size_t n, const std::complex<double> * s, const std::complex<double> * z,
+                                               std::complex<double> * res, int * status,
+                                               double tol, unsigned int limit, bool verbose,
+                                               unsigned int init_prec,
+                                               PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return gamma_inc_batch(n, s, c, z, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+// ##################################################
+// ##     Asymptotic series for the confluent hypergeometric function
+// ##################################################
+
+std::size_t ParallelEvaluator::u_asymp_batch(std::size_t n,
+                                             const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                             const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                             const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                             std::complex<double> * res, std::ptrdiff_t res_stride,
+                                             int * status, std::ptrdiff_t status_stride,
+                                             double * rel_err, std::ptrdiff_t rel_err_stride,
+                                             const Settings & settings) noexcept
+{
+    const detail::Config cfg(settings, U_ASYMP_DEFAULT_INIT_PREC);
+    return impl->run(n, [&](Worker & w, std::size_t begin, std::size_t end) {
+        return detail::u_asymp_batch(w.u_asymp, cfg, begin, end, a, a_stride, b, b_stride, z, z_stride,
+                                     res, res_stride, status, status_stride, rel_err, rel_err_stride);
+    });
+}
+
+std::size_t ParallelEvaluator::u_asymp_batch(std::size_t n,
+                                             const std::complex<double> * a, std::ptrdiff_t a_stride,
+                                             const std::complex<double> * b, std::ptrdiff_t b_stride,
+                                             const std::complex<double> * z, std::ptrdiff_t z_stride,
+                                             std::complex<double> * res, std::ptrdiff_t res_stride,
+                                             int * status, std::ptrdiff_t status_stride,
+                                             double tol, unsigned int limit, bool verbose,
+                                             unsigned int init_prec,
+                                             PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    return u_asymp_batch(n, a, a_stride, b, b_stride, z, z_stride, res, res_stride, status, status_stride, NULL, 0,
+                         Settings(tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol));
+}
+
+std::size_t ParallelEvaluator::u_asymp_batch(std::size_t n, const std::complex<double> * a, const std::complex<double> * b,
+                                             const std::complex<double> * z, std::complex<double> * res, int * status,
+                                             double tol, unsigned int limit, bool verbose,
+                                             unsigned int init_prec,
+                                             PrecisionPredictor * predictor, EscalationPolicy * policy, ResultCache * cache, FastPath * fast, StopToken * stop, double atol) noexcept
+{
+    const std::ptrdiff_t c = sizeof(std::complex<double>);
+    return u_asymp_batch(n, a, c, b, c, z, c, res, c, status, sizeof(int), tol, limit, verbose, init_prec, predictor, policy, cache, fast, stop, atol);
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,503 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "acb_hypgeom.h"
+#include "arb.h"
+#include "arf.h"
+#include "mag.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     path continuation
+// ##
+// ##     An anchor evaluates f(z0) by arb (with guard bits, as the sequences do)
+// ##     and f'(z0), the linear ODE of f in z gives the Taylor coefficients
+// ##     c_2 ... c_n of f(z0 + h) by the recurrence
+// ##       c_(k+2) = A_k c_(k+1) + B_k c_k + C_k c_(k-1).
+// ##     A later point z = z0 + h is the Taylor polynomial evaluated with arb
+// ##     balls plus a bound of the remainder. If the ball misses tol, z becomes
+// ##     the next anchor.
+// ##     The remainder: with |A_k| <= alpha, |B_k| <= beta, |C_k| <= gamma for
+// ##     k >= n-1 and lambda^3 >= alpha lambda^2 + beta lambda + gamma, the bound
+// ##     |c_k| <= K lambda^k holds for all k >= n-2 if it holds for k = n-2, n-1, n
+// ##     (induction), so sum_(k>n) |c_k| |h|^k <= K sum_(k>n) (lambda |h|)^k.
+// ##     If the anchor misses the guard bits (limit, or u_asymp outside its
+// ##     domain), z is evaluated with tol alone, the value is returned with the
+// ##     status of that evaluation and not expanded.
+// ##     An Ode provides
+// ##       int anchor(z, res, c, prec, expand, cfg)
+// ##                                   res = f(z) with the status of the function,
+// ##                                   if expand: c[0] = f(z), c[1] = f'(z) at prec
+// ##       int value(z, res, cfg)      res = f(z) only
+// ##       void coefficients(c, n, z0, prec)   c[2] ... c[n]
+// ##       double growth(n, z0)        lambda
+// ##       bool in_domain(z, cfg)      false: z needs an anchor (value error)
+// ##################################################
+
+namespace {
+
+// extra accuracy of the anchors, room for the rounding of the Taylor polynomial
+const slong PATH_GUARD_BITS = 20;
+
+std::complex<double> get_d(const acb_t x)
+{
+    return std::complex<double>(arf_get_d(arb_midref(acb_realref(x)), ARF_RND_NEAR),
+                                arf_get_d(arb_midref(acb_imagref(x)), ARF_RND_NEAR));
+}
+
+// the largest root of t^3 = alpha t^2 + beta t + gamma by Newton's method from
+// an upper bound (the iterates stay above the root), enlarged for the rounding
+double largest_root(double alpha, double beta, double gamma)
+{
+    double t = std::max(3 * alpha, std::max(std::sqrt(3 * beta), std::cbrt(3 * gamma)));
+    for (int i = 0; i < 100; i++) {
+        const double f = ((t - alpha) * t - beta) * t - gamma;
+        const double d = (3 * t - 2 * alpha) * t - beta;
+        if (!(d > 0)) break;
+        const double next = t - f / d;
+        if (!(next < t)) break;
+        t = next;
+    }
+    return t * (1 + 1e-9);
+}
+
+// the radius of the disk around z free of the branch cut (-infinity, 0]
+double cut_distance(std::complex<double> z)
+{
+    return z.real() >= 0 ? std::abs(z) : std::abs(z.imag());
+}
+
+// the anchors use guard bits, the steps tol, neither the cache nor the fast path
+// (they do not leave the ball in the workspace) nor atol (the steps need a
+// relative error)
+detail::Config path_config(const Settings & settings, unsigned int default_init_prec, slong guard_bits)
+{
+    detail::Config cfg(settings, default_init_prec);
+    cfg.err_bits_ref -= guard_bits;
+    cfg.cache = NULL;
+    cfg.fast = NULL;
+    cfg.atol = 0;
+    return cfg;
+}
+
+// Gamma(s, z): c_1 = -z^(s-1) e^-z and z Gamma'' + (z + 1 - s) Gamma' = 0, i.e.
+// c_(k+2) = -((k + z0 + 1 - s) (k+1) c_(k+1) + k c_k) / (z0 (k+1) (k+2))
+struct GammaIncOde {
+    explicit GammaIncOde(std::complex<double> s) : s_d(s)
+    {
+        acb_init(s_a); acb_init(w); acb_init(t); acb_init(u);
+        acb_set_d_d(s_a, s.real(), s.imag());
+    }
+    ~GammaIncOde() { acb_clear(s_a); acb_clear(w); acb_clear(t); acb_clear(u); }
+
+    int anchor(std::complex<double> z, std::complex<double> * res, acb_ptr c, slong & prec, bool & expand,
+               const detail::Config & cfg) {
+        const int status = detail::gamma_inc(ws, s_d, z, res, cfg);
+        expand = (status == 0) && (cut_distance(z) > 0);
+        if (!expand) return status;
+        prec = ws.prec;
+        acb_set(c, ws.res);
+        acb_set_d_d(u, z.real(), z.imag());
+        acb_sub_ui(t, s_a, 1, prec);
+        acb_pow(t, u, t, prec);
+        acb_neg(u, u);
+        acb_exp(u, u, prec);
+        acb_mul(c + 1, t, u, prec);
+        acb_neg(c + 1, c + 1);
+        return status;
+    }
+
+    int value(std::complex<double> z, std::complex<double> * res, const detail::Config & cfg) {
+        return detail::gamma_inc(ws, s_d, z, res, cfg);
+    }
+
+    void coefficients(acb_ptr c, unsigned int n, const acb_t z0, slong prec) {
+        acb_add_ui(w, z0, 1, prec);
+        acb_sub(w, w, s_a, prec);
+        for (unsigned int k = 0; k + 2 <= n; k++) {
+            acb_add_ui(t, w, k, prec);
+            acb_mul(t, t, c + k + 1, prec);
+            acb_mul_ui(t, t, k + 1, prec);
+            acb_mul_ui(u, c + k, k, prec);
+            acb_add(t, t, u, prec);
+            acb_div(t, t, z0, prec);
+            acb_div_ui(t, t, (k + 1) * (k + 2), prec);
+            acb_neg(c + k + 2, t);
+        }
+    }
+
+    // |A_k| <= (k + q) / (R (k+2)) with q = |z0 + 1 - s|, |B_k| <= 1 / (R (k+2)), C_k = 0
+    double growth(unsigned int n, std::complex<double> z0) const {
+        const double R = std::abs(z0), K = n - 1., q = std::abs(z0 + 1. - s_d);
+        return largest_root(std::max(1., (K + q) / (K + 2)) / R, 1 / (R * (K + 2)), 0);
+    }
+
+    bool in_domain(std::complex<double>, const detail::Config &) { return true; }
+
+    std::complex<double> s_d;
+    detail::GammaIncWorkspace ws;
+    acb_t s_a, w, t, u;                 // w = z0 + 1 - s
+};
+
+// U*(a, b, z) = z^a U(a, b, z): c_1 = a/z (U*(a, b, z) - U*(a+1, b+1, z)) and, with
+// p = b - 2a and e = a (a+1-b), z^2 y'' + z (p - z) y' + e y = 0, i.e.
+// c_(k+2) = -(z0 (k+1) (2k + p - z0) c_(k+1) + (k (k-1) + k (p - 2 z0) + e) c_k - (k-1) c_(k-1))
+//           / (z0^2 (k+1) (k+2))
+struct UAsympOde {
+    UAsympOde(std::complex<double> a, std::complex<double> b) : a_d(a), b_d(b)
+    {
+        acb_init(a_a); acb_init(p_a); acb_init(e_a);
+        acb_init(z2); acb_init(pz); acb_init(qz); acb_init(t); acb_init(u);
+        acb_set_d_d(a_a, a.real(), a.imag());
+        const std::complex<double> p = b - 2. * a, e = a * (a + 1. - b);
+        acb_set_d_d(p_a, p.real(), p.imag());
+        acb_set_d_d(e_a, e.real(), e.imag());
+        p_d = p;
+        e_d = e;
+    }
+    ~UAsympOde() {
+        acb_clear(a_a); acb_clear(p_a); acb_clear(e_a);
+        acb_clear(z2); acb_clear(pz); acb_clear(qz); acb_clear(t); acb_clear(u);
+    }
+
+    int anchor(std::complex<double> z, std::complex<double> * res, acb_ptr c, slong & prec, bool & expand,
+               const detail::Config & cfg) {
+        expand = false;
+        const int status = detail::u_asymp(ws, a_d, b_d, z, res, cfg);
+        if ((status != 0) || (cut_distance(z) == 0)) return status;
+        acb_set(c, ws.res);
+        prec = ws.prec;
+        std::complex<double> r;
+        if (detail::u_asymp(ws, a_d + 1., b_d + 1., z, &r, cfg) != 0) return status;
+        prec = std::max(prec, slong(ws.prec));
+        acb_sub(c + 1, c, ws.res, prec);
+        acb_set_d_d(t, z.real(), z.imag());
+        acb_div(c + 1, c + 1, t, prec);
+        acb_mul(c + 1, c + 1, a_a, prec);
+        expand = true;
+        return status;
+    }
+
+    int value(std::complex<double> z, std::complex<double> * res, const detail::Config & cfg) {
+        return detail::u_asymp(ws, a_d, b_d, z, res, cfg);
+    }
+
+    void coefficients(acb_ptr c, unsigned int n, const acb_t z0, slong prec) {
+        acb_mul(z2, z0, z0, prec);
+        acb_sub(pz, p_a, z0, prec);
+        acb_mul_2exp_si(t, z0, 1);
+        acb_sub(qz, p_a, t, prec);
+        for (unsigned int k = 0; k + 2 <= n; k++) {
+            acb_add_ui(t, pz, 2 * k, prec);
+            acb_mul(t, t, z0, prec);
+            acb_mul_ui(t, t, k + 1, prec);
+            acb_mul(t, t, c + k + 1, prec);
+            acb_mul_ui(u, qz, k, prec);
+            acb_add(u, u, e_a, prec);
+            if (k > 1) acb_add_ui(u, u, k * (k - 1), prec);
+            acb_mul(u, u, c + k, prec);
+            acb_add(t, t, u, prec);
+            if (k > 1) {
+                acb_mul_ui(u, c + k - 1, k - 1, prec);
+                acb_sub(t, t, u, prec);
+            }
+            acb_div(t, t, z2, prec);
+            acb_div_ui(t, t, (k + 1) * (k + 2), prec);
+            acb_neg(c + k + 2, t);
+        }
+    }
+
+    // |A_k| <= (2k + |p - z0|) / (R (k+2)),
+    // |B_k| <= (1 + |p - 2 z0| / (k+2) + |e| / ((k+1) (k+2))) / R^2, |C_k| <= 1 / (R^2 (k+2))
+    double growth(unsigned int n, std::complex<double> z0) const {
+        const double R = std::abs(z0), K = n - 1.;
+        const double alpha = std::max(2., (2 * K + std::abs(p_d - z0)) / (K + 2)) / R;
+        const double beta = (1 + std::abs(p_d - 2. * z0) / (K + 2) + std::abs(e_d) / ((K + 1) * (K + 2))) / (R * R);
+        return largest_root(alpha, beta, 1 / (R * R * (K + 2)));
+    }
+
+    // as u_asymp: acb_hypgeom_u_use_asymp(z, -err_bits_ref)
+    bool in_domain(std::complex<double> z, const detail::Config & cfg) {
+        acb_set_d_d(t, z.real(), z.imag());
+        return acb_hypgeom_u_use_asymp(t, -cfg.err_bits_ref);
+    }
+
+    std::complex<double> a_d, b_d, p_d, e_d;
+    detail::UAsympWorkspace ws;
+    acb_t a_a, p_a, e_a, z2, pz, qz, t, u;      // z2 = z0^2, pz = p - z0, qz = p - 2 z0
+};
+
+template <class Ode>
+struct Path {
+    Path(const Settings & settings, unsigned int default_init_prec, unsigned int order)
+        : cfg(path_config(settings, default_init_prec, 0)),
+          anchor_cfg(path_config(settings, default_init_prec, PATH_GUARD_BITS)),
+          n(std::max(order, 2u)), radius(0), lambda(0), prec(0), n_anchors(0), n_steps(0)
+    {
+        c = _acb_vec_init(n + 1);
+        acb_init(z0); acb_init(h); acb_init(x);
+        mag_init(bound); mag_init(t); mag_init(u);
+    }
+    ~Path() {
+        _acb_vec_clear(c, n + 1);
+        acb_clear(z0); acb_clear(h); acb_clear(x);
+        mag_clear(bound); mag_clear(t); mag_clear(u);
+    }
+    Path(const Path &) = delete;
+    Path & operator=(const Path &) = delete;
+
+    int operator()(Ode & ode, std::complex<double> z, std::complex<double> * res) {
+        if (step(ode, z)) {
+            *res = get_d(x);
+            n_steps++;
+            return 0;
+        }
+        return anchor(ode, z, res);
+    }
+
+    // x = f(z) by the Taylor polynomial at z0, true if it meets tol
+    bool step(Ode & ode, std::complex<double> z) {
+        if (!(std::abs(z - z0_d) < radius) || !ode.in_domain(z, cfg)) return false;
+        acb_set_d_d(h, z.real(), z.imag());
+        acb_sub(h, h, z0, prec);
+        // the remainder K sum_(k>n) (lambda |h|)^k
+        acb_get_mag(t, h);
+        mag_set_d(u, lambda);
+        mag_mul(t, t, u);
+        if (mag_cmp_2exp_si(t, 0) >= 0) return false;
+        mag_geom_series(t, t, n + 1);
+        mag_mul(t, t, bound);
+
+        acb_set(x, c + n);
+        for (unsigned int k = n; k-- > 0; ) {
+            acb_mul(x, x, h, prec);
+            acb_add(x, x, c + k, prec);
+        }
+        acb_add_error_mag(x, t);
+        return acb_rel_error_bits(x) <= cfg.err_bits_ref;
+    }
+
+    int anchor(Ode & ode, std::complex<double> z, std::complex<double> * res) {
+        radius = 0;
+        bool expand = false;
+        n_anchors++;
+        // no room for the guard bits (outside the domain of u_asymp), the value only
+        int status = ode.in_domain(z, anchor_cfg) ? ode.anchor(z, res, c, prec, expand, anchor_cfg) : -1;
+        if ((status < 0) && (status != STOPPED)) {
+            // the guard bits are out of reach, f(z) itself may still meet tol
+            expand = false;
+            status = ode.value(z, res, cfg);
+        }
+        if (!expand) return status;
+
+        z0_d = z;
+        acb_set_d_d(z0, z.real(), z.imag());
+        ode.coefficients(c, n, z0, prec);
+        lambda = ode.growth(n, z);
+        // K = max |c_k| / lambda^k over k = n-2, n-1, n
+        mag_zero(bound);
+        for (unsigned int k = n - 2; k <= n; k++) {
+            acb_get_mag(t, c + k);
+            mag_set_d_lower(u, lambda);
+            mag_pow_ui_lower(u, u, k);
+            mag_div(t, t, u);
+            mag_max(bound, bound, t);
+        }
+        if (mag_is_finite(bound)) radius = cut_distance(z);
+        return status;
+    }
+
+    const detail::Config cfg, anchor_cfg;
+    const unsigned int n;
+    acb_ptr c;                          // c_0 ... c_n at z0
+    acb_t z0, h, x;
+    std::complex<double> z0_d;
+    double radius;                      // 0: no expansion
+    double lambda;
+    slong prec;
+    mag_t bound, t, u;                  // bound = K
+    std::size_t n_anchors, n_steps;
+};
+
+// the points in order, a failed point gets NaN, after a stop all remaining ones
+template <class P>
+int run(P & path, std::size_t n, const std::complex<double> * z, std::complex<double> * res, std::size_t * anchors)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    int status = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const int point = path(z[i], res + i);
+        if (point == 0) continue;
+        if (status == 0) status = point;
+        if (point != STOPPED) {
+            res[i] = std::complex<double>(nan, nan);
+        } else {
+            for (i++; i < n; i++) res[i] = std::complex<double>(nan, nan);
+        }
+    }
+    if (anchors != NULL) *anchors = path.anchors();
+    return status;
+}
+
+void throw_path(const char * name, const char * args, int status)
+{
+    std::ostringstream oss;
+    if (status == -1) {
+        oss << "LIMIT ERROR: " << name << " " << args;
+    } else if (status == -2) {
+        oss << "VALUE ERROR: " << name << " " << args;
+    } else if (status == STOPPED) {
+        oss << "STOPPED: " << name << " " << args << " (deadline or cancellation)";
+    } else {
+        oss << name << " unknown error: error code: " << status;
+    }
+    throw std::runtime_error(oss.str());
+}
+
+}
+
+struct GammaIncPath::Impl {
+    Impl(std::complex<double> s, const Settings & settings, unsigned int order)
+        : ode(s), path(settings, GAMMA_INC_DEFAULT_INIT_PREC, order) {}
+
+    GammaIncOde ode;
+    Path<GammaIncOde> path;
+};
+
+GammaIncPath::GammaIncPath(std::complex<double> s, const Settings & settings, unsigned int order)
+    : impl(new Impl(s, settings, order)) {}
+GammaIncPath::~GammaIncPath() { delete impl; }
+
+std::complex<double> GammaIncPath::s() const { return impl->ode.s_d; }
+std::size_t GammaIncPath::anchors() const { return impl->path.n_anchors; }
+std::size_t GammaIncPath::steps() const { return impl->path.n_steps; }
+
+int GammaIncPath::operator()(std::complex<double> z, std::complex<double> * res)
+{
+    return impl->path(impl->ode, z, res);
+}
+
+std::complex<double> GammaIncPath::operator()(std::complex<double> z)
+{
+    std::complex<double> res;
+    int status = (*this)(z, &res);
+    if (status) {
+        std::ostringstream args;
+        args << "s=" << s() << " and z=" << z;
+        throw_path("gamma_inc_path", args.str().c_str(), status);
+    }
+    return res;
+}
+
+struct UAsympPath::Impl {
+    Impl(std::complex<double> a, std::complex<double> b, const Settings & settings, unsigned int order)
+        : ode(a, b), path(settings, U_ASYMP_DEFAULT_INIT_PREC, order) {}
+
+    UAsympOde ode;
+    Path<UAsympOde> path;
+};
+
+UAsympPath::UAsympPath(std::complex<double> a, std::complex<double> b, const Settings & settings,
+                       unsigned int order)
+    : impl(new Impl(a, b, settings, order)) {}
+UAsympPath::~UAsympPath() { delete impl; }
+
+std::complex<double> UAsympPath::a() const { return impl->ode.a_d; }
+std::complex<double> UAsympPath::b() const { return impl->ode.b_d; }
+std::size_t UAsympPath::anchors() const { return impl->path.n_anchors; }
+std::size_t UAsympPath::steps() const { return impl->path.n_steps; }
+
+int UAsympPath::operator()(std::complex<double> z, std::complex<double> * res)
+{
+    return impl->path(impl->ode, z, res);
+}
+
+std::complex<double> UAsympPath::operator()(std::complex<double> z)
+{
+    std::complex<double> res;
+    int status = (*this)(z, &res);
+    if (status) {
+        std::ostringstream args;
+        args << "a=" << a() << ", b=" << b() << " and z=" << z;
+        throw_path("u_asymp_path", args.str().c_str(), status);
+    }
+    return res;
+}
+
+int gamma_inc_path(std::complex<double> s, std::size_t n, const std::complex<double> * z, std::complex<double> * res,
+                   const Settings & settings, std::size_t * anchors)
+{
+    GammaIncPath path(s, settings);
+    return run(path, n, z, res, anchors);
+}
+
+std::vector<std::complex<double> > gamma_inc_path(std::complex<double> s, const std::vector<std::complex<double> > & z,
+                                                  const Settings & settings)
+{
+    std::vector<std::complex<double> > res(z.size());
+    int status = gamma_inc_path(s, z.size(), z.data(), res.data(), settings);
+    if (status) {
+        std::ostringstream args;
+        args << "s=" << s;
+        throw_path("gamma_inc_path", args.str().c_str(), status);
+    }
+    return res;
+}
+
+int u_asymp_path(std::complex<double> a, std::complex<double> b, std::size_t n, const std::complex<double> * z,
+                 std::complex<double> * res, const Settings & settings, std::size_t * anchors)
+{
+    UAsympPath path(a, b, settings);
+    return run(path, n, z, res, anchors);
+}
+
+std::vector<std::complex<double> > u_asymp_path(std::complex<double> a, std::complex<double> b,
+                                                const std::vector<std::complex<double> > & z,
+                                                const Settings & settings)
+{
+    std::vector<std::complex<double> > res(z.size());
+    int status = u_asymp_path(a, b, z.size(), z.data(), res.data(), settings);
+    if (status) {
+        std::ostringstream args;
+        args << "a=" << a << " and b=" << b;
+        throw_path("u_asymp_path", args.str().c_str(), status);
+    }
+    return res;
+}
+
+} /* namespace cplxfnc */
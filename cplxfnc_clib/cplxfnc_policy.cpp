@@ -0,0 +1,78 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+
+#include <atomic>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     precision escalation
+// ##################################################
+
+EscalationPolicy::EscalationPolicy()
+    : n_calls(0), n_attempts(0), n_failures(0)
+{}
+
+EscalationPolicy::~EscalationPolicy() {}
+
+unsigned long EscalationPolicy::calls() const { return n_calls.load(std::memory_order_relaxed); }
+unsigned long EscalationPolicy::attempts() const { return n_attempts.load(std::memory_order_relaxed); }
+unsigned long EscalationPolicy::failures() const { return n_failures.load(std::memory_order_relaxed); }
+
+void EscalationPolicy::reset_stats()
+{
+    n_calls.store(0, std::memory_order_relaxed);
+    n_attempts.store(0, std::memory_order_relaxed);
+    n_failures.store(0, std::memory_order_relaxed);
+}
+
+void EscalationPolicy::count(unsigned int attempts, bool success)
+{
+    n_calls.fetch_add(1, std::memory_order_relaxed);
+    n_attempts.fetch_add(attempts, std::memory_order_relaxed);
+    if (!success) n_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned int DoublingPolicy::next_prec(unsigned int prec, long, long) const
+{
+    return 2*prec;
+}
+
+DeficitPolicy::DeficitPolicy(unsigned int guard_bits, unsigned int min_bits)
+    : guard_bits(guard_bits), min_bits(min_bits)
+{}
+
+unsigned int DeficitPolicy::next_prec(unsigned int prec, long err_bits, long err_bits_ref) const
+{
+    // err_bits > -min_bits also covers results containing zero or being infinite
+    // (acb_rel_error_bits returns ARF_PREC_EXACT)
+    if (err_bits > -long(min_bits)) {
+        return 2*prec;
+    }
+    return prec + (unsigned int)(err_bits - err_bits_ref) + guard_bits;
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,133 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <complex>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     adaptive initial precision
+// ##################################################
+
+namespace {
+
+// buckets of the argument x: log2|x| in [-32, 96) in steps of 4, 8 sectors of the phase
+const int EXP_MIN = -32;
+const int EXP_MAX = 96;
+const int EXP_STEP = 4;
+const int N_EXP = (EXP_MAX - EXP_MIN) / EXP_STEP;
+const int N_PHASE = 8;
+
+// histogram of the final precision per bucket, bins of 16 bits, the last bin
+// collects everything above, its precision is the maximum recorded in the bucket
+const unsigned int PREC_STEP = 16;
+const unsigned int N_PREC = 64;
+
+int bucket(std::complex<double> x)
+{
+    double m = std::abs(x);
+    int e = EXP_MIN;
+    if ((m > 0) && std::isfinite(m)) {
+        e = std::ilogb(m);
+        if (e < EXP_MIN) e = EXP_MIN;
+        if (e >= EXP_MAX) e = EXP_MAX - 1;
+    }
+    int p = int((std::arg(x) + M_PI) / (2*M_PI) * N_PHASE);
+    if (p < 0) p = 0;
+    if (p >= N_PHASE) p = N_PHASE - 1;
+    return ((e - EXP_MIN) / EXP_STEP) * N_PHASE + p;
+}
+
+}
+
+struct PrecisionPredictor::Table {
+    struct Bucket {
+        std::atomic<unsigned int> count[N_PREC];
+        std::atomic<unsigned int> max_prec;
+    };
+    Bucket buckets[N_EXP * N_PHASE];
+};
+
+PrecisionPredictor::PrecisionPredictor(double quantile, unsigned int min_samples)
+    : table(new Table), quantile(quantile), min_samples(min_samples)
+{
+    reset();
+}
+
+PrecisionPredictor::~PrecisionPredictor()
+{
+    delete table;
+}
+
+void PrecisionPredictor::reset()
+{
+    for (int b = 0; b < N_EXP * N_PHASE; b++) {
+        for (unsigned int i = 0; i < N_PREC; i++) {
+            table->buckets[b].count[i].store(0, std::memory_order_relaxed);
+        }
+        table->buckets[b].max_prec.store(0, std::memory_order_relaxed);
+    }
+}
+
+void PrecisionPredictor::record(std::complex<double> x, unsigned int prec)
+{
+    if (prec == 0) return;
+    Table::Bucket & b = table->buckets[bucket(x)];
+    unsigned int i = (prec - 1) / PREC_STEP;
+    if (i >= N_PREC) i = N_PREC - 1;
+    b.count[i].fetch_add(1, std::memory_order_relaxed);
+
+    unsigned int m = b.max_prec.load(std::memory_order_relaxed);
+    while ((prec > m) && !b.max_prec.compare_exchange_weak(m, prec, std::memory_order_relaxed)) {}
+}
+
+unsigned int PrecisionPredictor::predict(std::complex<double> x) const
+{
+    const Table::Bucket & b = table->buckets[bucket(x)];
+    unsigned int count[N_PREC];
+    unsigned long total = 0;
+    for (unsigned int i = 0; i < N_PREC; i++) {
+        count[i] = b.count[i].load(std::memory_order_relaxed);
+        total += count[i];
+    }
+    if ((total == 0) || (total < min_samples)) return 0;
+
+    // the smallest bin such that the fraction quantile of the records lies below its upper edge
+    unsigned long cum = 0;
+    for (unsigned int i = 0; i < N_PREC - 1; i++) {
+        cum += count[i];
+        if (cum >= quantile * total) {
+            unsigned int prec = (i + 1) * PREC_STEP;
+            unsigned int m = b.max_prec.load(std::memory_order_relaxed);
+            return (m < prec) ? m : prec;
+        }
+    }
+    return b.max_prec.load(std::memory_order_relaxed);
+}
+
+} /* namespace cplxfnc */
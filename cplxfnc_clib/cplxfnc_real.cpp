@@ -0,0 +1,261 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "arb.h"
+#include "arf.h"
+#include "arb_hypgeom.h"
+
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     real arguments
+// ##
+// ##     real_loop is the escalation loop of cplxfnc.cpp on real balls, the
+// ##     trace events and the counters are those of the complex function.
+// ##################################################
+
+namespace {
+
+// arb temporaries of the real functions, kept alive over a batch
+struct RealWorkspace {
+    RealWorkspace() { arb_init(res); arb_init(x); arb_init(y); }
+    ~RealWorkspace() { arb_clear(res); arb_clear(x); arb_clear(y); }
+    RealWorkspace(const RealWorkspace &) = delete;
+    RealWorkspace & operator=(const RealWorkspace &) = delete;
+
+    arb_t res, x, y;
+};
+
+typedef void (*FastKernel)(std::size_t, const std::complex<double> *, const std::complex<double> *,
+                           slong, std::complex<double> *, bool *);
+
+struct RealFunction {
+    const char * name;
+    detail::StatsFunction stats;
+    CacheFunction cache;
+    FastKernel fast;
+};
+
+const RealFunction ZETA_REAL = {"zeta", detail::STATS_ZETA, CACHE_ZETA, detail::zeta_fast};
+const RealFunction GAMMA_INC_REAL = {"gamma_inc", detail::STATS_GAMMA_INC, CACHE_GAMMA_INC, detail::gamma_inc_fast};
+
+// kernel(ws, prec) sets ws.res from ws.x and ws.y, y is the main argument (a or z)
+template <class Kernel>
+int real_loop(const RealFunction & fn, RealWorkspace & ws, bool in_domain, double x, double y, double * res,
+              const detail::Config & cfg, Kernel kernel)
+{
+    using namespace detail;
+    FunctionStats & stats = thread_stats().fn[fn.stats];
+    stats.add(FunctionStats::CALLS);
+    const std::complex<double> args[2] = {x, y};
+    if (!in_domain) {
+        cfg.emit(TRACE_VALUE_ERROR, fn.name, args, 2, 0, 0, 0);
+        stats.add(FunctionStats::VALUE_ERRORS);
+        return -2;
+    }
+    std::complex<double> r;
+    if ((cfg.cache != NULL) && cfg.cache->lookup(fn.cache, args, 2, cfg.tol, &r)) {
+        *res = r.real();
+        return 0;
+    }
+    if (cfg.fast != NULL) {
+        bool ok = false;
+        fn.fast(1, &args[0], &args[1], cfg.err_bits_ref, &r, &ok);
+        cfg.fast->count(ok);
+        if (ok) {
+            *res = r.real();
+            return 0;
+        }
+    }
+
+    arb_set_d(ws.x, x);
+    arb_set_d(ws.y, y);
+
+    unsigned int prec = cfg.start_prec(y);
+    unsigned int c = 1;
+    slong err_bits;
+
+    while (1) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        kernel(ws, prec);
+        const std::uint64_t ns = elapsed_ns(t0);
+        stats.add(FunctionStats::ARB_NS, ns);
+        stats.add(FunctionStats::ARB_EVALS);
+
+        err_bits = arb_rel_error_bits(ws.res);
+        if (cfg.verbose) cfg.emit(TRACE_ATTEMPT, fn.name, args, 2, prec, err_bits, c);
+
+        const int accepted = cfg.accept(ws.res, err_bits);
+        if (accepted >= 0) {
+            *res = arf_get_d(arb_midref(ws.res), ARF_RND_NEAR);
+            if (accepted == 0) {
+                if (cfg.cache != NULL) cfg.cache->insert(fn.cache, args, 2, cfg.tol, *res);
+                cfg.record(y, prec);
+            }
+            stats.add(FunctionStats::PREC_HIST + prec_bin(prec));
+            cfg.count(c, true);
+            return accepted;
+        }
+        if (c >= cfg.limit) {
+            stats.add(FunctionStats::LIMIT_FAILURES);
+            cfg.count(c, false);
+            cfg.emit(TRACE_LIMIT, fn.name, args, 2, prec, err_bits, c);
+            return -1;
+        }
+        const unsigned int next_prec = cfg.next_prec(prec, err_bits);
+        if (cfg.stop_requested(prec, next_prec, ns)) {
+            *res = arf_get_d(arb_midref(ws.res), ARF_RND_NEAR);
+            cfg.count(c, false);
+            cfg.emit(TRACE_STOPPED, fn.name, args, 2, prec, err_bits, c);
+            return STOPPED;
+        }
+        prec = next_prec;
+        c += 1;
+        stats.add(FunctionStats::ESCALATIONS);
+    }
+}
+
+void zeta_kernel(RealWorkspace & ws, unsigned int prec)
+{
+    arb_hurwitz_zeta(ws.res, ws.x, ws.y, prec);
+}
+
+void gamma_inc_kernel(RealWorkspace & ws, unsigned int prec)
+{
+    arb_hypgeom_gamma_upper(ws.res, ws.x, ws.y, 0, prec);
+}
+
+int eval_zeta_real(RealWorkspace & ws, double s, double a, double * res, const detail::Config & cfg)
+{
+    return real_loop(ZETA_REAL, ws, a > 0, s, a, res, cfg, zeta_kernel);
+}
+
+int eval_gamma_inc_real(RealWorkspace & ws, double s, double z, double * res, const detail::Config & cfg)
+{
+    return real_loop(GAMMA_INC_REAL, ws, (z > 0) || ((z == 0) && (s >= 0)), s, z, res, cfg, gamma_inc_kernel);
+}
+
+// the batch loop, a failed point gets NaN (a stopped one keeps the estimate)
+template <class Eval>
+std::size_t real_batch(std::size_t n, const double * x, std::ptrdiff_t x_stride, const double * y,
+                       std::ptrdiff_t y_stride, double * res, std::ptrdiff_t res_stride,
+                       int * status, std::ptrdiff_t status_stride, const detail::Config & cfg, Eval eval)
+{
+    RealWorkspace ws;
+    std::size_t n_fail = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        double & r = detail::at(res, res_stride, i);
+        int st;
+        if ((cfg.stop != NULL) && cfg.stop->stop_requested()) {
+            st = STOPPED;
+            r = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            st = eval(ws, detail::at(x, x_stride, i), detail::at(y, y_stride, i), &r, cfg);
+            if ((st < 0) && (st != STOPPED)) r = std::numeric_limits<double>::quiet_NaN();
+        }
+        if (status != NULL) detail::at(status, status_stride, i) = st;
+        if (st < 0) n_fail++;
+    }
+    return n_fail;
+}
+
+void throw_real(const char * name, const char * y_name, double s, double y, int status)
+{
+    std::ostringstream oss;
+    if (status == -1) {
+        oss << "LIMIT ERROR: " << name << " s=" << s << " and " << y_name << "=" << y;
+    } else if (status == -2) {
+        oss << "VALUE ERROR: " << name << " s=" << s << " and " << y_name << "=" << y << ", the result is not real";
+    } else if (status == STOPPED) {
+        oss << "STOPPED: " << name << " s=" << s << " and " << y_name << "=" << y << " (deadline or cancellation)";
+    } else {
+        oss << name << " unknown error: error code: " << status;
+    }
+    throw std::runtime_error(oss.str());
+}
+
+}
+
+int zeta_real(double s, double a, double * res, const Settings & settings)
+{
+    RealWorkspace ws;
+    return eval_zeta_real(ws, s, a, res, detail::Config(settings, ZETA_DEFAULT_INIT_PREC));
+}
+
+int gamma_inc_real(double s, double z, double * res, const Settings & settings)
+{
+    RealWorkspace ws;
+    return eval_gamma_inc_real(ws, s, z, res, detail::Config(settings, GAMMA_INC_DEFAULT_INIT_PREC));
+}
+
+double zeta_real(double s, double a, const Settings & settings)
+{
+    double res;
+    int status = zeta_real(s, a, &res, settings);
+    if (status < 0) throw_real("zeta_real", "a", s, a, status);
+    return res;
+}
+
+double gamma_inc_real(double s, double z, const Settings & settings)
+{
+    double res;
+    int status = gamma_inc_real(s, z, &res, settings);
+    if (status < 0) throw_real("gamma_inc_real", "z", s, z, status);
+    return res;
+}
+
+std::size_t zeta_real_batch(std::size_t n,
+                            const double * s, std::ptrdiff_t s_stride,
+                            const double * a, std::ptrdiff_t a_stride,
+                            double * res, std::ptrdiff_t res_stride,
+                            int * status, std::ptrdiff_t status_stride,
+                            const Settings & settings) noexcept
+{
+    return real_batch(n, s, s_stride, a, a_stride, res, res_stride, status, status_stride,
+                      detail::Config(settings, ZETA_DEFAULT_INIT_PREC), eval_zeta_real);
+}
+
+std::size_t gamma_inc_real_batch(std::size_t n,
+                                 const double * s, std::ptrdiff_t s_stride,
+                                 const double * z, std::ptrdiff_t z_stride,
+                                 double * res, std::ptrdiff_t res_stride,
+                                 int * status, std::ptrdiff_t status_stride,
+                                 const Settings & settings) noexcept
+{
+    return real_batch(n, s, s_stride, z, z_stride, res, res_stride, status, status_stride,
+                      detail::Config(settings, GAMMA_INC_DEFAULT_INIT_PREC), eval_gamma_inc_real);
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,298 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "arb.h"
+#include "arf.h"
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     sequences
+// ##
+// ##     sequence() fills the range [lo, hi] of the values still missing:
+// ##     anchor at lo and step forward while the balls meet err_bits_ref, then
+// ##     anchor at hi and step backward, repeat. Every round settles at least
+// ##     the two anchors, the values in between are settled by the direction
+// ##     in which the recurrence is stable.
+// ##     A Seq provides
+// ##       int anchor(k, x, prec)       x = f(k) by arb, prec set to its precision
+// ##       void start_forward(k, prec)  prepare the steps from k on
+// ##       void forward(k, x, prec)     x = f(k) -> x = f(k+1)
+// ##       void start_backward(k, prec) prepare the steps from k down
+// ##       void backward(k, x, prec)    x = f(k) -> x = f(k-1)
+// ##################################################
+
+namespace {
+
+// extra accuracy of the anchors, room for the error growth of the recurrence
+const slong SEQUENCE_GUARD_BITS = 20;
+
+std::complex<double> get_d(const acb_t x)
+{
+    return std::complex<double>(arf_get_d(arb_midref(acb_realref(x)), ARF_RND_NEAR),
+                                arf_get_d(arb_midref(acb_imagref(x)), ARF_RND_NEAR));
+}
+
+template <class Seq>
+int sequence(Seq & seq, std::size_t n, std::complex<double> * res, slong err_bits_ref, std::size_t * anchors)
+{
+    std::size_t n_anchors = 0;
+    int status = 0;
+    if (n > 0) {
+        acb_t x;
+        acb_init(x);
+        slong prec;
+        std::size_t lo = 0, hi = n - 1;     // the values lo ... hi are missing
+        bool forward = true, done = false;
+        while (!done) {
+            std::size_t j = forward ? lo : hi;
+            status = seq.anchor(j, x, prec);
+            if (status) break;
+            n_anchors++;
+            res[j] = get_d(x);
+            if (forward) {
+                seq.start_forward(j, prec);
+                while (j < hi) {
+                    seq.forward(j, x, prec);
+                    if (acb_rel_error_bits(x) > err_bits_ref) break;
+                    res[++j] = get_d(x);
+                }
+                if (j == hi) done = true;
+                else lo = j + 1;
+            } else {
+                seq.start_backward(j, prec);
+                while (j > lo) {
+                    seq.backward(j, x, prec);
+                    if (acb_rel_error_bits(x) > err_bits_ref) break;
+                    res[--j] = get_d(x);
+                }
+                if (j == lo) done = true;
+                else hi = j - 1;
+            }
+            forward = !forward;
+        }
+        if (status) {
+            for (std::size_t i = lo; i <= hi; i++) {
+                res[i] = std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                                              std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+        acb_clear(x);
+    }
+    if (anchors != NULL) *anchors = n_anchors;
+    return status;
+}
+
+// Gamma(s+k+1, z) = (s+k) Gamma(s+k, z) + t_k with t_k = z^(s+k) e^-z
+struct GammaIncSequence {
+    GammaIncSequence(std::complex<double> s, std::complex<double> z, const detail::Config & cfg)
+        : s_d(s), z_d(z), cfg(cfg)
+    {
+        acb_init(s_a); acb_init(z_a); acb_init(t); acb_init(u);
+        acb_set_d_d(s_a, s.real(), s.imag());
+        acb_set_d_d(z_a, z.real(), z.imag());
+    }
+    ~GammaIncSequence() { acb_clear(s_a); acb_clear(z_a); acb_clear(t); acb_clear(u); }
+
+    int anchor(std::size_t k, acb_t x, slong & prec) {
+        std::complex<double> r;
+        int status = detail::gamma_inc(ws, s_d + double(k), z_d, &r, cfg);
+        if (status == 0) {
+            acb_set(x, ws.res);
+            prec = ws.prec;
+        }
+        return status;
+    }
+
+    // t = z^(s+k) e^-z
+    void set_t(std::size_t k, slong prec) {
+        if (acb_is_zero(z_a)) {
+            acb_zero(t);
+            return;
+        }
+        acb_add_ui(u, s_a, k, prec);
+        acb_pow(t, z_a, u, prec);
+        acb_neg(u, z_a);
+        acb_exp(u, u, prec);
+        acb_mul(t, t, u, prec);
+    }
+
+    void start_forward(std::size_t k, slong prec) { set_t(k, prec); }
+
+    void forward(std::size_t k, acb_t x, slong prec) {
+        acb_add_ui(u, s_a, k, prec);
+        acb_mul(x, x, u, prec);
+        acb_add(x, x, t, prec);
+        acb_mul(t, t, z_a, prec);
+    }
+
+    void start_backward(std::size_t k, slong prec) {
+        if (k > 0) set_t(k - 1, prec);
+    }
+
+    // Gamma(s+k-1, z) = (Gamma(s+k, z) - t_(k-1)) / (s+k-1)
+    void backward(std::size_t k, acb_t x, slong prec) {
+        acb_sub(x, x, t, prec);
+        acb_add_ui(u, s_a, k - 1, prec);
+        acb_div(x, x, u, prec);
+        if (!acb_is_zero(z_a)) acb_div(t, t, z_a, prec);
+    }
+
+    std::complex<double> s_d, z_d;
+    const detail::Config & cfg;
+    detail::GammaIncWorkspace ws;
+    acb_t s_a, z_a, t, u;
+};
+
+// zeta(s, a+k+1) = zeta(s, a+k) - (a+k)^-s
+struct ZetaSequence {
+    ZetaSequence(std::complex<double> s, std::complex<double> a, const detail::Config & cfg)
+        : s_d(s), a_d(a), cfg(cfg)
+    {
+        acb_init(s_a); acb_init(a_a); acb_init(t); acb_init(u);
+        acb_set_d_d(s_a, s.real(), s.imag());
+        acb_neg(s_a, s_a);
+        acb_set_d_d(a_a, a.real(), a.imag());
+    }
+    ~ZetaSequence() { acb_clear(s_a); acb_clear(a_a); acb_clear(t); acb_clear(u); }
+
+    int anchor(std::size_t k, acb_t x, slong & prec) {
+        std::complex<double> r;
+        int status = detail::zeta(ws, s_d, a_d + double(k), &r, cfg);
+        if (status == 0) {
+            acb_set(x, ws.z);
+            prec = ws.prec;
+        }
+        return status;
+    }
+
+    // t = (a+k)^-s
+    void set_t(std::size_t k, slong prec) {
+        acb_add_ui(u, a_a, k, prec);
+        acb_pow(t, u, s_a, prec);
+    }
+
+    void start_forward(std::size_t, slong) {}
+
+    void forward(std::size_t k, acb_t x, slong prec) {
+        set_t(k, prec);
+        acb_sub(x, x, t, prec);
+    }
+
+    void start_backward(std::size_t, slong) {}
+
+    void backward(std::size_t k, acb_t x, slong prec) {
+        set_t(k - 1, prec);
+        acb_add(x, x, t, prec);
+    }
+
+    std::complex<double> s_d, a_d;
+    const detail::Config & cfg;
+    detail::ZetaWorkspace ws;
+    acb_t s_a, a_a, t, u;           // s_a = -s
+};
+
+// the configuration of the anchors: guard bits, no cache and no fast path
+// (they do not leave the ball in the workspace), tol only (the steps need a
+// relative error)
+detail::Config anchor_config(const Settings & settings, unsigned int default_init_prec)
+{
+    detail::Config cfg(settings, default_init_prec);
+    cfg.err_bits_ref -= SEQUENCE_GUARD_BITS;
+    cfg.cache = NULL;
+    cfg.fast = NULL;
+    cfg.atol = 0;
+    return cfg;
+}
+
+}
+
+int zeta_sequence(std::complex<double> s, std::complex<double> a, std::size_t n, std::complex<double> * res,
+                  const Settings & settings, std::size_t * anchors)
+{
+    const detail::Config cfg = anchor_config(settings, ZETA_DEFAULT_INIT_PREC);
+    ZetaSequence seq(s, a, cfg);
+    return sequence(seq, n, res, cfg.err_bits_ref + SEQUENCE_GUARD_BITS, anchors);
+}
+
+std::vector<std::complex<double> > zeta_sequence(std::complex<double> s, std::complex<double> a, std::size_t n,
+                                                 const Settings & settings)
+{
+    std::vector<std::complex<double> > res(n);
+    int status = zeta_sequence(s, a, n, res.data(), settings);
+    if (status) {
+        std::ostringstream oss;
+        if (status == -1) {
+            oss << "LIMIT ERROR: zeta_sequence s=" << s << " and a=" << a;
+        } else if (status == STOPPED) {
+            oss << "STOPPED: zeta_sequence s=" << s << " and a=" << a << " (deadline or cancellation)";
+        } else {
+            oss << "zeta_sequence unknown error: error code: " << status;
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+int gamma_inc_sequence(std::complex<double> s, std::complex<double> z, std::size_t n, std::complex<double> * res,
+                       const Settings & settings, std::size_t * anchors)
+{
+    const detail::Config cfg = anchor_config(settings, GAMMA_INC_DEFAULT_INIT_PREC);
+    GammaIncSequence seq(s, z, cfg);
+    return sequence(seq, n, res, cfg.err_bits_ref + SEQUENCE_GUARD_BITS, anchors);
+}
+
+std::vector<std::complex<double> > gamma_inc_sequence(std::complex<double> s, std::complex<double> z, std::size_t n,
+                                                      const Settings & settings)
+{
+    std::vector<std::complex<double> > res(n);
+    int status = gamma_inc_sequence(s, z, n, res.data(), settings);
+    if (status) {
+        std::ostringstream oss;
+        if (status == -1) {
+            oss << "LIMIT ERROR: gamma_inc_sequence s=" << s << " and z=" << z;
+        } else if (status == STOPPED) {
+            oss << "STOPPED: gamma_inc_sequence s=" << s << " and z=" << z << " (deadline or cancellation)";
+        } else if (status == -2) {
+            oss << "VALUE ERROR: gamma_inc_sequence, if Re(s) < 0 then z must not be zero!";
+        } else {
+            oss << "gamma_inc_sequence unknown error: error code: " << status;
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,161 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "arb.h"
+
+#include <cmath>
+#include <complex>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     special values
+// ##
+// ##     Arguments with a closed form are evaluated with cheaper arb kernels
+// ##     inside the usual escalation loop, so tol, limit and the error bound
+// ##     are those of the generic kernel.
+// ##
+// ##     zeta(s, 1)        acb_zeta, arb_zeta_ui for integer s >= 2
+// ##     zeta(n, a)        integer n >= 2 and a = m or m + 1/2 (m integer):
+// ##                       zeta(n, m) = zeta(n) - sum_{k=1}^{m-1} k^-n
+// ##                       zeta(n, m + 1/2) = (2^n - 1) zeta(n) - 2^n sum_{k=0}^{m-1} (2k+1)^-n
+// ##                       the sum cancels about n log2(a) bits, which are
+// ##                       added to the precision and limited to SPECIAL_MAX_LOSS
+// ##     gamma_inc(s, 0)   Gamma(s) for Re(s) > 0
+// ##     gamma_inc(1, z)   exp(-z)
+// ##     gamma_inc(n, z)   (n-1)! exp(-z) sum_{k<n} z^k / k! for 2 <= n <= SPECIAL_MAX_TERMS
+// ##################################################
+
+namespace {
+
+const double SPECIAL_MAX_LOSS = 24;
+const double SPECIAL_MAX_TERMS = 64;
+
+// true if x is an integer in [lo, hi]
+bool is_int(std::complex<double> x, double lo, double hi)
+{
+    return (x.imag() == 0) && (x.real() >= lo) && (x.real() <= hi) && (std::floor(x.real()) == x.real());
+}
+
+// the bits zeta(n, m) - zeta(n) cancels, a >= 1/2
+double zeta_loss(double n, double a)
+{
+    return (a > 1) ? n * std::log2(a) : 0;
+}
+
+}
+
+int detail::zeta_special(std::complex<double> s, std::complex<double> a)
+{
+    if (a == std::complex<double>(1, 0)) return CPLXFNC_SPECIAL_ZETA_RIEMANN;
+    if (!is_int(s, 2, WORD_MAX) || !is_int(2. * a, 1, 2 * SPECIAL_MAX_TERMS)) return SPECIAL_NONE;
+    if (zeta_loss(s.real(), a.real()) > SPECIAL_MAX_LOSS) return SPECIAL_NONE;
+    return CPLXFNC_SPECIAL_ZETA_RATIONAL;
+}
+
+void detail::zeta_special_eval(acb_t res, int kind, std::complex<double> s, const acb_t s_b,
+                               std::complex<double> a, slong prec)
+{
+    if ((kind == CPLXFNC_SPECIAL_ZETA_RIEMANN) && !is_int(s, 2, WORD_MAX)) {
+        acb_zeta(res, s_b, prec);
+        return;
+    }
+
+    // integer n >= 2, a = 1, m or m + 1/2
+    const ulong n = ulong(s.real());
+    const ulong a2 = ulong(2. * a.real());
+    prec += slong(zeta_loss(s.real(), a.real()));
+    arb_ptr r = acb_realref(res);
+    arb_zeta_ui(r, n, prec);
+    arb_t t;
+    arb_init(t);
+    if (a2 % 2 == 0) {
+        // zeta(n, m), m = a2 / 2
+        for (ulong k = 1; k < a2 / 2; k++) {
+            arb_set_ui(t, k);
+            arb_pow_ui(t, t, n, prec);
+            arb_inv(t, t, prec);
+            arb_sub(r, r, t, prec);
+        }
+    } else {
+        // zeta(n, m + 1/2) = 2^n (zeta(n) - 2^-n zeta(n) - sum_{k<m} (2k+1)^-n)
+        arb_mul_2exp_si(t, r, -slong(n));
+        arb_sub(r, r, t, prec);
+        for (ulong k = 0; k < a2 / 2; k++) {
+            arb_set_ui(t, 2 * k + 1);
+            arb_pow_ui(t, t, n, prec);
+            arb_inv(t, t, prec);
+            arb_sub(r, r, t, prec);
+        }
+        arb_mul_2exp_si(r, r, slong(n));
+    }
+    arb_clear(t);
+    arb_zero(acb_imagref(res));
+}
+
+int detail::gamma_inc_special(std::complex<double> s, std::complex<double> z)
+{
+    if ((z == std::complex<double>(0, 0)) && (s.real() > 0)) return CPLXFNC_SPECIAL_GAMMA;
+    if (s == std::complex<double>(1, 0)) return CPLXFNC_SPECIAL_EXP;
+    if (is_int(s, 2, SPECIAL_MAX_TERMS)) return CPLXFNC_SPECIAL_FINITE_SUM;
+    return SPECIAL_NONE;
+}
+
+void detail::gamma_inc_special_eval(acb_t res, int kind, std::complex<double> s, const acb_t s_b,
+                                    const acb_t z_b, slong prec)
+{
+    if (kind == CPLXFNC_SPECIAL_GAMMA) {
+        acb_gamma(res, s_b, prec);
+        return;
+    }
+    acb_t e;
+    acb_init(e);
+    acb_neg(e, z_b);
+    acb_exp(e, e, prec);
+    if (kind == CPLXFNC_SPECIAL_EXP) {
+        acb_swap(res, e);
+    } else {
+        // Horner: sum_{k<n} z^k / k! = 1 + z (1 + z/2 (1 + ... (1 + z/(n-1))))
+        const ulong n = ulong(s.real());
+        acb_one(res);
+        for (ulong k = n - 1; k >= 1; k--) {
+            acb_mul(res, res, z_b, prec);
+            acb_div_ui(res, res, k, prec);
+            acb_add_ui(res, res, 1, prec);
+        }
+        arb_t f;
+        arb_init(f);
+        arb_fac_ui(f, n - 1, prec);
+        acb_mul_arb(res, res, f, prec);
+        acb_mul(res, res, e, prec);
+        arb_clear(f);
+    }
+    acb_clear(e);
+}
+
+} /* namespace cplxfnc */
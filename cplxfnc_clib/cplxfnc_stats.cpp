@@ -0,0 +1,165 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     instrumentation counters
+// ##
+// ##     Every thread owns a ThreadStats block and is its only writer, so the
+// ##     counters are bumped with plain (relaxed) loads and stores, no locked
+// ##     instruction and no shared cache line on the evaluation path. The blocks
+// ##     register with a global registry when a thread first counts something.
+// ##     A read sums all live blocks and the totals of the threads that have
+// ##     finished. A reset only stores the current sums as baseline, the writers
+// ##     are never touched.
+// ##################################################
+
+namespace {
+
+// plain copy of the counters of all functions
+struct Totals {
+    std::uint64_t v[detail::N_STATS_FUNCTIONS][detail::FunctionStats::N_COUNTERS];
+
+    Totals() { std::memset(v, 0, sizeof(v)); }
+
+    void add(const detail::ThreadStats & ts) {
+        for (int f = 0; f < detail::N_STATS_FUNCTIONS; f++) {
+            for (int i = 0; i < detail::FunctionStats::N_COUNTERS; i++) {
+                v[f][i] += ts.fn[f].c[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<detail::ThreadStats *> live;
+    Totals retired;     // threads which have finished
+    Totals baseline;    // the sums at the last reset
+
+    Totals sum() {
+        Totals t = retired;
+        for (std::size_t i = 0; i < live.size(); i++) t.add(*live[i]);
+        return t;
+    }
+};
+
+Registry & registry()
+{
+    static Registry r;
+    return r;
+}
+
+} /* namespace */
+
+detail::ThreadStats::ThreadStats()
+{
+    for (int f = 0; f < N_STATS_FUNCTIONS; f++) {
+        for (int i = 0; i < FunctionStats::N_COUNTERS; i++) fn[f].c[i].store(0, std::memory_order_relaxed);
+    }
+    Registry & r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+detail::ThreadStats::~ThreadStats()
+{
+    Registry & r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.add(*this);
+    for (std::size_t i = 0; i < r.live.size(); i++) {
+        if (r.live[i] == this) {
+            r.live[i] = r.live.back();
+            r.live.pop_back();
+            break;
+        }
+    }
+}
+
+detail::ThreadStats & detail::thread_stats()
+{
+    static thread_local ThreadStats ts;
+    return ts;
+}
+
+unsigned int detail::prec_bin(unsigned int prec)
+{
+    // prec in (2^(k-1), 2^k] -> k
+    unsigned int k = 0;
+    while ((k < CPLXFNC_PREC_BINS - 1) && ((1u << k) < prec)) k++;
+    return k;
+}
+
+} /* namespace cplxfnc */
+
+extern "C" {
+
+int cplxfnc_stats_read(int function, struct cplxfnc_stats * stats)
+{
+    using namespace cplxfnc;
+    if ((function < 0) || (function >= detail::N_STATS_FUNCTIONS) || (stats == NULL)) return -2;
+
+    Totals t;
+    {
+        Registry & r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        t = r.sum();
+        for (int i = 0; i < detail::FunctionStats::N_COUNTERS; i++) {
+            t.v[function][i] -= r.baseline.v[function][i];
+        }
+    }
+    const std::uint64_t * v = t.v[function];
+    stats->calls          = v[detail::FunctionStats::CALLS];
+    stats->arb_evals      = v[detail::FunctionStats::ARB_EVALS];
+    stats->escalations    = v[detail::FunctionStats::ESCALATIONS];
+    stats->limit_failures = v[detail::FunctionStats::LIMIT_FAILURES];
+    stats->value_errors   = v[detail::FunctionStats::VALUE_ERRORS];
+    stats->arb_ns         = v[detail::FunctionStats::ARB_NS];
+    for (int k = 0; k < CPLXFNC_PREC_BINS; k++) {
+        stats->prec_hist[k] = v[detail::FunctionStats::PREC_HIST + k];
+    }
+    for (int k = 0; k < CPLXFNC_SPECIAL_KINDS; k++) {
+        stats->special[k] = v[detail::FunctionStats::SPECIAL + k];
+    }
+    return 0;
+}
+
+void cplxfnc_stats_reset(void)
+{
+    using namespace cplxfnc;
+    Registry & r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.baseline = r.sum();
+}
+
+}
@@ -0,0 +1,424 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     interpolation tables
+// ##
+// ##     The coefficients of cell (i, j) (i along the real axis) start at
+// ##     (j*nx + i)*(degree+1)^2, c[m*(degree+1) + n] multiplies T_m(x) T_n(y)
+// ##     where x, y in [-1, 1] are the local coordinates of the cell.
+// ##################################################
+
+namespace {
+
+const char TABLE_MAGIC[8] = {'C', 'P', 'L', 'X', 'T', 'A', 'B', '\0'};
+const std::uint32_t TABLE_VERSION = 1;
+
+// the file starts with the header, followed by the coefficients
+struct TableHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t function;
+    std::uint32_t nx, ny, degree, reserved;
+    double s[2], lower[2], upper[2];
+    double max_err;
+    double reserved2;
+};
+
+static_assert(sizeof(TableHeader) % sizeof(std::complex<double>) == 0, "coefficients must stay aligned");
+
+// the Chebyshev points on [-1, 1], nodes (first kind, n points) and extrema (n points)
+double cheb_node(unsigned int j, unsigned int n) { return std::cos(M_PI*(j + 0.5)/n); }
+double cheb_extremum(unsigned int j, unsigned int n) { return std::cos(M_PI*j/(n - 1)); }
+
+// true if the rectangle meets the ray (-inf, 0]
+bool meets_negative_axis(std::complex<double> lower, std::complex<double> upper)
+{
+    return (lower.real() <= 0) && (lower.imag() <= 0) && (upper.imag() >= 0);
+}
+
+// true if the rectangle contains one of 0, -1, -2, ...
+bool contains_nonpositive_integer(std::complex<double> lower, std::complex<double> upper)
+{
+    const double n = std::ceil(lower.real());
+    return (lower.imag() <= 0) && (upper.imag() >= 0) && (n <= 0) && (n <= upper.real());
+}
+
+bool is_integer(std::complex<double> s) { return (s.imag() == 0) && (s.real() == std::floor(s.real())); }
+
+// why w -> function(s, w) is not analytic on the rectangle, NULL if it is
+const char * singularity(TableFunction function, std::complex<double> s,
+                         std::complex<double> lower, std::complex<double> upper)
+{
+    if (function == TABLE_ZETA) {
+        if (s == 1.) return "zeta(1, a) is a pole";
+        // for integer s only the poles at a = 0, -1, ... remain of the cut
+        if (is_integer(s) ? contains_nonpositive_integer(lower, upper) : meets_negative_axis(lower, upper)) {
+            return "the rectangle meets the branch cut a in (-inf, 0] of zeta";
+        }
+    } else if (!(is_integer(s) && (s.real() > 0)) && meets_negative_axis(lower, upper)) {
+        return "the rectangle meets the branch cut z in (-inf, 0] of gamma_inc";
+    }
+    return NULL;
+}
+
+}
+
+struct InterpolationTable::Impl {
+    Impl() : base(NULL), size(0), coef(NULL) {}
+    ~Impl() { if (base != NULL) munmap(base, size); }
+
+    // the n_points function values at w
+    void evaluate(const Settings & settings, const std::vector<std::complex<double> > & w,
+                  std::vector<std::complex<double> > & f) const;
+    // center and half widths of cell (i, j)
+    std::complex<double> center(unsigned int i, unsigned int j) const;
+    std::complex<double> lookup(unsigned int i, unsigned int j, double x, double y) const;
+
+    TableHeader header;
+    double hx, hy;                                  // the cell widths
+    std::vector<std::complex<double> > owned;       // built tables
+    void * base;                                    // mapped tables
+    std::size_t size;
+    const std::complex<double> * coef;
+};
+
+void InterpolationTable::Impl::evaluate(const Settings & settings, const std::vector<std::complex<double> > & w,
+                                        std::vector<std::complex<double> > & f) const
+{
+    const std::complex<double> s(header.s[0], header.s[1]);
+    const std::ptrdiff_t step = sizeof(std::complex<double>);
+    std::vector<int> status(w.size());
+    f.resize(w.size());
+    // the nodes and check points need the relative error (max_err), not atol
+    Settings rel_settings(settings);
+    rel_settings.atol = 0;
+    std::size_t n_fail;
+    if (header.function == TABLE_ZETA) {
+        n_fail = ZetaEvaluator(rel_settings).batch(w.size(), &s, 0, w.data(), step, f.data(), step,
+                                               status.data(), sizeof(int));
+    } else {
+        n_fail = GammaIncEvaluator(rel_settings).batch(w.size(), &s, 0, w.data(), step, f.data(), step,
+                                                   status.data(), sizeof(int));
+    }
+    if (n_fail) {
+        for (std::size_t k = 0; k < w.size(); k++) {
+            if (status[k] < 0) {
+                std::ostringstream oss;
+                oss << "InterpolationTable: evaluation failed (status " << status[k] << ") at " << w[k];
+                throw std::runtime_error(oss.str());
+            }
+        }
+    }
+}
+
+std::complex<double> InterpolationTable::Impl::center(unsigned int i, unsigned int j) const
+{
+    return std::complex<double>(header.lower[0] + (i + 0.5)*hx, header.lower[1] + (j + 0.5)*hy);
+}
+
+std::complex<double> InterpolationTable::Impl::lookup(unsigned int i, unsigned int j, double x, double y) const
+{
+    const unsigned int d1 = header.degree + 1;
+    double tx[CPLXFNC_TABLE_MAX_DEGREE + 1], ty[CPLXFNC_TABLE_MAX_DEGREE + 1];
+    tx[0] = ty[0] = 1;
+    tx[1] = x;
+    ty[1] = y;
+    for (unsigned int m = 1; m + 1 < d1; m++) {
+        tx[m + 1] = 2*x*tx[m] - tx[m - 1];
+        ty[m + 1] = 2*y*ty[m] - ty[m - 1];
+    }
+
+    // acc_n = sum_m c_mn T_m(x) runs over the contiguous coefficients with
+    // independent accumulators (re and im interleaved), then one short sum over n
+    const double * c = reinterpret_cast<const double *>(coef + std::size_t(j*header.nx + i)*d1*d1);
+    double acc[2*(CPLXFNC_TABLE_MAX_DEGREE + 1)];
+    for (unsigned int k = 0; k < 2*d1; k++) acc[k] = c[k];
+    for (unsigned int m = 1; m < d1; m++) {
+        const double * cm = c + 2*m*d1;
+        for (unsigned int k = 0; k < 2*d1; k++) acc[k] += cm[k]*tx[m];
+    }
+    double re = 0, im = 0;
+    for (unsigned int n = 0; n < d1; n++) {
+        re += acc[2*n]*ty[n];
+        im += acc[2*n + 1]*ty[n];
+    }
+    return std::complex<double>(re, im);
+}
+
+InterpolationTable::InterpolationTable(TableFunction function, std::complex<double> s,
+                                       std::complex<double> lower, std::complex<double> upper,
+                                       unsigned int nx, unsigned int ny, unsigned int degree,
+                                       const Settings & settings)
+    : impl(new Impl())
+{
+    if (((function != TABLE_ZETA) && (function != TABLE_GAMMA_INC)) || (nx == 0) || (ny == 0) ||
+        (degree == 0) || (degree > CPLXFNC_TABLE_MAX_DEGREE) ||
+        !(lower.real() < upper.real()) || !(lower.imag() < upper.imag())) {
+        delete impl;
+        throw std::runtime_error("InterpolationTable: invalid arguments");
+    }
+    if (const char * reason = singularity(function, s, lower, upper)) {
+        delete impl;
+        throw std::runtime_error(std::string("InterpolationTable: ") + reason);
+    }
+    TableHeader & h = impl->header;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, TABLE_MAGIC, sizeof(h.magic));
+    h.version = TABLE_VERSION;
+    h.function = function;
+    h.nx = nx;
+    h.ny = ny;
+    h.degree = degree;
+    h.s[0] = s.real();          h.s[1] = s.imag();
+    h.lower[0] = lower.real();  h.lower[1] = lower.imag();
+    h.upper[0] = upper.real();  h.upper[1] = upper.imag();
+    impl->hx = (upper.real() - lower.real())/nx;
+    impl->hy = (upper.imag() - lower.imag())/ny;
+
+    const unsigned int d1 = degree + 1;
+    const unsigned int d2 = degree + 2;
+    const std::size_t n_cells = std::size_t(nx)*ny;
+
+    try {
+        // values at the nodes of all cells, one batch
+        std::vector<std::complex<double> > w, f;
+        w.reserve(n_cells*d1*d1);
+        for (unsigned int j = 0; j < ny; j++) {
+            for (unsigned int i = 0; i < nx; i++) {
+                const std::complex<double> c = impl->center(i, j);
+                for (unsigned int p = 0; p < d1; p++) {
+                    for (unsigned int q = 0; q < d1; q++) {
+                        w.push_back(c + std::complex<double>(0.5*impl->hx*cheb_node(p, d1),
+                                                             0.5*impl->hy*cheb_node(q, d1)));
+                    }
+                }
+            }
+        }
+        impl->evaluate(settings, w, f);
+
+        // c_mn = (2/d1)^2 sum_pq f_pq T_m(x_p) T_n(y_q), halved for m=0 and n=0
+        std::vector<double> T(d1*d1);
+        for (unsigned int m = 0; m < d1; m++) {
+            for (unsigned int p = 0; p < d1; p++) T[m*d1 + p] = std::cos(M_PI*m*(p + 0.5)/d1);
+        }
+        impl->owned.assign(n_cells*d1*d1, std::complex<double>(0));
+        std::vector<std::complex<double> > g(d1*d1);
+        for (std::size_t k = 0; k < n_cells; k++) {
+            const std::complex<double> * fk = &f[k*d1*d1];
+            std::complex<double> * ck = &impl->owned[k*d1*d1];
+            for (unsigned int m = 0; m < d1; m++) {
+                for (unsigned int q = 0; q < d1; q++) {
+                    std::complex<double> sum = 0;
+                    for (unsigned int p = 0; p < d1; p++) sum += fk[p*d1 + q]*T[m*d1 + p];
+                    g[m*d1 + q] = sum*(m ? 2. : 1.)/double(d1);
+                }
+            }
+            for (unsigned int m = 0; m < d1; m++) {
+                for (unsigned int n = 0; n < d1; n++) {
+                    std::complex<double> sum = 0;
+                    for (unsigned int q = 0; q < d1; q++) sum += g[m*d1 + q]*T[n*d1 + q];
+                    ck[m*d1 + n] = sum*(n ? 2. : 1.)/double(d1);
+                }
+            }
+        }
+        impl->coef = impl->owned.data();
+
+        // verification at the extrema of all cells
+        w.clear();
+        w.reserve(n_cells*d2*d2);
+        for (unsigned int j = 0; j < ny; j++) {
+            for (unsigned int i = 0; i < nx; i++) {
+                const std::complex<double> c = impl->center(i, j);
+                for (unsigned int p = 0; p < d2; p++) {
+                    for (unsigned int q = 0; q < d2; q++) {
+                        w.push_back(c + std::complex<double>(0.5*impl->hx*cheb_extremum(p, d2),
+                                                             0.5*impl->hy*cheb_extremum(q, d2)));
+                    }
+                }
+            }
+        }
+        impl->evaluate(settings, w, f);
+        // a check point passes if the deviation is within settings.tol (plus the
+        // rounding of the arb value to double) and the rounding error of the
+        // lookup, bounded by (degree+1)^2 u sum |c_mn| since |T_m| <= 1
+        const double u = std::ldexp(1., -53);
+        double max_err = 0;
+        for (std::size_t k = 0; k < n_cells; k++) {
+            const unsigned int i = k % nx, j = k / nx;
+            double c_abs = 0;
+            for (unsigned int m = 0; m < d1*d1; m++) c_abs += std::abs(impl->coef[k*d1*d1 + m]);
+            const double round = d1*d1*u*c_abs;
+            for (unsigned int p = 0; p < d2; p++) {
+                for (unsigned int q = 0; q < d2; q++) {
+                    const std::complex<double> fv = f[(k*d2 + p)*d2 + q];
+                    const std::complex<double> pv = impl->lookup(i, j, cheb_extremum(p, d2), cheb_extremum(q, d2));
+                    const double dev = std::abs(pv - fv);
+                    double err = dev;
+                    if (fv != 0.) err /= std::abs(fv);
+                    if (!(err <= max_err)) max_err = err;      // nan propagates
+                    if (!(dev <= (settings.tol + u)*std::abs(fv) + round)) {
+                        std::ostringstream oss;
+                        oss << "InterpolationTable: relative error " << err << " exceeds tol " << settings.tol <<
+                        " at " << w[(k*d2 + p)*d2 + q] << ", use more cells or a higher degree";
+                        throw std::runtime_error(oss.str());
+                    }
+                }
+            }
+        }
+        h.max_err = max_err;
+    } catch (...) {
+        delete impl;
+        throw;
+    }
+}
+
+InterpolationTable::InterpolationTable(const std::string & path) : impl(new Impl())
+{
+    std::string error;
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0) {
+        error = "can not open file";
+    } else if ((fstat(fd, &st) != 0) || (std::size_t(st.st_size) < sizeof(TableHeader))) {
+        error = "file too small";
+    } else {
+        impl->size = st.st_size;
+        void * base = mmap(NULL, impl->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            error = "mmap failed";
+        } else {
+            impl->base = base;
+            const TableHeader & h = *static_cast<const TableHeader *>(base);
+            const std::size_t d1 = h.degree + 1;
+            if ((std::memcmp(h.magic, TABLE_MAGIC, sizeof(h.magic)) != 0) || (h.version != TABLE_VERSION)) {
+                error = "not a table (or a different version)";
+            } else if (((h.function != TABLE_ZETA) && (h.function != TABLE_GAMMA_INC)) ||
+                       (h.nx == 0) || (h.ny == 0) || (h.degree == 0) || (h.degree > CPLXFNC_TABLE_MAX_DEGREE) ||
+                       !(h.lower[0] < h.upper[0]) || !(h.lower[1] < h.upper[1])) {
+                error = "invalid header";
+            } else if (impl->size != sizeof(TableHeader) +
+                                     std::size_t(h.nx)*h.ny*d1*d1*sizeof(std::complex<double>)) {
+                error = "size does not match the header";
+            } else {
+                impl->header = h;
+                impl->hx = (h.upper[0] - h.lower[0])/h.nx;
+                impl->hy = (h.upper[1] - h.lower[1])/h.ny;
+                impl->coef = reinterpret_cast<const std::complex<double> *>(
+                                 static_cast<const char *>(base) + sizeof(TableHeader));
+            }
+        }
+    }
+    if (fd >= 0) close(fd);
+    if (!error.empty()) {
+        delete impl;
+        throw std::runtime_error("InterpolationTable: " + path + ": " + error);
+    }
+}
+
+InterpolationTable::~InterpolationTable() { delete impl; }
+
+TableFunction InterpolationTable::function() const { return TableFunction(impl->header.function); }
+std::complex<double> InterpolationTable::s() const
+{
+    return std::complex<double>(impl->header.s[0], impl->header.s[1]);
+}
+std::complex<double> InterpolationTable::lower() const
+{
+    return std::complex<double>(impl->header.lower[0], impl->header.lower[1]);
+}
+std::complex<double> InterpolationTable::upper() const
+{
+    return std::complex<double>(impl->header.upper[0], impl->header.upper[1]);
+}
+unsigned int InterpolationTable::nx() const { return impl->header.nx; }
+unsigned int InterpolationTable::ny() const { return impl->header.ny; }
+unsigned int InterpolationTable::degree() const { return impl->header.degree; }
+double InterpolationTable::max_err() const { return impl->header.max_err; }
+bool InterpolationTable::mapped() const { return impl->base != NULL; }
+
+int InterpolationTable::operator()(std::complex<double> w, std::complex<double> * res) const noexcept
+{
+    const TableHeader & h = impl->header;
+    // the negated comparisons reject nan
+    if (!(w.real() >= h.lower[0]) || !(w.real() <= h.upper[0]) ||
+        !(w.imag() >= h.lower[1]) || !(w.imag() <= h.upper[1])) {
+        return -2;
+    }
+    double u = (w.real() - h.lower[0])/impl->hx;
+    double v = (w.imag() - h.lower[1])/impl->hy;
+    unsigned int i = (unsigned int)u;
+    unsigned int j = (unsigned int)v;
+    if (i >= h.nx) i = h.nx - 1;
+    if (j >= h.ny) j = h.ny - 1;
+    *res = impl->lookup(i, j, 2*(u - i) - 1, 2*(v - j) - 1);
+    return 0;
+}
+
+std::complex<double> InterpolationTable::operator()(std::complex<double> w) const
+{
+    std::complex<double> res;
+    if ((*this)(w, &res)) {
+        std::ostringstream oss;
+        oss << "VALUE ERROR: InterpolationTable, w=" << w << " is outside of the table " <<
+        lower() << " ... " << upper();
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+void InterpolationTable::save(const std::string & path) const
+{
+    const std::size_t d1 = impl->header.degree + 1;
+    const std::size_t n_coef = std::size_t(impl->header.nx)*impl->header.ny*d1*d1;
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&impl->header), sizeof(TableHeader));
+    out.write(reinterpret_cast<const char *>(impl->coef), n_coef*sizeof(std::complex<double>));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("InterpolationTable: can not write " + path);
+    }
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,219 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     trace sink
+// ##
+// ##     A bounded multi producer / single consumer ring buffer (D. Vyukov's
+// ##     bounded queue). Every cell carries a sequence number which tells the
+// ##     producers whether it is free and the consumer whether it is filled, a
+// ##     producer claims a cell with one compare-and-swap on the write position.
+// ##     A full buffer drops the event instead of waiting.
+// ##################################################
+
+namespace {
+
+struct Cell {
+    std::atomic<std::size_t> seq;
+    TraceEvent ev;
+};
+
+std::atomic<TraceSink *> default_sink(nullptr);
+
+}
+
+struct TraceSink::Impl {
+    explicit Impl(std::size_t capacity);
+    ~Impl();
+
+    bool push(const TraceEvent & ev);
+    bool pop(TraceEvent * ev);
+
+    Cell * cells;
+    std::size_t mask;
+    // producers and consumer on separate cache lines (no over-aligned new in c++11)
+    char pad0[64];
+    std::atomic<std::size_t> write_pos;
+    char pad1[64];
+    std::atomic<std::size_t> read_pos;
+    char pad2[64];
+    std::atomic<unsigned long> n_dropped;
+
+    // the background drainer
+    std::thread drainer;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping;
+};
+
+TraceSink::Impl::Impl(std::size_t capacity) : write_pos(0), read_pos(0), n_dropped(0), stopping(false)
+{
+    std::size_t n = 2;
+    while (n < capacity) n *= 2;
+    cells = new Cell[n];
+    mask = n - 1;
+    for (std::size_t i = 0; i < n; i++) cells[i].seq.store(i, std::memory_order_relaxed);
+}
+
+TraceSink::Impl::~Impl() { delete [] cells; }
+
+bool TraceSink::Impl::push(const TraceEvent & ev)
+{
+    std::size_t pos = write_pos.load(std::memory_order_relaxed);
+    Cell * cell;
+    while (1) {
+        cell = &cells[pos & mask];
+        std::size_t seq = cell->seq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+        if (diff == 0) {
+            if (write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            n_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = write_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->ev = ev;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool TraceSink::Impl::pop(TraceEvent * ev)
+{
+    std::size_t pos = read_pos.load(std::memory_order_relaxed);
+    Cell * cell = &cells[pos & mask];
+    std::size_t seq = cell->seq.load(std::memory_order_acquire);
+    if (std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1) < 0) return false;
+    *ev = cell->ev;
+    cell->seq.store(pos + mask + 1, std::memory_order_release);
+    read_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+TraceSink::TraceSink(std::size_t capacity) : impl(new Impl(capacity)) {}
+
+TraceSink::~TraceSink()
+{
+    stop();
+    TraceSink * self = this;
+    default_sink.compare_exchange_strong(self, nullptr);
+    delete impl;
+}
+
+bool TraceSink::push(const TraceEvent & ev) noexcept { return impl->push(ev); }
+bool TraceSink::pop(TraceEvent * ev) { return impl->pop(ev); }
+
+std::size_t TraceSink::drain(const std::function<void(const TraceEvent &)> & callback)
+{
+    TraceEvent ev;
+    std::size_t n = 0;
+    while (impl->pop(&ev)) {
+        callback(ev);
+        n++;
+    }
+    return n;
+}
+
+unsigned long TraceSink::dropped() const { return impl->n_dropped.load(std::memory_order_relaxed); }
+
+void TraceSink::start(const std::function<void(const TraceEvent &)> & callback, unsigned int interval_ms)
+{
+    stop();
+    impl->stopping = false;
+    impl->drainer = std::thread([this, callback, interval_ms]() {
+        std::unique_lock<std::mutex> lock(impl->mutex);
+        while (!impl->stopping) {
+            lock.unlock();
+            drain(callback);
+            lock.lock();
+            impl->cv.wait_for(lock, std::chrono::milliseconds(interval_ms));
+        }
+        lock.unlock();
+        drain(callback);
+    });
+}
+
+void TraceSink::stop()
+{
+    if (!impl->drainer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        impl->stopping = true;
+    }
+    impl->cv.notify_all();
+    impl->drainer.join();
+}
+
+void set_trace_sink(TraceSink * sink) { default_sink.store(sink, std::memory_order_release); }
+TraceSink * trace_sink() { return default_sink.load(std::memory_order_acquire); }
+
+std::string format_event(const TraceEvent & ev)
+{
+    // the argument names of the functions
+    const char * names[3] = {"s", "a", ""};
+    if (std::string(ev.function) == "gamma_inc") {
+        names[1] = "z";
+    } else if (std::string(ev.function) == "u_asymp") {
+        names[0] = "a"; names[1] = "b"; names[2] = "z";
+    }
+
+    std::ostringstream oss;
+    if (ev.kind == TRACE_LIMIT) {
+        oss << "ERROR: limit (" << ev.attempt << ") reached\n";
+    } else if (ev.kind == TRACE_VALUE_ERROR) {
+        oss << "ERROR: value error\n";
+    } else if (ev.kind == TRACE_STOPPED) {
+        oss << "ERROR: stopped after attempt " << ev.attempt << "\n";
+    }
+    oss << std::setprecision(1) << std::fixed << ev.function << " with ";
+    for (unsigned int i = 0; i < ev.n_args; i++) {
+        oss << (i ? " and " : "") << names[i] << "=" << ev.args[i];
+    }
+    oss << "\n" <<
+    "internal prec  : " << ev.prec << "\n" <<
+    "attempt        : " << ev.attempt << "\n" <<
+    "tol (bits)     : " << ev.err_bits_ref << "\n" <<
+    "rel_err (bits) : " << ev.err_bits << "\n";
+    return oss.str();
+}
+
+} /* namespace cplxfnc */
@@ -0,0 +1,279 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2017 Richard Hartmann
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cplxfnc.hpp"
+#include "cplxfnc_internal.hpp"
+
+#include "acb.h"
+#include "arb.h"
+#include "arf.h"
+
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace cplxfnc {
+
+// ##################################################
+// ##     typed results
+// ##
+// ##     The escalation loops of the double functions run with the tolerance and
+// ##     initial precision of ResultType<T>, the result is then converted from
+// ##     the midpoint of the ball left in the workspace (the double result of
+// ##     the loop is dropped). No cache and no fast path, both hold doubles.
+// ##################################################
+
+namespace {
+
+// hi = x rounded to double, lo = (x - hi) rounded to double
+void split(const arf_t x, double * hi, double * lo)
+{
+    arf_t t;
+    arf_init(t);
+    *hi = arf_get_d(x, ARF_RND_NEAR);
+    arf_set_d(t, *hi);
+    arf_sub(t, x, t, ARF_PREC_EXACT, ARF_RND_DOWN);
+    *lo = arf_get_d(t, ARF_RND_NEAR);
+    arf_clear(t);
+}
+
+template <class T> T convert(const acb_t x);
+
+template <> std::complex<float> convert(const acb_t x)
+{
+    // via double, the second rounding may cost half an ulp of float
+    return std::complex<float>(float(arf_get_d(arb_midref(acb_realref(x)), ARF_RND_NEAR)),
+                               float(arf_get_d(arb_midref(acb_imagref(x)), ARF_RND_NEAR)));
+}
+
+template <> std::complex<double> convert(const acb_t x)
+{
+    return std::complex<double>(arf_get_d(arb_midref(acb_realref(x)), ARF_RND_NEAR),
+                                arf_get_d(arb_midref(acb_imagref(x)), ARF_RND_NEAR));
+}
+
+template <> std::complex<long double> convert(const acb_t x)
+{
+    double re_hi, re_lo, im_hi, im_lo;
+    split(arb_midref(acb_realref(x)), &re_hi, &re_lo);
+    split(arb_midref(acb_imagref(x)), &im_hi, &im_lo);
+    return std::complex<long double>((long double) re_hi + re_lo, (long double) im_hi + im_lo);
+}
+
+template <> ComplexDD convert(const acb_t x)
+{
+    ComplexDD r;
+    split(arb_midref(acb_realref(x)), &r.real.hi, &r.real.lo);
+    split(arb_midref(acb_imagref(x)), &r.imag.hi, &r.imag.lo);
+    return r;
+}
+
+// the double-double result of a batch point, NaN if it failed
+void store_dd(int st, const acb_t x, std::complex<double> & hi, std::complex<double> & lo)
+{
+    if (st) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        hi = lo = std::complex<double>(nan, nan);
+        return;
+    }
+    ComplexDD r = convert<ComplexDD>(x);
+    hi = std::complex<double>(r.real.hi, r.imag.hi);
+    lo = std::complex<double>(r.real.lo, r.imag.lo);
+}
+
+} /* namespace */
+
+template <class T>
+int zeta(std::complex<double> s, std::complex<double> a, T * res)
+{
+    typedef ResultType<T> R;
+    detail::Config cfg(R::tol, 5, false, R::init_prec(ZETA_DEFAULT_INIT_PREC));
+    detail::ZetaWorkspace ws;
+    std::complex<double> d;
+    int status = detail::zeta(ws, s, a, &d, cfg);
+    if (status == 0) *res = convert<T>(ws.z);
+    return status;
+}
+
+template <class T>
+T zeta(std::complex<double> s, std::complex<double> a)
+{
+    T res;
+    if (zeta(s, a, &res)) {
+        std::ostringstream oss;
+        oss << "LIMIT ERROR: zeta s=" << s << " and a=" << a;
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+template <class T>
+int gamma_inc(std::complex<double> s, std::complex<double> z, T * res)
+{
+    typedef ResultType<T> R;
+    detail::Config cfg(R::tol, 5, false, R::init_prec(GAMMA_INC_DEFAULT_INIT_PREC));
+    detail::GammaIncWorkspace ws;
+    std::complex<double> d;
+    int status = detail::gamma_inc(ws, s, z, &d, cfg);
+    if (status == 0) *res = convert<T>(ws.res);
+    return status;
+}
+
+template <class T>
+T gamma_inc(std::complex<double> s, std::complex<double> z)
+{
+    T res;
+    int status = gamma_inc(s, z, &res);
+    if (status) {
+        std::ostringstream oss;
+        if (status == -1) {
+            oss << "LIMIT ERROR: gamma_inc s=" << s << " and z=" << z;
+        } else {
+            oss << "VALUE ERROR: gamma_inc, if Re(s) < 0 then z must not be zero!";
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+template <class T>
+int u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z, T * res)
+{
+    typedef ResultType<T> R;
+    detail::Config cfg(R::tol, 5, false, R::init_prec(U_ASYMP_DEFAULT_INIT_PREC));
+    detail::UAsympWorkspace ws;
+    std::complex<double> d;
+    int status = detail::u_asymp(ws, a, b, z, &d, cfg);
+    if (status == 0) *res = convert<T>(ws.res);
+    return status;
+}
+
+template <class T>
+T u_asymp(std::complex<double> a, std::complex<double> b, std::complex<double> z)
+{
+    T res;
+    int status = u_asymp(a, b, z, &res);
+    if (status) {
+        std::ostringstream oss;
+        if (status == -1) {
+            oss << "LIMIT ERROR: u_asymp(a, b, z) with a=" << a << " and b=" << b << " and z=" << z;
+        } else {
+            oss << "VALUE ERROR: u_asymp can not be evaluated for the given (z, tolerence). This is a property of u_asymp! Increase z or decrease tol!";
+        }
+        throw std::runtime_error(oss.str());
+    }
+    return res;
+}
+
+// the supported result types
+#define CPLXFNC_INSTANTIATE_TYPED(T) \
+    template T zeta<T>(std::complex<double>, std::complex<double>); \
+    template int zeta<T>(std::complex<double>, std::complex<double>, T *); \
+    template T gamma_inc<T>(std::complex<double>, std::complex<double>); \
+    template int gamma_inc<T>(std::complex<double>, std::complex<double>, T *); \
+    template T u_asymp<T>(std::complex<double>, std::complex<double>, std::complex<double>); \
+    template int u_asymp<T>(std::complex<double>, std::complex<double>, std::complex<double>, T *);
+
+CPLXFNC_INSTANTIATE_TYPED(std::complex<float>)
+CPLXFNC_INSTANTIATE_TYPED(std::complex<double>)
+CPLXFNC_INSTANTIATE_TYPED(std::complex<long double>)
+CPLXFNC_INSTANTIATE_TYPED(ComplexDD)
+
+#undef CPLXFNC_INSTANTIATE_TYPED
+
+// ##################################################
+// ##     double-double batch evaluation
+// ##################################################
+
+std::size_t zeta_dd_batch(std::size_t n,
+                          const std::complex<double> * s, std::ptrdiff_t s_stride,
+                          const std::complex<double> * a, std::ptrdiff_t a_stride,
+                          std::complex<double> * hi, std::ptrdiff_t hi_stride,
+                          std::complex<double> * lo, std::ptrdiff_t lo_stride,
+                          int * status, std::ptrdiff_t status_stride,
+                          double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                          PrecisionPredictor * predictor, EscalationPolicy * policy) noexcept
+{
+    const detail::Config cfg(tol, limit, verbose, init_prec, predictor, policy);
+    detail::ZetaWorkspace ws;
+    std::size_t n_fail = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        std::complex<double> d;
+        int st = detail::zeta(ws, detail::at(s, s_stride, i), detail::at(a, a_stride, i), &d, cfg);
+        store_dd(st, ws.z, detail::at(hi, hi_stride, i), detail::at(lo, lo_stride, i));
+        if (status != NULL) detail::at(status, status_stride, i) = st;
+        if (st) n_fail++;
+    }
+    return n_fail;
+}
+
+std::size_t gamma_inc_dd_batch(std::size_t n,
+                               const std::complex<double> * s, std::ptrdiff_t s_stride,
+                               const std::complex<double> * z, std::ptrdiff_t z_stride,
+                               std::complex<double> * hi, std::ptrdiff_t hi_stride,
+                               std::complex<double> * lo, std::ptrdiff_t lo_stride,
+                               int * status, std::ptrdiff_t status_stride,
+                               double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                               PrecisionPredictor * predictor, EscalationPolicy * policy) noexcept
+{
+    const detail::Config cfg(tol, limit, verbose, init_prec, predictor, policy);
+    detail::GammaIncWorkspace ws;
+    std::size_t n_fail = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        std::complex<double> d;
+        int st = detail::gamma_inc(ws, detail::at(s, s_stride, i), detail::at(z, z_stride, i), &d, cfg);
+        store_dd(st, ws.res, detail::at(hi, hi_stride, i), detail::at(lo, lo_stride, i));
+        if (status != NULL) detail::at(status, status_stride, i) = st;
+        if (st) n_fail++;
+    }
+    return n_fail;
+}
+
+std::size_t u_asymp_dd_batch(std::size_t n,
+                             const std::complex<double> * a, std::ptrdiff_t a_stride,
+                             const std::complex<double> * b, std::ptrdiff_t b_stride,
+                             const std::complex<double> * z, std::ptrdiff_t z_stride,
+                             std::complex<double> * hi, std::ptrdiff_t hi_stride,
+                             std::complex<double> * lo, std::ptrdiff_t lo_stride,
+                             int * status, std::ptrdiff_t status_stride,
+                             double tol, unsigned int limit, bool verbose, unsigned int init_prec,
+                             PrecisionPredictor * predictor, EscalationPolicy * policy) noexcept
+{
+    const detail::Config cfg(tol, limit, verbose, init_prec, predictor, policy);
+    detail::UAsympWorkspace ws;
+    std::size_t n_fail = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        std::complex<double> d;
+        int st = detail::u_asymp(ws, detail::at(a, a_stride, i), detail::at(b, b_stride, i),
+                                 detail::at(z, z_stride, i), &d, cfg);
+        store_dd(st, ws.res, detail::at(hi, hi_stride, i), detail::at(lo, lo_stride, i));
+        if (status != NULL) detail::at(status, status_stride, i) = st;
+        if (st) n_fail++;
+    }
+    return n_fail;
+}
+
+} /* namespace cplxfnc */
@@ -2,6 +2,7 @@ from setuptools import setup
 from setuptools.extension import Extension
 from ctypes.util import find_library
 from Cython.Build import cythonize
+import numpy
 
 import pathlib
 import subprocess
@@ -96,9 +97,31 @@ setup(
       license="MIT",
       description=description,
       long_description=description,
+      install_requires=['numpy'],
       ext_modules = cythonize(Extension("cplxfnc.cplxfnc_cyth",
-                                       ["./cplxfnc/cplxfnc_cyth.pyx", "./cplxfnc_clib/cplxfnc.cpp"],
+                                       ["./cplxfnc/cplxfnc_cyth.pyx",
+                                        "./cplxfnc_clib/cplxfnc.cpp",
+                                        "./cplxfnc_clib/cplxfnc_batch.cpp",
+                                        "./cplxfnc_clib/cplxfnc_parallel.cpp",
+                                        "./cplxfnc_clib/cplxfnc_predictor.cpp",
+                                        "./cplxfnc_clib/cplxfnc_policy.cpp",
+                                        "./cplxfnc_clib/cplxfnc_cache.cpp",
+                                        "./cplxfnc_clib/cplxfnc_hurwitz.cpp",
+                                        "./cplxfnc_clib/cplxfnc_fast.cpp",
+                                        "./cplxfnc_clib/cplxfnc_stats.cpp",
+                                        "./cplxfnc_clib/cplxfnc_trace.cpp",
+                                        "./cplxfnc_clib/cplxfnc_table.cpp",
+                                        "./cplxfnc_clib/cplxfnc_jet.cpp",
+                                        "./cplxfnc_clib/cplxfnc_sequence.cpp",
+                                        "./cplxfnc_clib/cplxfnc_typed.cpp",
+                                        "./cplxfnc_clib/cplxfnc_async.cpp",
+                                        "./cplxfnc_clib/cplxfnc_real.cpp",
+                                        "./cplxfnc_clib/cplxfnc_special.cpp",
+                                        "./cplxfnc_clib/cplxfnc_estimate.cpp",
+                                        "./cplxfnc_clib/cplxfnc_path.cpp"],
                                        libraries = libraries,
-                                       extra_compile_args=['-std=c++11'],
+                                       include_dirs = [numpy.get_include()],
+                                       extra_compile_args=['-std=c++11', '-pthread'],
+                                       extra_link_args=['-pthread'],
                                        language="c++"))
 )
\ No newline at end of file
@@ -173,7 +173,227 @@ def test_uasymp():
         assert False, "expected RuntimeError"
 
 
+def test_ufunc(n=20, tol=1e-16):
+    np.random.seed(1)
+    s = np.asarray([cplx_rand(-5, 5, -5, 5) for i in range(n)])
+    a = np.asarray([cplx_rand(-5, 5, -5, 5) for i in range(n)]).reshape(-1, 1)
+
+    z, status = cf.zeta_ufunc(s, a, tol, 5)
+    assert z.shape == (n, n) and status.shape == (n, n)
+    assert np.all(status == 0)
+    for i in (0, n // 2, n - 1):
+        assert z[i, i] == cf.zeta(s[i], a[i, 0], tol=tol)
+
+    g = np.empty(n, dtype=np.complex128)
+    status = np.empty(n, dtype=np.intc)
+    cf.gamma_inc_ufunc(s, a[:, 0], tol, 5, out=(g, status))
+    assert np.all(status == 0)
+    for i in range(n):
+        assert g[i] == cf.gamma_inc(s[i], a[i, 0], tol)
+
+    u, status = cf.u_asymp_ufunc(2, 2, np.asarray([100, -100, 30]), tol, 5)
+    assert status[0] == 0 and status[1] == 0 and status[2] == -2
+    assert u[0] == cf.u_asymp(2, 2, 100) and u[1] == cf.u_asymp(2, 2, -100)
+    assert np.isnan(u[2])
+
+    with stdouterr_redirected():
+        g, status = cf.gamma_inc_ufunc(-0.1, [0, 1], tol, 5)
+    assert list(status) == [-2, 0]
+    g = cf.masked(g, status)
+    assert g.mask[0] and not g.mask[1]
+
+    try:
+        cf.zeta_ufunc(s, "a", tol, 5)
+    except TypeError:
+        pass
+    else:
+        assert False, "expected TypeError"
+
+
+def test_stats(tol=1e-16):
+    cf.reset_stats()
+    cf.zeta(2, 1, tol)
+    cf.zeta(1.2 + 1j, 1 + 1234j, tol)
+    with stdouterr_redirected():
+        cf.gamma_inc_ufunc(-0.1, [0, 1, 2], tol, 5)
+
+    st = cf.stats('zeta')
+    assert st['calls'] == 2
+    assert st['arb_evals'] == st['calls'] + st['escalations']
+    assert sum(st['prec_hist']) == 2 and st['arb_ns'] > 0
+
+    st = cf.stats('gamma_inc')
+    assert st['calls'] == 3 and st['value_errors'] == 1
+    assert sum(st['prec_hist']) == 2
+    assert st['special'] == [0, 0, 0]
+    assert cf.stats('zeta')['special'] == [1, 0, 0]
+
+    cf.reset_stats()
+    assert cf.stats('zeta')['calls'] == 0
+    try:
+        cf.stats('gamma')
+    except KeyError:
+        pass
+    else:
+        assert False, "expected KeyError"
+
+
+def test_trace(tol=1e-16):
+    cf.enable_trace()
+    try:
+        cf.zeta(1.2 + 1j, 1 + 1234j, tol, 1)
+    except RuntimeError:
+        pass
+    cf.gamma_inc_ufunc(-0.1, [0, 1], tol, 5)
+    events, dropped = cf.trace_events()
+    assert len(events) == 2 and dropped == 0
+    assert events[0].startswith("ERROR: limit (1) reached")
+    assert events[1].startswith("ERROR: value error")
+
+    cf.zeta(2, 1, tol, 5, True)
+    events, dropped = cf.trace_events()
+    assert len(events) >= 1 and events[0].startswith("zeta with s=")
+
+    cf.disable_trace()
+    cf.zeta(2, 1, tol, 5, True)
+    assert cf.trace_events() == ([], 0)
+
+    # the sink outlives disable_trace, enabling again starts with an empty buffer
+    cf.enable_trace(8)
+    cf.zeta(2, 1, tol, 5, True)
+    cf.disable_trace()
+    cf.enable_trace()
+    assert cf.trace_events() == ([], 0)
+    cf.disable_trace()
+
+
+def test_jet(tol=1e-14):
+    mp.mp.dps = 64
+    s, a, z = 1.2 + 1j, 2.5 + 3j, 1.5 - 0.5j
+    checks = [(cf.zeta_jet_s(s, a, 2, tol), lambda k: mp.zeta(s, a, k)),
+              (cf.zeta_jet_a(s, a, 2, tol), lambda k: mp.diff(lambda x: mp.zeta(s, x), a, k)),
+              (cf.gamma_inc_jet_s(s, z, 2, tol), lambda k: mp.diff(lambda x: mp.gammainc(x, z), s, k)),
+              (cf.gamma_inc_jet_z(s, z, 2, tol), lambda k: mp.diff(lambda x: mp.gammainc(s, x), z, k))]
+    for res, ref in checks:
+        assert len(res) == 3
+        for k in range(3):
+            r = complex(ref(k))
+            assert abs(res[k] - r) < 10 * tol * abs(r)
+
+    # Gamma'(x0) = 0 at the minimum of Gamma, tol is relative to the largest Taylor coefficient
+    x0 = 1.4616321449683623
+    res = cf.gamma_inc_jet_s(x0, 0, 2, tol, 2)
+    for k in range(3):
+        r = complex(mp.diff(mp.gamma, x0, k))
+        assert abs(res[k] - r) < 10 * tol * abs(complex(mp.gamma(x0)))
+
+
+def test_gamma_inc_sequence(tol=1e-14):
+    mp.mp.dps = 64
+    for s, z in [(0.5, 2.0), (-10.5, 1.0), (2 + 3j, 20 - 5j)]:
+        res = cf.gamma_inc_sequence(s, z, 30, tol)
+        assert res.shape == (30,)
+        for k in range(30):
+            g = complex(mp.gammainc(s + k, z))
+            assert abs(res[k] - g) < 10 * tol * abs(g)
+
+
+def test_zeta_sequence(tol=1e-14):
+    mp.mp.dps = 64
+    for s, a in [(1.2, 1.0), (10.0, 1.0), (1.2 + 10j, 0.5 + 2j)]:
+        res = cf.zeta_sequence(s, a, 30, tol)
+        assert res.shape == (30,)
+        for k in range(30):
+            z = complex(mp.zeta(s, a + k))
+            assert abs(res[k] - z) < 10 * tol * abs(z)
+
+
+def test_path(tol=1e-14):
+    mp.mp.dps = 64
+    s = 2.5 + 1j
+    z = np.linspace(2, 4 + 1.5j, 100)
+    res = cf.gamma_inc_path(s, z, tol)
+    assert res.shape == (100,)
+    for k in range(100):
+        g = complex(mp.gammainc(s, z[k]))
+        assert abs(res[k] - g) < 10 * tol * abs(g)
+
+    z = 20 + np.linspace(0, 5j, 100)
+    res = cf.u_asymp_path(0.3 + 0.2j, 1.5, z, tol)
+    for k in range(100):
+        u = cf.u_asymp(0.3 + 0.2j, 1.5, z[k])
+        assert abs(res[k] - u) < 10 * tol * abs(u)
+
+
+def _dd_err(hi, lo, ref):
+    # relative error of hi + lo, evaluated with mpmath
+    return abs(mp.mpc(hi) + mp.mpc(lo) - ref) / abs(ref)
+
+
+def test_dd():
+    mp.mp.dps = 64
+    s = np.array([0.5, 2 + 3j, -10.5])
+    z = np.array([2.0, 20 - 5j, 1.0])
+    hi, lo, status = cf.gamma_inc_dd_ufunc(s, z, 1e-32, 5)
+    assert np.all(status == 0)
+    for i in range(len(s)):
+        g = mp.gammainc(s[i], z[i])
+        assert _dd_err(hi[i], lo[i], g) < 1e-31
+        assert abs(lo[i]) <= 1.2e-16 * abs(hi[i])
+
+    a = np.linspace(1, 3, 5)
+    hi, lo, status = cf.zeta_dd_ufunc(1.2 + 10j, a, 1e-32, 5)
+    assert np.all(status == 0)
+    for i in range(len(a)):
+        assert _dd_err(hi[i], lo[i], mp.zeta(1.2 + 10j, a[i])) < 1e-31
+
+    hi, lo = cf.zeta_dd(2, 1)
+    assert _dd_err(hi, lo, mp.pi**2 / 6) < 1e-31
+
+    # u_asymp(s+1, s+1, z) = Gamma(-s, z) exp(z) z^(s+1), see test_uasymp
+    hi, lo = cf.u_asymp_dd(2, 2, 100, tol=1e-24)
+    u = mp.gammainc(-1, 100) * mp.exp(100) * mp.mpf(100)**2
+    assert _dd_err(hi, lo, u) < 1e-23
+
+    hi, lo, status = cf.gamma_inc_dd_ufunc(-0.5, 0.0, 1e-32, 5)
+    assert status == -2 and np.isnan(hi) and np.isnan(lo)
+
+
+def test_atol():
+    # near the first zero of the Riemann zeta function only atol can be met
+    rho = 0.5 + 14.134725141734693j
+    assert abs(cf.zeta(rho, 1, atol=1e-12)) < 1e-12
+
+    z, status = cf.zeta_atol_ufunc([rho, 2], 1, 1e-16, 1e-12, 5)
+    assert list(status) == [1, 0]
+    assert abs(z[0]) < 1e-12
+    assert abs(z[1] - mp.pi**2 / 6) < 1e-15
+    assert not np.any(cf.masked(z, status).mask)
+
+    g, status = cf.gamma_inc_atol_ufunc(-0.1, [0, 1], 1e-16, 1e-12, 5)
+    assert status[0] == -2 and status[1] == 0
+
+
+def test_estimate():
+    e = cf.zeta_estimate(2, 1)
+    assert e['status'] == 0 and e['attempts'] == 1 and e['cost'] == 1
+    assert cf.gamma_inc_estimate(-0.5, 0)['status'] == -2
+    assert cf.u_asymp_estimate(1, 2, 0.1)['status'] == -2
+    assert cf.gamma_inc_estimate(2.5, 3, tol=1e-40)['prec'] > cf.gamma_inc_estimate(2.5, 3)['prec']
+    assert cf.gamma_inc_estimate(2.5, 3, tol=1e-300, limit=3)['status'] == -1
+
+
 if __name__ == "__main__":
     test_zeta(10)
     test_gamma_inc(10)
-    test_uasymp()
\ No newline at end of file
+    test_uasymp()
+    test_ufunc()
+    test_stats()
+    test_trace()
+    test_jet()
+    test_gamma_inc_sequence()
+    test_zeta_sequence()
+    test_path()
+    test_dd()
+    test_atol()
+    test_estimate()